@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stdint.h>
+
+enum class ServoChannel : uint8_t {
+    LEFT_EAR_LIFT = 0,
+    LEFT_EAR_SWING = 1,
+    RIGHT_EAR_LIFT = 2,
+    RIGHT_EAR_SWING = 3,
+    HEAD_TILT = 4,
+    HEAD_PAN = 5,
+    RIGHT_ARM_SWING = 6,
+    LEFT_ARM_LIFT = 7,
+    LEFT_ARM_SWING = 8,
+    RIGHT_ARM_LIFT = 9,
+    LEFT_LEG_ROTATE = 10,
+    LEFT_ANKLE_LIFT = 11,
+    RIGHT_LEG_ROTATE = 12,
+    RIGHT_ANKLE_LIFT = 13,
+
+    SERVO_COUNT // This automatically gives the number of servos
+};
@@ -2,6 +2,7 @@
 #include "driver/uart.h"
 #include "esp_log.h"
 #include "soc/gpio_num.h"
+#include <algorithm>
 #include <vector>
 #include <cstring> // For memcpy
 
@@ -10,6 +11,8 @@
 #define UART_RX_PIN        GPIO_NUM_48
 #define UART_BAUD_RATE     115200
 #define UART_BUFFER_SIZE   256
+#define UART_EVENT_QUEUE_LEN 16
+#define UART_RX_TIMEOUT_SYMBOLS 3 // Idle character times that end a received burst
 #define FRAME_HEADER       0x55AA
 #define FRAME_TAIL         0xBB
 #define SENDER_ID          0x01
@@ -17,6 +20,10 @@
 
 static const char* TAG = "UartHandler";
 
+// How long the line was idle when the driver reports a burst on RX timeout
+// (a character is 10 bits on the wire).
+static constexpr int64_t UART_RX_TIMEOUT_US = UART_RX_TIMEOUT_SYMBOLS * 10 * 1000000LL / UART_BAUD_RATE;
+
 UartHandler::UartHandler(MotionController* controller, AnimationPlayer* anim_player, FaceLocationCallback callback)
     : m_motion_controller(controller), m_anim_player(anim_player), m_face_location_callback(callback) {
     m_last_activity_time.store(esp_timer_get_time());
@@ -38,7 +45,8 @@ void UartHandler::init() {
     };
     uart_param_config(UART_NUM, &uart_config);
     uart_set_pin(UART_NUM, UART_TX_PIN, UART_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
-    uart_driver_install(UART_NUM, UART_BUFFER_SIZE, UART_BUFFER_SIZE, 0, NULL, 0);
+    uart_driver_install(UART_NUM, UART_BUFFER_SIZE, UART_BUFFER_SIZE, UART_EVENT_QUEUE_LEN, &m_uart_queue, 0);
+    uart_set_rx_timeout(UART_NUM, UART_RX_TIMEOUT_SYMBOLS);
 
     esp_timer_create_args_t timer_args = {
         .callback = &wake_word_timer_callback,
@@ -86,9 +94,30 @@ void UartHandler::receive_task_handler() {
     bool frame_started = false;
 
     while (1) {
-        int len = uart_read_bytes(UART_NUM, data, UART_BUFFER_SIZE, pdMS_TO_TICKS(50));
+        uart_event_t event;
+        if (xQueueReceive(m_uart_queue, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        if (event.type == UART_FIFO_OVF || event.type == UART_BUFFER_FULL) {
+            ESP_LOGW(TAG, "UART RX overflow, input flushed.");
+            uart_flush_input(UART_NUM);
+            xQueueReset(m_uart_queue);
+            frame_buffer.clear();
+            frame_started = false;
+            continue;
+        }
+        if (event.type != UART_DATA) {
+            continue;
+        }
+        // Stamped as soon as the driver reports the data. A burst reported
+        // on RX timeout finished arriving one timeout earlier.
+        int64_t received_us = esp_timer_get_time();
+        if (event.timeout_flag) {
+            received_us -= UART_RX_TIMEOUT_US;
+        }
+        int len = uart_read_bytes(UART_NUM, data, std::min(event.size, sizeof(data)), 0);
         if (len > 0) {
-            m_last_activity_time.store(esp_timer_get_time());
+            m_last_activity_time.store(received_us);
         } else {
             continue;
         }
@@ -125,6 +154,7 @@ void UartHandler::receive_task_handler() {
                                     fl.w = data_ptr[4] | (data_ptr[5] << 8);
                                     fl.h = data_ptr[6] | (data_ptr[7] << 8);
                                     fl.detected = (data_ptr[8] != 0);
+                                    fl.timestamp_us = received_us;
 
                                     if (m_face_location_callback) {
                                         m_face_location_callback(fl);
@@ -136,6 +166,9 @@ void UartHandler::receive_task_handler() {
                                 ESP_LOGI(TAG, "turn to sound soucre task detected.");
                                 m_isWakeWordDetected = true;
                                 start_wake_word_timer();
+                                if (m_motion_controller && m_motion_controller->get_decision_maker()) {
+                                    m_motion_controller->get_decision_maker()->post_wake_word();
+                                }
                             } else if (motion_type == MOTION_PLAY_ANIMATION) {
                                 if (m_anim_player) {
                                     const char* anim_name = (const char*)(frame_buffer.data() + 6);
@@ -147,23 +180,23 @@ void UartHandler::receive_task_handler() {
                             } else if (motion_type == MOTION_FACE_END) {
                                 ESP_LOGI(TAG, "Face end detected, stopping all motions.");
                                 if (m_motion_controller) {
-                                    m_motion_controller->queue_command({MOTION_STOP, {}});
+                                    motion_command_t stop = {};
+                                    stop.motion_type = MOTION_STOP;
+                                    m_motion_controller->queue_command(stop);
                                 }
                             } else {
                                 // Build a generic motion_command_t and queue it.
-                                motion_command_t cmd;
+                                motion_command_t cmd = {};
                                 cmd.motion_type = motion_type;
-                                cmd.params.clear();
-                                if (payload_len > 1) {
-                                    // payload starts at frame_buffer[6], length = payload_len - 1 for params
-                                    cmd.params.assign(frame_buffer.begin() + 6, frame_buffer.begin() + 6 + (payload_len - 1));
-                                }
-                                // Queue the command for the motion controller
-                                if (m_motion_controller) {
+                                // payload starts at frame_buffer[6], length = payload_len - 1 for params
+                                if (payload_len > 1 && !motion_command_set_params(cmd, frame_buffer.data() + 6, payload_len - 1)) {
+                                    ESP_LOGW(TAG, "Params of command %d too long (%d bytes), dropped.", motion_type, payload_len - 1);
+                                } else if (m_motion_controller) {
+                                    // Queue the command for the motion controller
                                     if (!m_motion_controller->queue_command(cmd)) {
                                         ESP_LOGW(TAG, "Failed to queue motion command %d.", cmd.motion_type);
                                     } else {
-                                        ESP_LOGD(TAG, "Command %d with %d bytes of params queued.", cmd.motion_type, (int)cmd.params.size());
+                                        ESP_LOGD(TAG, "Command %d with %d bytes of params queued.", cmd.motion_type, (int)cmd.param_len);
                                     }
                                 }
                             }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include "config.h"
 #include "motion_manager/Motion_types.hpp"
 #include "motion_manager/MotionController.hpp"
 #include "display/AnimationPlayer.h" // Changed to AnimationPlayer
@@ -27,6 +28,7 @@ private:
     AnimationPlayer* m_anim_player; // Changed to AnimationPlayer
     FaceLocationCallback m_face_location_callback;
     std::atomic<int64_t> m_last_activity_time;
+    QueueHandle_t m_uart_queue = nullptr; // UART driver events
 
 
     void receive_task_handler();
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Minimal register-write interface used by the servo drivers.
+// The firmware backs it with i2cdev (PCA9685DevBus); host builds can swap
+// in MockI2CBus.
+class I2CBus {
+public:
+    virtual ~I2CBus() = default;
+
+    // Brings the bus, and the device behind it, up. Called once by the
+    // driver's init(); a mock needs nothing.
+    virtual bool init() { return true; }
+
+    // Write `len` bytes starting at register `reg` in a single transaction
+    // (START, address, reg, data..., STOP). Returns false on a bus error.
+    virtual bool write_reg(uint8_t reg, const uint8_t* data, size_t len) = 0;
+};
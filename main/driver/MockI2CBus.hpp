@@ -0,0 +1,52 @@
+#pragma once
+
+#include "I2CBus.hpp"
+#include <stdint.h>
+#include <vector>
+
+// Recording I2C backend for host-side measurement of servo bus traffic.
+// Every transaction is logged and costed against a standard-mode timing
+// model so per-frame wire bytes and bus time can be regression-tested.
+class MockI2CBus : public I2CBus {
+public:
+    struct Transaction {
+        uint8_t reg;
+        std::vector<uint8_t> data;
+    };
+
+    explicit MockI2CBus(uint32_t clk_speed_hz = 40000) : m_clk_speed_hz(clk_speed_hz) {}
+
+    bool write_reg(uint8_t reg, const uint8_t* data, size_t len) override {
+        if (m_fail_next) {
+            m_fail_next = false;
+            return false;
+        }
+        m_transactions.push_back({reg, std::vector<uint8_t>(data, data + len)});
+        // Address byte + register byte + payload, each 8 bits plus ACK.
+        uint64_t bytes = 2 + len;
+        m_wire_bytes += bytes;
+        // START and STOP conditions cost roughly one clock each.
+        m_bus_time_us += ((bytes * 9 + 2) * 1000000ULL) / m_clk_speed_hz;
+        return true;
+    }
+
+    void fail_next_write() { m_fail_next = true; }
+
+    void reset() {
+        m_transactions.clear();
+        m_wire_bytes = 0;
+        m_bus_time_us = 0;
+    }
+
+    const std::vector<Transaction>& transactions() const { return m_transactions; }
+    size_t transaction_count() const { return m_transactions.size(); }
+    uint64_t wire_bytes() const { return m_wire_bytes; }
+    uint64_t bus_time_us() const { return m_bus_time_us; }
+
+private:
+    uint32_t m_clk_speed_hz;
+    bool m_fail_next = false;
+    std::vector<Transaction> m_transactions;
+    uint64_t m_wire_bytes = 0;
+    uint64_t m_bus_time_us = 0;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "servo.hpp"
+#include <array>
+#include <cmath>
+#include <stdint.h>
+
+// Recording servo driver for running the motion stack off the robot. It keeps
+// the last commanded angle of every channel, so a host harness can sample the
+// pose after each mixer tick, and counts writes the way a bus driver would.
+class MockServo : public Servo {
+public:
+    static constexpr size_t CHANNEL_COUNT = 16;
+
+    MockServo() { m_angles.fill(NAN); }
+
+    void init() override {}
+
+    void set_angle(uint8_t channel, float angle) override {
+        if (channel >= CHANNEL_COUNT) return;
+        ++m_stats.transactions;
+        record(channel, angle);
+    }
+
+    void home_all() override {}
+
+    // One frame: every channel is updated in a single "transaction".
+    void set_angles(std::span<const float> angles) override {
+        ++m_stats.transactions;
+        ++m_frames;
+        for (size_t i = 0; i < angles.size() && i < CHANNEL_COUNT; ++i) {
+            if (!std::isnan(angles[i])) {
+                record(static_cast<uint8_t>(i), angles[i]);
+            }
+        }
+    }
+
+    ServoWriteStats get_write_stats() const override { return m_stats; }
+
+    // NaN for a channel that was never commanded.
+    float angle(uint8_t channel) const { return channel < CHANNEL_COUNT ? m_angles[channel] : NAN; }
+    const std::array<float, CHANNEL_COUNT>& angles() const { return m_angles; }
+    uint64_t frame_count() const { return m_frames; }
+
+private:
+    void record(uint8_t channel, float angle) {
+        if (m_angles[channel] == angle) {
+            ++m_stats.channels_suppressed;
+        } else {
+            m_angles[channel] = angle;
+            ++m_stats.channels_written;
+        }
+    }
+
+    std::array<float, CHANNEL_COUNT> m_angles;
+    ServoWriteStats m_stats = {};
+    uint64_t m_frames = 0;
+};
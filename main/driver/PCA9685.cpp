@@ -1,104 +1,109 @@
 #include "PCA9685.hpp"
 #include "motion_manager/ServoCalibration.hpp"
+#include "motion_manager/MotionPlatform.hpp"
 #include <esp_log.h>
 #include <cstring>
-#include <i2cdev.h>
+#include <algorithm>
 
 static const char *TAG = "PCA9685";
 
-PCA9685::PCA9685() {
-    memset(&dev, 0, sizeof(dev));
-    dev.cfg.scl_pullup_en = 1;
-    dev.cfg.sda_pullup_en = 1;
-    // dev.cfg.master.clk_speed = 40000; // 一个小坑，在这里修改无效，见pca9685_init_desc中的修改。
+PCA9685::PCA9685(I2CBus& bus) : m_bus(bus) {
+    rebuild_pulse_maps();
 }
 
 void PCA9685::init() {
-    // Initialize the I2C device descriptor
-    ESP_LOGI(TAG, "Initializing PCA9685 descriptor");
-    pca9685_init_desc(&dev, PCA9685_I2C_ADDR, (i2c_port_t)I2C_PORT, (gpio_num_t)SDA_PIN, (gpio_num_t)SCL_PIN);
-    dev.cfg.master.clk_speed = 40000;
-    // Initialize the PCA9685 device
-    ESP_LOGI(TAG, "Initializing PCA9685");
-    esp_err_t err = pca9685_init(&dev);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to initialize PCA9685: %s", esp_err_to_name(err));
+    if (!m_bus.init()) {
+        ESP_LOGE(TAG, "PCA9685 bus failed to initialize");
         return;
     }
+    ESP_LOGI(TAG, "PCA9685 initialized successfully");
+}
 
-    // Restart the PCA9685
-    ESP_LOGI(TAG, "Restarting PCA9685");
-    err = pca9685_restart(&dev);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to restart PCA9685: %s", esp_err_to_name(err));
-        return;
+// TODO: 为了代码的兼容性，这里其实180对应了物理上的120度，后续修改
+void PCA9685::rebuild_pulse_maps() {
+    for (size_t channel = 0; channel < ServoCalibration::limits.size(); ++channel) {
+        const auto& limit = ServoCalibration::limits[channel];
+        const auto& pulse = ServoCalibration::pulse_limits[channel];
+        // 将角度(min_angle-max_angle)线性映射到脉冲宽度计数值
+        m_pulse_maps[channel] = PulseMap::compile(limit.min, limit.max, pulse.min_us, pulse.max_us,
+                                                  ServoCalibration::mirror_origin[channel], PWM_FREQ_HZ);
+        ESP_LOGD(TAG, "Channel: %d, Min: %.1f, Max: %.1f, Count: %d-%d", (int)channel, limit.min, limit.max,
+                 m_pulse_maps[channel].min_count, m_pulse_maps[channel].max_count);
     }
+}
 
-    // Set the PWM frequency
-    ESP_LOGI(TAG, "Setting PWM frequency");
-    err = pca9685_set_pwm_frequency(&dev, PWM_FREQ_HZ);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set PWM frequency: %s", esp_err_to_name(err));
-        return;
+bool PCA9685::write_range(uint8_t first, uint8_t count, const uint16_t* counts) {
+    uint8_t frame[PCA9685Registers::CHANNEL_COUNT * PCA9685Registers::BYTES_PER_CHANNEL];
+    size_t len = PCA9685Registers::encode_burst(counts, count, frame);
+    m_stats.transactions++;
+    if (!m_bus.write_reg(PCA9685Registers::led_on_l(first), frame, len)) {
+        return false;
     }
-    ESP_LOGI(TAG, "PCA9685 initialized successfully");
+    memcpy(&m_counts[first], counts, count * sizeof(uint16_t));
+    m_committed_mask |= static_cast<uint16_t>(((1u << count) - 1) << first);
+    m_stats.channels_written += count;
+    return true;
 }
 
-// TODO: 为了代码的兼容性，这里其实180对应了物理上的120度，后续修改
 void PCA9685::set_angle(uint8_t channel, float angle) {
-    if (channel > 15) {
-        ESP_LOGE(TAG, "Invalid channel: %d. Must be 0-15.", channel);
+    if (channel >= ServoCalibration::limits.size()) {
+        ESP_LOGE(TAG, "Invalid channel: %d. Must be 0-%d.", channel, (int)ServoCalibration::limits.size() - 1);
         return;
     }
 
-    if (channel == 6) {
-        angle = 180 - angle;
-    } else if (channel == 7) {
-        angle = 130 - angle;
+    uint16_t pulse = angle_to_count(channel, angle);
+    if ((m_committed_mask & (1u << channel)) && m_counts[channel] == pulse) {
+        m_stats.channels_suppressed++;
+        return;
     }
 
-    // Get the min and max angles for this specific channel
-    float min_angle = ServoCalibration::limits[channel].min;
-    float max_angle = ServoCalibration::limits[channel].max;
-
-    // Get the min and max pulse widths for this specific channel
-    uint16_t min_pulse_us = ServoCalibration::pulse_limits[channel].min_us;
-    uint16_t max_pulse_us = ServoCalibration::pulse_limits[channel].max_us;
-
-    // 将角度(min_angle-max_angle)线性映射到脉冲宽度计数值
-    uint16_t pulse = map_angle_to_pwm(angle, min_angle, max_angle, min_pulse_us, max_pulse_us);
+    // 在PCA9685上设置PWM值
+    if (!write_range(channel, 1, &pulse)) {
+        ESP_LOGE(TAG, "Failed to set PWM value for channel %d", channel);
+    }
+}
 
-    ESP_LOGD(TAG, "Channel: %d, Angle: %.1f, Min: %.1f, Max: %.1f, Pulse: %d", channel, angle, min_angle, max_angle, pulse);
+// Only channels whose count changed are sent. Adjacent dirty channels are
+// coalesced into one auto-increment burst from their LEDn_ON_L; a clean gap
+// splits the burst, since even a one-channel gap costs more wire bytes than
+// the address/register overhead of a second transaction.
+void PCA9685::set_angles(std::span<const float> angles) {
+    size_t count = std::min(angles.size(), ServoCalibration::limits.size());
+
+    uint16_t counts[PCA9685Registers::CHANNEL_COUNT];
+    bool dirty[PCA9685Registers::CHANNEL_COUNT];
+    for (size_t i = 0; i < count; ++i) {
+        if (std::isnan(angles[i])) {
+            dirty[i] = false;
+            continue;
+        }
+        counts[i] = angle_to_count(static_cast<uint8_t>(i), angles[i]);
+        dirty[i] = !(m_committed_mask & (1u << i)) || m_counts[i] != counts[i];
+        if (!dirty[i]) {
+            m_stats.channels_suppressed++;
+        }
+    }
 
-    // 在PCA9685上设置PWM值
-    esp_err_t err = pca9685_set_pwm_value(&dev, channel, pulse);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to set PWM value for channel %d: %s", channel, esp_err_to_name(err));
+    size_t i = 0;
+    while (i < count) {
+        if (!dirty[i]) {
+            ++i;
+            continue;
+        }
+        size_t first = i;
+        while (i < count && dirty[i]) {
+            ++i;
+        }
+        if (!write_range(static_cast<uint8_t>(first), static_cast<uint8_t>(i - first), &counts[first])) {
+            ESP_LOGE(TAG, "Failed to burst-write channels %d-%d", (int)first, (int)i - 1);
+        }
     }
 }
 
 void PCA9685::home_all() {
     ESP_LOGI(TAG, "Homing all servos to 90 degrees.");
-    for (uint8_t i = 0; i < 16; ++i) {
+    for (uint8_t i = 0; i < ServoCalibration::limits.size(); ++i) {
         set_angle(i, 90);
-        vTaskDelay(pdMS_TO_TICKS(200));
+        MotionPlatform::delay_ms(200);
     }
 }
-
-uint16_t PCA9685::map_angle_to_pwm(float angle, float min_angle, float max_angle, uint16_t min_pulse_us, uint16_t max_pulse_us) {
-    // PCA9685 resolution is 12-bit (4096 steps).
-    const float us_per_step = 1000000.0f / (PWM_FREQ_HZ * 4096.0f);
-
-    float range_angle = max_angle - min_angle;
-    if (range_angle == 0) {
-        range_angle = 180.0f; // Prevent division by zero
-    }
-
-    // Calculate the percentage of the angle within its allowed range
-    float percentage = (angle - min_angle) / range_angle;
-
-    // Apply this percentage to the pulse width range
-    uint32_t pulse_us = min_pulse_us + (uint32_t)((max_pulse_us - min_pulse_us) * percentage);
-
-    return (uint16_t)(pulse_us / us_per_step);
-}
@@ -2,29 +2,48 @@
 #define PCA9685_HPP
 
 #include "servo.hpp"
-extern "C" {
-#include <pca9685.h>
-}
-
-// Default I2C configuration, you may need to change these based on your hardware.
-#define PCA9685_I2C_ADDR PCA9685_ADDR_BASE 
-#define I2C_PORT 0
-#define SDA_PIN 23
-#define SCL_PIN 22
+#include "I2CBus.hpp"
+#include "PCA9685Registers.hpp"
+#include "PulseMap.hpp"
+
 #define PWM_FREQ_HZ             60      // 舵机PWM频率
+#define PCA9685_I2C_CLK_HZ      100000  // I2C时钟（标准模式）；一帧14路舵机约5.2 ms，100 Hz混合器可用
 
 class PCA9685 : public Servo {
 public:
-    PCA9685();
+    // All PWM writes go to bus: a PCA9685DevBus on the robot, a MockI2CBus
+    // on a host. init() brings the bus up.
+    explicit PCA9685(I2CBus& bus);
     ~PCA9685() override = default;
 
     void init() override;
     virtual void set_angle(uint8_t channel, float angle);
+    void set_angles(std::span<const float> angles) override;
     virtual void home_all();
+    ServoWriteStats get_write_stats() const override { return m_stats; }
+    uint32_t frame_time_us(size_t channels) const override {
+        return PCA9685Registers::burst_time_us(channels, PCA9685_I2C_CLK_HZ);
+    }
+
+    // Recompile the per-channel angle -> count maps from ServoCalibration.
+    // Call after changing calibration data; done once at construction.
+    void rebuild_pulse_maps();
 
 private:
-    i2c_dev_t dev;
-    uint16_t map_angle_to_pwm(float angle, float min_angle, float max_angle, uint16_t min_pulse_us, uint16_t max_pulse_us);
+    I2CBus& m_bus;
+    // Shadow of the last PWM off-count committed per channel. Only channels whose
+    // count differs from the shadow are sent; m_committed_mask marks valid entries.
+    uint16_t m_counts[PCA9685Registers::CHANNEL_COUNT] = {};
+    uint16_t m_committed_mask = 0;
+    ServoWriteStats m_stats = {};
+
+    bool write_range(uint8_t first, uint8_t count, const uint16_t* counts);
+
+    PulseMap m_pulse_maps[PCA9685Registers::CHANNEL_COUNT] = {};
+
+    uint16_t angle_to_count(uint8_t channel, float angle) const {
+        return m_pulse_maps[channel].apply(angle);
+    }
 };
 
 #endif // PCA9685_HPP
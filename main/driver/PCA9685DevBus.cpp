@@ -0,0 +1,59 @@
+#include "PCA9685DevBus.hpp"
+#include "PCA9685.hpp"
+#include <esp_log.h>
+#include <cstring>
+#include <i2cdev.h>
+
+static const char *TAG = "PCA9685";
+
+PCA9685DevBus::PCA9685DevBus() {
+    memset(&m_dev, 0, sizeof(m_dev));
+    m_dev.cfg.scl_pullup_en = 1;
+    m_dev.cfg.sda_pullup_en = 1;
+    // m_dev.cfg.master.clk_speed = 40000; // 一个小坑，在这里修改无效，见pca9685_init_desc中的修改。
+}
+
+bool PCA9685DevBus::init() {
+    // Initialize the I2C device descriptor
+    ESP_LOGI(TAG, "Initializing PCA9685 descriptor");
+    pca9685_init_desc(&m_dev, PCA9685_I2C_ADDR, (i2c_port_t)I2C_PORT, (gpio_num_t)SDA_PIN, (gpio_num_t)SCL_PIN);
+    m_dev.cfg.master.clk_speed = PCA9685_I2C_CLK_HZ;
+    // Initialize the PCA9685 device
+    ESP_LOGI(TAG, "Initializing PCA9685");
+    esp_err_t err = pca9685_init(&m_dev);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to initialize PCA9685: %s", esp_err_to_name(err));
+        return false;
+    }
+
+    // pca9685_init() also sets MODE1.AI, which PCA9685::set_angles() relies on for burst writes.
+    // Restart the PCA9685
+    ESP_LOGI(TAG, "Restarting PCA9685");
+    err = pca9685_restart(&m_dev);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to restart PCA9685: %s", esp_err_to_name(err));
+        return false;
+    }
+
+    // Set the PWM frequency
+    ESP_LOGI(TAG, "Setting PWM frequency");
+    err = pca9685_set_pwm_frequency(&m_dev, PWM_FREQ_HZ);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to set PWM frequency: %s", esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
+
+bool PCA9685DevBus::write_reg(uint8_t reg, const uint8_t* data, size_t len) {
+    esp_err_t err = i2c_dev_take_mutex(&m_dev);
+    if (err == ESP_OK) {
+        err = i2c_dev_write_reg(&m_dev, reg, data, len);
+        i2c_dev_give_mutex(&m_dev);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "I2C write at reg 0x%02X (%d bytes) failed: %s", reg, (int)len, esp_err_to_name(err));
+        return false;
+    }
+    return true;
+}
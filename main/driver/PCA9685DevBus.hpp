@@ -0,0 +1,27 @@
+#pragma once
+
+#include "I2CBus.hpp"
+extern "C" {
+#include <pca9685.h>
+}
+
+// Default I2C configuration, you may need to change these based on your hardware.
+#define PCA9685_I2C_ADDR PCA9685_ADDR_BASE
+#define I2C_PORT 0
+#define SDA_PIN 23
+#define SCL_PIN 22
+
+// The on-board PCA9685 behind an esp-idf-lib i2cdev descriptor. Kept out of
+// PCA9685 itself, so the driver builds on a host against MockI2CBus.
+class PCA9685DevBus : public I2CBus {
+public:
+    PCA9685DevBus();
+
+    // Sets up the descriptor and the chip: auto-increment, restart and the
+    // PWM frequency.
+    bool init() override;
+    bool write_reg(uint8_t reg, const uint8_t* data, size_t len) override;
+
+private:
+    i2c_dev_t m_dev;
+};
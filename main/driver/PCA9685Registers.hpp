@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// PCA9685 register map and burst-frame encoding. Kept free of ESP-IDF
+// headers so the exact bytes sent per mixer tick can be checked on a host.
+namespace PCA9685Registers {
+
+constexpr uint8_t MODE1 = 0x00;
+constexpr uint8_t LED0_ON_L = 0x06;
+constexpr size_t BYTES_PER_CHANNEL = 4; // ON_L, ON_H, OFF_L, OFF_H
+constexpr size_t CHANNEL_COUNT = 16;
+constexpr uint16_t COUNT_MAX = 4095;
+
+constexpr uint8_t led_on_l(uint8_t channel) {
+    return static_cast<uint8_t>(LED0_ON_L + BYTES_PER_CHANNEL * channel);
+}
+
+// Encode `count` channels into `out` as consecutive LEDn_ON/LEDn_OFF register
+// pairs. Every pulse starts at tick 0 and ends at counts[i]. `out` must hold
+// count * BYTES_PER_CHANNEL bytes. Returns the number of bytes written.
+inline size_t encode_burst(const uint16_t* counts, size_t count, uint8_t* out) {
+    size_t n = 0;
+    for (size_t i = 0; i < count; ++i) {
+        uint16_t off = counts[i] > COUNT_MAX ? COUNT_MAX : counts[i];
+        out[n++] = 0;                                   // LEDn_ON_L
+        out[n++] = 0;                                   // LEDn_ON_H
+        out[n++] = static_cast<uint8_t>(off & 0xFF);    // LEDn_OFF_L
+        out[n++] = static_cast<uint8_t>(off >> 8);      // LEDn_OFF_H
+    }
+    return n;
+}
+
+// Wire time of one burst of `count` channels at clk_hz: address, register and
+// data bytes of 9 clocks each (8 bits and ACK), plus START and STOP.
+constexpr uint32_t burst_time_us(size_t count, uint32_t clk_hz) {
+    return static_cast<uint32_t>(((2 + BYTES_PER_CHANNEL * count) * 9 + 2) * 1000000ULL / clk_hz);
+}
+
+} // namespace PCA9685Registers
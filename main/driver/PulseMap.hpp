@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+// Per-channel angle -> PCA9685 off-count transform, compiled once from the
+// servo calibration so the output path is a single integer multiply-add.
+//
+//   count = clamp((offset_q16 + gain_q16 * angle_q4) >> 16, min_count, max_count)
+//
+// where angle_q4 is the commanded angle in 1/16 degree. Mirror mounting, the
+// angle range and the pulse range are all folded into gain/offset at compile
+// time. The result matches the float mapping it replaces to within one count
+// (~4 us at 60 Hz), and clamps to the pulse limits instead of extrapolating.
+struct PulseMap {
+    int32_t gain_q16;
+    int32_t offset_q16;
+    uint16_t min_count;
+    uint16_t max_count;
+
+    static constexpr int ANGLE_FRAC_BITS = 4;
+    // Keeps gain * angle inside int32 for any plausible gain (|angle| <= 512 deg).
+    static constexpr int32_t ANGLE_Q4_LIMIT = 512 << ANGLE_FRAC_BITS;
+
+    uint16_t apply(float angle) const {
+        int32_t angle_q4 = static_cast<int32_t>(angle * (1 << ANGLE_FRAC_BITS));
+        if (angle_q4 > ANGLE_Q4_LIMIT) angle_q4 = ANGLE_Q4_LIMIT;
+        if (angle_q4 < -ANGLE_Q4_LIMIT) angle_q4 = -ANGLE_Q4_LIMIT;
+        int32_t count = (offset_q16 + gain_q16 * angle_q4) >> 16;
+        if (count < min_count) return min_count;
+        if (count > max_count) return max_count;
+        return static_cast<uint16_t>(count);
+    }
+
+    // mirror_origin != 0 maps the commanded angle a to (mirror_origin - a)
+    // before the range mapping, for servos mounted the other way round.
+    static PulseMap compile(float min_angle, float max_angle, uint16_t min_pulse_us, uint16_t max_pulse_us,
+                            float mirror_origin, uint32_t pwm_freq_hz) {
+        // PCA9685 resolution is 12-bit (4096 steps).
+        const double us_per_step = 1000000.0 / (pwm_freq_hz * 4096.0);
+
+        double range_angle = max_angle - min_angle;
+        if (range_angle == 0) {
+            range_angle = 180.0; // Prevent division by zero
+        }
+
+        // count(a) = c0 + c1 * a', a' = a or (mirror_origin - a)
+        double c1 = (max_pulse_us - min_pulse_us) / (range_angle * us_per_step);
+        double c0 = min_pulse_us / us_per_step - c1 * min_angle;
+        if (mirror_origin != 0.0f) {
+            c0 += c1 * mirror_origin;
+            c1 = -c1;
+        }
+
+        PulseMap map;
+        map.gain_q16 = static_cast<int32_t>(c1 * (65536.0 / (1 << ANGLE_FRAC_BITS)));
+        map.offset_q16 = static_cast<int32_t>(c0 * 65536.0);
+        map.min_count = static_cast<uint16_t>(min_pulse_us / us_per_step);
+        map.max_count = static_cast<uint16_t>(max_pulse_us / us_per_step);
+        return map;
+    }
+};
@@ -2,6 +2,15 @@
 #define SERVO_HPP
 
 #include <stdint.h>
+#include <cmath>
+#include <span>
+
+// Bus-level output counters, reset only at boot.
+struct ServoWriteStats {
+    uint32_t transactions;        // Bus transactions issued
+    uint32_t channels_written;    // Channel updates that reached the bus
+    uint32_t channels_suppressed; // Channel updates dropped because the output was unchanged
+};
 
 class Servo {
 public:
@@ -11,6 +20,23 @@ public:
     virtual void init() = 0;
     virtual void set_angle(uint8_t channel, float angle) = 0;
     virtual void home_all() = 0;
+
+    // Set channels 0..angles.size()-1 in one go. A NaN entry leaves that
+    // channel at its last commanded position. Drivers that can batch the
+    // update into a single bus transaction should override this.
+    virtual void set_angles(std::span<const float> angles) {
+        for (size_t i = 0; i < angles.size(); ++i) {
+            if (!std::isnan(angles[i])) {
+                set_angle(static_cast<uint8_t>(i), angles[i]);
+            }
+        }
+    }
+
+    virtual ServoWriteStats get_write_stats() const { return {}; }
+
+    // Bus time of a set_angles() frame that updates `channels` channels, in
+    // microseconds; 0 for drivers whose writes take no bus time.
+    virtual uint32_t frame_time_us(size_t channels) const { (void)channels; return 0; }
 };
 
-#endif // SERVO_HPP
\ No newline at end of file
+#endif // SERVO_HPP
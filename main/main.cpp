@@ -9,6 +9,7 @@
 #include "nvs_flash.h"
 #include "driver/sd_card_manager.h"
 #include "driver/PCA9685.hpp"
+#include "driver/PCA9685DevBus.hpp"
 
 // LVGL & Display
 #include "lvgl.h"
@@ -57,7 +58,8 @@ extern "C" void app_main(void)
     // --- 3. Application Services and Managers Initialization ---
     ESP_LOGI(TAG, "Phase 3: Initializing Application Services & Managers");
 
-    // auto servo_driver = std::make_unique<PCA9685>();
+    // static PCA9685DevBus servo_bus;
+    // auto servo_driver = std::make_unique<PCA9685>(servo_bus);
     // servo_driver->init();
 
     // auto action_manager = std::make_unique<ActionManager>();
@@ -90,7 +92,7 @@ extern "C" void app_main(void)
     sound_manager->start();
 
     // Pass the AnimationPlayer instance to the WebServer
-    auto web_server = std::make_unique<WebServer>(*animation_player);
+    auto web_server = std::make_unique<WebServer>(*animation_player, nullptr); // motion_controller.get() once motion is enabled
     web_server->start();
 
 
@@ -2,10 +2,14 @@
 
 #include "motion_manager/Motion_types.hpp"
 #include "motion_manager/MotionStorage.hpp"
+#include "motion_manager/MotionPackSource.hpp"
+#include <atomic>
+#include <deque>
 #include <memory>
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 
 class ActionManager {
 public:
@@ -14,10 +18,29 @@ public:
 
     void init();
 
-    // Action data access
+    // Action data access, lock-free from any task. Templates are immutable:
+    // an edit publishes a new one in place of the old (read-copy-update), so
+    // the returned template is the latest published. Running action
+    // instances, the command table and staged edits reference templates in
+    // place; a replaced one stays valid until the executor has reported a
+    // later generation (see note_executor_generation()), a deleted override
+    // for the lifetime of the manager.
     const RegisteredAction* get_action(const std::string& name) const;
+    const RegisteredAction* get_action(ActionId id) const; // nullptr if id has no template
     const RegisteredGroup* get_group(const std::string& name) const;
 
+    // Interned action handles. Ids are dense, stable for the lifetime of the
+    // manager and only created during init, so lookups need no lock.
+    ActionId intern_action_id(const char* name);
+    ActionId get_action_id(const std::string& name) const;
+    const char* get_action_name(ActionId id) const; // nullptr for an unknown id
+    size_t action_id_count() const { return m_action_names.size(); }
+    uint8_t get_action_roles(ActionId id) const;
+    const ActionLayer& get_action_layer(ActionId id) const;
+    // Precomputed segments of a CATMULL_ROM keyframe action, nullptr for
+    // every other action. Built during init, like the ids.
+    const KeyframeSpline* get_keyframe_spline(ActionId id) const;
+
     // NVS Storage Interface
     bool delete_action_from_nvs(const std::string& action_name);
     bool delete_group_from_nvs(const std::string& group_name);
@@ -26,17 +49,65 @@ public:
 
     // Real-time Gait Tuning & API methods
     bool update_action_properties(const std::string& action_name, bool is_atomic, uint32_t default_steps, uint32_t gait_period_ms);
-    bool tune_gait_parameter(const std::string& action_name, int servo_index, const std::string& param_type, float value);
+    bool tune_gait_parameter(const std::string& action_name, int servo_index, const std::string& param_type, float value,
+                             int harmonic_index = 0);
+    bool set_gait_easing(const std::string& action_name, EasingType easing_type);
+    // Bumped after every published template edit or deleted override, so the
+    // mixer and the command table can take up the new templates.
+    uint32_t edit_generation() const { return m_edit_generation.load(std::memory_order_acquire); }
+    // Called by the executor after each tick with the generation it read
+    // before resolving any template that tick: it no longer references a
+    // template replaced at or before it, so the next edit may free those.
+    void note_executor_generation(uint32_t generation) {
+        m_executor_generation.store(generation, std::memory_order_release);
+    }
     bool save_action_to_nvs(const std::string& action_name);
+    bool save_actions_to_nvs(const std::vector<std::string>& action_names); // One NVS handle and commit for all
     std::string get_action_params_json(const std::string& action_name);
 
-    // keep this register function for public before moction is completed, change to private when release
-    void register_default_actions(bool force = false); // Register default actions if not present in NVS
 private:
+    // Groups are never edited, and the group cache only changes shape during
+    // init, so the executor can look it up while a deletion hides an entry.
+    struct CachedGroup {
+        RegisteredGroup group;
+        std::atomic<bool> deleted{false};
+    };
+    // A template replaced by an edit, and the edit generation that replaced it
+    struct RetiredAction {
+        std::unique_ptr<RegisteredAction> action;
+        uint32_t generation;
+    };
+
+    // Clears the caches, so only init may call it, before any instance runs.
+    void register_default_actions(bool force); // Load NVS overrides of the built-in actions; force uses the built-ins only
 
     void print_action_details(const RegisteredAction &action);
+    void load_motion_pack();
+    const RegisteredAction* find_library_action(const char* name) const;
+    const RegisteredAction* find_action(const std::string& name) const;
+    std::unique_ptr<RegisteredAction> copy_action(const std::string& name) const;
+    void publish_action(const std::string& name, std::unique_ptr<RegisteredAction> action);
+    void free_retired_actions();
+    void intern_cached_actions();
+    void build_keyframe_splines();
 
     std::unique_ptr<MotionStorage> m_storage;
-    std::map<std::string, RegisteredAction> m_action_cache;
-    std::map<std::string, RegisteredGroup> m_group_cache;
+    // Action library, searched in this order: m_action_cache overrides
+    // (NVS-loaded or tuned), the motion pack, the built-in DefaultActions.
+    // The caches and the retired lists belong to the editing tasks and are
+    // guarded by m_edit_mutex; the executor only reads m_published_actions.
+    MotionPackSource m_pack_source;
+    std::map<std::string, std::unique_ptr<RegisteredAction>> m_action_cache; // nullptr once deleted
+    std::map<std::string, CachedGroup> m_group_cache;
+    std::vector<RetiredAction> m_retired_actions;
+    std::vector<std::unique_ptr<RegisteredAction>> m_deleted_actions; // A running instance may keep them
+    std::map<std::string, ActionId> m_action_ids;
+    std::vector<uint8_t> m_action_roles; // Indexed by ActionId
+    std::vector<const char*> m_action_names; // Indexed by ActionId, keys of m_action_ids
+    std::vector<ActionLayer> m_action_layers; // Indexed by ActionId
+    std::vector<std::unique_ptr<KeyframeSpline>> m_keyframe_splines; // Indexed by ActionId
+    std::deque<std::atomic<const RegisteredAction*>> m_published_actions; // Indexed by ActionId; grows in place
+    std::atomic<uint32_t> m_edit_generation{0};
+    std::atomic<uint32_t> m_executor_generation{0};
+    std::mutex m_edit_mutex; // Serializes the editing tasks, never taken by the executor
 };
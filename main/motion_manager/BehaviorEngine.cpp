@@ -0,0 +1,149 @@
+#include "BehaviorEngine.hpp"
+#include "motion_manager/MotionCommands.hpp"
+#include "esp_log.h"
+#include <cstdlib>
+
+static const char* TAG = "Behavior";
+
+using Behavior::State;
+
+// Face area thresholds, in square pixels of a 640x480 frame. Each band has
+// an enter and a looser exit threshold, so a face hovering on a boundary does
+// not flip the state on every report.
+static const int screen_center_x = 640 / 2;
+static const int screen_center_y = 480 / 2;
+static const int FACE_IGNORE_AREA = 100 * 100;                 // Smaller faces are never approached
+static const int FAR_ENTER_AREA = 200 * 200;                   // Smaller faces are walked towards...
+static const int FAR_EXIT_AREA = 220 * 220;                    // ...until they reach this
+static const int CLOSE_ENTER_AREA = 400 * 680;                 // Larger faces stop the robot...
+static const int CLOSE_EXIT_AREA = CLOSE_ENTER_AREA * 8 / 10;  // ...until they shrink below this
+static const int CENTER_ENTER_X = screen_center_x * 6 / 10;    // Only approach faces this central
+static const int CENTER_ENTER_Y = screen_center_y * 6 / 10;
+static const int CENTER_EXIT_X = screen_center_x * 7 / 10;
+static const int CENTER_EXIT_Y = screen_center_y * 7 / 10;
+
+static const int64_t FACE_LOST_US = 1000000;      // No detection for this long drops the face
+static const int64_t ENGAGE_RETRY_US = 500000;    // Ask again if face tracking has not started
+static const int64_t FORWARD_RETRY_US = 2000000;  // Re-step if no walk has ended for this long
+static const int64_t ATTENTION_US = 4000000;      // How long a wake word makes sounds worth turning to
+static const int SOUND_TURN_MIN_DEG = 30;         // Sounds closer to straight ahead need no turn
+
+namespace Behavior {
+
+const char* state_name(State state) {
+    switch (state) {
+        case State::IDLE: return "idle";
+        case State::ENGAGING: return "engaging";
+        case State::TRACKING: return "tracking";
+        case State::APPROACHING: return "approaching";
+        case State::TOO_CLOSE: return "too_close";
+    }
+    return "?";
+}
+
+} // namespace Behavior
+
+static bool is_centered(const FaceLocation& face, int max_dx, int max_dy) {
+    return std::abs(screen_center_x - (face.x + face.w / 2)) <= max_dx &&
+           std::abs(screen_center_y - (face.y + face.h / 2)) <= max_dy;
+}
+
+bool BehaviorEngine::handle(const Behavior::Event& event, const Behavior::Context& context, uint8_t& command) {
+    const int64_t now_us = event.time_us;
+    switch (event.type) {
+        case Behavior::EventType::FACE:
+            return on_face(event.face, now_us, context, command);
+
+        case Behavior::EventType::WAKE_WORD:
+            m_attentive_until_us = now_us + ATTENTION_US;
+            // Called with nobody in view: look for them, once per window
+            if (m_state == State::IDLE && !context.body_moving && now_us >= m_next_search_us) {
+                m_next_search_us = now_us + ATTENTION_US;
+                return issue(MOTION_LOOKAROUND, command);
+            }
+            return false;
+
+        case Behavior::EventType::SOUND:
+            if (m_state != State::IDLE || now_us >= m_attentive_until_us || context.body_moving) return false;
+            if (std::abs(event.sound_bearing_deg) < SOUND_TURN_MIN_DEG) return false;
+            m_attentive_until_us = 0; // One turn per wake word
+            return issue(event.sound_bearing_deg > 0 ? MOTION_TRACKING_L : MOTION_TRACKING_R, command);
+
+        case Behavior::EventType::ACTION_FINISHED:
+            // A step towards the face ended: take another while it is still far
+            if (m_state == State::APPROACHING && (event.roles & ACTION_ROLE_BODY_MOVING) && !context.body_moving &&
+                now_us - m_last_seen_us < FACE_LOST_US) {
+                m_forward_us = now_us;
+                return issue(MOTION_FORWARD, command);
+            }
+            return false;
+    }
+    return false;
+}
+
+bool BehaviorEngine::on_face(const FaceLocation& face, int64_t now_us, const Behavior::Context& context,
+                             uint8_t& command) {
+    if (!face.detected) {
+        if (m_state != State::IDLE && now_us - m_last_seen_us >= FACE_LOST_US) {
+            enter(State::IDLE);
+        }
+        return false;
+    }
+    m_last_seen_us = now_us;
+    const int area = face.w * face.h;
+
+    if (m_state == State::TOO_CLOSE) {
+        if (area >= CLOSE_EXIT_AREA) return false;
+        enter(State::IDLE); // Backed off: engage again
+    }
+    if (area >= CLOSE_ENTER_AREA) {
+        // Avoid walking or turning into the user's face
+        enter(State::TOO_CLOSE);
+        return issue(MOTION_STOP, command);
+    }
+
+    if (!context.face_tracking_active) {
+        if (m_state != State::ENGAGING || now_us - m_engage_us >= ENGAGE_RETRY_US) {
+            enter(State::ENGAGING);
+            m_engage_us = now_us;
+            return issue(MOTION_FACE_TRACE, command);
+        }
+        return false;
+    }
+    if (m_state == State::IDLE || m_state == State::ENGAGING) {
+        enter(State::TRACKING);
+    }
+
+    if (m_state == State::APPROACHING) {
+        if (area >= FAR_EXIT_AREA || area < FACE_IGNORE_AREA || !is_centered(face, CENTER_EXIT_X, CENTER_EXIT_Y)) {
+            enter(State::TRACKING); // The walk in progress finishes on its own
+            return false;
+        }
+        // Normally ACTION_FINISHED takes the next step; this covers a lost event
+        if (!context.body_moving && now_us - m_forward_us >= FORWARD_RETRY_US) {
+            m_forward_us = now_us;
+            return issue(MOTION_FORWARD, command);
+        }
+        return false;
+    }
+
+    if (area >= FACE_IGNORE_AREA && area < FAR_ENTER_AREA && is_centered(face, CENTER_ENTER_X, CENTER_ENTER_Y) &&
+        !context.body_moving) {
+        enter(State::APPROACHING);
+        m_forward_us = now_us;
+        return issue(MOTION_FORWARD, command);
+    }
+    return false;
+}
+
+bool BehaviorEngine::issue(uint8_t code, uint8_t& command) {
+    command = code;
+    ++m_commands_issued;
+    return true;
+}
+
+void BehaviorEngine::enter(State state) {
+    if (state == m_state) return;
+    ESP_LOGI(TAG, "%s -> %s", Behavior::state_name(m_state), Behavior::state_name(state));
+    m_state = state;
+}
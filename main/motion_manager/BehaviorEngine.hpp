@@ -0,0 +1,67 @@
+#pragma once
+
+#include "motion_manager/Motion_types.hpp"
+#include <cstdint>
+
+// DecisionMaker's behaviour, as a state machine driven by events. It has no
+// clock or RTOS dependencies: every event carries its time, and the caller
+// passes in what the motion controller is doing when the event is handled.
+// The same event stream therefore always produces the same commands, which
+// is how tools/motionsim replays it on the host.
+namespace Behavior {
+
+enum class EventType : uint8_t {
+    FACE,            // A face report, detected or not
+    WAKE_WORD,       // The wake word was heard
+    SOUND,           // A sound came from sound_bearing_deg
+    ACTION_FINISHED  // An action with roles ended in the mixer
+};
+
+typedef struct {
+    EventType type;
+    uint8_t roles;             // ACTION_FINISHED: ActionRole bits of the action
+    int16_t sound_bearing_deg; // SOUND: degrees from straight ahead, positive to the left
+    int64_t time_us;
+    FaceLocation face;         // FACE
+} Event;
+
+// Motion controller state when an event is handled.
+typedef struct {
+    bool face_tracking_active;
+    bool body_moving;
+} Context;
+
+enum class State : uint8_t {
+    IDLE,        // No face
+    ENGAGING,    // Face seen, face tracking requested
+    TRACKING,    // Following the face with the head
+    APPROACHING, // Walking towards a far face
+    TOO_CLOSE    // Stopped for a face that is too close
+};
+
+const char* state_name(State state);
+
+} // namespace Behavior
+
+class BehaviorEngine {
+public:
+    // Handles one event. Returns true and sets command when the event calls
+    // for a motion command.
+    bool handle(const Behavior::Event& event, const Behavior::Context& context, uint8_t& command);
+
+    Behavior::State state() const { return m_state; }
+    uint32_t commands_issued() const { return m_commands_issued; }
+
+private:
+    bool on_face(const FaceLocation& face, int64_t now_us, const Behavior::Context& context, uint8_t& command);
+    bool issue(uint8_t code, uint8_t& command);
+    void enter(Behavior::State state);
+
+    Behavior::State m_state = Behavior::State::IDLE;
+    int64_t m_last_seen_us = 0;      // Last detected face
+    int64_t m_engage_us = 0;         // Last face tracking request
+    int64_t m_forward_us = 0;        // Last forward step request
+    int64_t m_attentive_until_us = 0; // Wake word window for turning to a sound
+    int64_t m_next_search_us = 0;    // No look-around before this
+    uint32_t m_commands_issued = 0;
+};
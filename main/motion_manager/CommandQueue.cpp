@@ -0,0 +1,100 @@
+#include "CommandQueue.hpp"
+#include "motion_manager/MotionCommands.hpp"
+
+// How long a command of each class may wait, by CommandClass. Most outlast
+// the longest built-in atomic action (sudden_shock, 5.5 s); a walk only
+// outlasts angry (3.5 s), and a turn goes stale fastest, as the face or
+// sound it was aimed at moves on.
+static const int64_t CLASS_TTL_US[] = {
+    6000000, // EXPRESSION
+    4000000, // LOCOMOTION
+    1000000, // TRACKING_TURN
+    6000000, // CONTROL
+};
+static_assert(sizeof(CLASS_TTL_US) / sizeof(CLASS_TTL_US[0]) == static_cast<size_t>(CommandClass::COUNT),
+              "Command class TTLs out of date");
+
+CommandClass command_class(uint8_t code) {
+    switch (code) {
+        case MOTION_FORWARD:
+        case MOTION_BACKWARD:
+        case MOTION_LEFT:
+        case MOTION_RIGHT:
+        case MOTION_WALK_FORWARD_KF:
+        case MOTION_WALK_BACKWARD_KF:
+            return CommandClass::LOCOMOTION;
+        case MOTION_TRACKING_L:
+        case MOTION_TRACKING_R:
+            return CommandClass::TRACKING_TURN;
+        case MOTION_FACE_TRACE:
+        case MOTION_FACE_END:
+        case MOTION_WAKE_DETECT:
+        case MOTION_SERVO_CONTROL:
+            return CommandClass::CONTROL;
+        default:
+            return CommandClass::EXPRESSION;
+    }
+}
+
+static bool coalesces(CommandClass command_class) {
+    return command_class == CommandClass::LOCOMOTION || command_class == CommandClass::TRACKING_TURN;
+}
+
+CommandQueue::PushResult CommandQueue::push(const motion_command_t& command, int64_t queued_us) {
+    const CommandClass cls = command_class(command.motion_type);
+    const Entry entry = {command, queued_us, queued_us + CLASS_TTL_US[static_cast<int>(cls)], cls};
+
+    PushResult result = PushResult::ADDED;
+    Entry* replaced = nullptr;
+    if (coalesces(cls)) {
+        for (Entry& pending : m_entries) {
+            if (pending.command_class == cls) {
+                replaced = &pending;
+                result = PushResult::COALESCED;
+                break;
+            }
+        }
+    }
+    if (!replaced && m_entries.full()) {
+        replaced = m_entries.begin();
+        for (Entry& pending : m_entries) {
+            if (pending.command_class < replaced->command_class) replaced = &pending;
+        }
+        if (replaced->command_class > cls) return PushResult::REJECTED;
+        result = PushResult::EVICTED;
+    }
+    // The newcomer goes to the back: it is the latest arrival of its class
+    if (replaced) m_entries.erase(replaced, replaced + 1);
+    *m_entries.acquire() = entry;
+    return result;
+}
+
+bool CommandQueue::pop(Entry& entry) {
+    if (m_entries.empty()) return false;
+    Entry* best = m_entries.begin();
+    for (Entry& pending : m_entries) {
+        if (pending.command_class > best->command_class) best = &pending;
+    }
+    entry = *best;
+    m_entries.erase(best, best + 1);
+    return true;
+}
+
+uint32_t CommandQueue::expire(int64_t now_us) {
+    uint32_t expired = 0;
+    for (Entry* pending = m_entries.begin(); pending != m_entries.end();) {
+        if (pending->deadline_us <= now_us) {
+            m_entries.erase(pending, pending + 1);
+            ++expired;
+        } else {
+            ++pending;
+        }
+    }
+    return expired;
+}
+
+uint32_t CommandQueue::clear() {
+    const uint32_t cleared = static_cast<uint32_t>(m_entries.size());
+    m_entries.clear();
+    return cleared;
+}
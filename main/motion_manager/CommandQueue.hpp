@@ -0,0 +1,56 @@
+#pragma once
+
+#include "motion_manager/InstancePool.hpp"
+#include "motion_manager/Motion_types.hpp"
+#include <cstdint>
+
+// Command classes, lowest priority first. Deferred commands are dispatched
+// highest class first, and in arrival order within a class.
+enum class CommandClass : uint8_t {
+    EXPRESSION,    // Gestures, emotions and named motions
+    LOCOMOTION,    // Walks and steering turns
+    TRACKING_TURN, // Body turns after a face or a sound
+    CONTROL,       // Face tracking, wake and servo control
+    COUNT
+};
+
+CommandClass command_class(uint8_t code);
+
+// Commands the DISPATCH stage holds back while an atomic action runs. Each
+// entry expires a class-dependent time after it was queued, so a command
+// that waited too long is dropped rather than acted on late. A newer
+// locomotion or tracking turn command replaces a pending one of its class.
+// A full queue makes room by dropping its lowest-class, oldest entry.
+// Executor only.
+class CommandQueue {
+public:
+    static constexpr size_t CAPACITY = 16;
+
+    struct Entry {
+        motion_command_t command;
+        int64_t queued_us;
+        int64_t deadline_us;
+        CommandClass command_class;
+    };
+
+    enum class PushResult : uint8_t {
+        ADDED,
+        COALESCED, // Replaced a pending command of the same class
+        EVICTED,   // Added in place of a lower or equal class entry
+        REJECTED   // Full of higher class entries; not added
+    };
+
+    PushResult push(const motion_command_t& command, int64_t queued_us);
+    // Takes the highest class, oldest entry. Returns false when empty.
+    bool pop(Entry& entry);
+    // Drops entries whose deadline is at or before now_us; returns how many.
+    uint32_t expire(int64_t now_us);
+    // Drops every entry; returns how many.
+    uint32_t clear();
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+
+private:
+    InstancePool<Entry, CAPACITY> m_entries; // Arrival order
+};
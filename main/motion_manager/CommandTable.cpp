@@ -0,0 +1,82 @@
+#include "CommandTable.hpp"
+#include "motion_manager/ActionManager.hpp"
+#include "esp_log.h"
+#include <string.h>
+#include <string>
+
+static const char* TAG = "CommandTable";
+
+CommandTable::CommandTable() {
+    memset(m_slot, NO_SLOT, sizeof(m_slot));
+}
+
+void CommandTable::bind(uint8_t code, const char* name) {
+    m_names[code] = name;
+}
+
+bool CommandTable::resolve(const ActionManager& manager, const char* name, Member (&members)[MAX_ACTIONS_PER_GROUP],
+                           Target& target) {
+    const std::string key(name);
+    target = {nullptr, members, 0};
+    const RegisteredGroup* group = manager.get_group(key);
+    if (group) {
+        target.group = group;
+        for (uint8_t i = 0; i < group->action_count; ++i) {
+            const std::string member_name(group->action_names[i]);
+            const RegisteredAction* action = manager.get_action(member_name);
+            if (action) {
+                members[target.member_count++] = {action, manager.get_action_id(member_name)};
+            } else {
+                ESP_LOGE(TAG, "Member action '%s' not found for group '%s'!", group->action_names[i], name);
+            }
+        }
+        return true;
+    }
+
+    const RegisteredAction* action = manager.get_action(key);
+    if (action == nullptr) {
+        ESP_LOGE(TAG, "Action '%s' not found in manager!", name);
+        return false;
+    }
+    members[target.member_count++] = {action, manager.get_action_id(key)};
+    return true;
+}
+
+// Member pointers are fixed up after every target is in, since m_members
+// grows while they are resolved.
+void CommandTable::build(const ActionManager& manager, uint32_t generation) {
+    memset(m_slot, NO_SLOT, sizeof(m_slot));
+    m_targets.clear();
+    m_members.clear();
+    // Ids, unlike templates, never change after init: the reverse index is
+    // built once, and can be read from any task after that.
+    const bool index_actions = m_code_by_action.empty();
+    if (index_actions) {
+        m_code_by_action.assign(manager.action_id_count(), -1);
+    }
+    std::vector<size_t> first_member;
+
+    for (int code = 0; code < 256; ++code) {
+        if (m_names[code] == nullptr) continue;
+        Member members[MAX_ACTIONS_PER_GROUP];
+        Target target;
+        if (!resolve(manager, m_names[code], members, target)) continue;
+        if (m_targets.size() >= NO_SLOT) {
+            ESP_LOGE(TAG, "Too many command targets, 0x%02X left unbound.", code);
+            break;
+        }
+        m_slot[code] = static_cast<uint8_t>(m_targets.size());
+        first_member.push_back(m_members.size());
+        m_members.insert(m_members.end(), members, members + target.member_count);
+        m_targets.push_back(target);
+        if (index_actions && target.group == nullptr && members[0].id < m_code_by_action.size() &&
+            m_code_by_action[members[0].id] < 0) {
+            m_code_by_action[members[0].id] = static_cast<int16_t>(code);
+        }
+    }
+    for (size_t i = 0; i < m_targets.size(); ++i) {
+        m_targets[i].members = m_members.data() + first_member[i];
+    }
+    m_generation = generation;
+    ESP_LOGI(TAG, "Resolved %d command codes to %d actions.", (int)m_targets.size(), (int)m_members.size());
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "motion_manager/Motion_types.hpp"
+#include <cstdint>
+#include <vector>
+
+class ActionManager;
+
+// Motion command codes resolved to the templates they start. Codes are bound
+// to action or group names once at init; build() then resolves every name,
+// and a group's members, to template pointers and ids, so dispatching a code
+// is an array index with no name lookup. Every template edit publishes a new
+// template (ActionManager copies it on write), so the owner rebuilds the
+// table whenever ActionManager::edit_generation() moves on.
+class CommandTable {
+public:
+    struct Member {
+        const RegisteredAction* action;
+        ActionId id;
+    };
+
+    // What a name resolves to: a single action is a target with one member
+    // and no group.
+    struct Target {
+        const RegisteredGroup* group;
+        const Member* members;
+        uint8_t member_count;
+    };
+
+    CommandTable();
+
+    // Binds code to an action or group name, which must outlive the table.
+    void bind(uint8_t code, const char* name);
+
+    // Resolves every bound name against manager, which is at generation.
+    void build(const ActionManager& manager, uint32_t generation);
+    uint32_t generation() const { return m_generation; }
+
+    // nullptr when code is unbound or its name did not resolve. Owner only.
+    const Target* find(uint8_t code) const {
+        return m_slot[code] == NO_SLOT ? nullptr : &m_targets[m_slot[code]];
+    }
+    // Name bound to code, or nullptr
+    const char* name(uint8_t code) const { return m_names[code]; }
+
+    // The lowest code whose target is the single action id. Returns false if
+    // none. Any task, once the table has been built.
+    bool code_for(ActionId id, uint8_t& code) const {
+        if (id >= m_code_by_action.size() || m_code_by_action[id] < 0) return false;
+        code = static_cast<uint8_t>(m_code_by_action[id]);
+        return true;
+    }
+
+    // Resolves a name that is not in the table (MOTION_PLAY_MOTION) into
+    // members. Returns false, having logged why, if it names nothing.
+    static bool resolve(const ActionManager& manager, const char* name, Member (&members)[MAX_ACTIONS_PER_GROUP],
+                        Target& target);
+
+private:
+    static constexpr uint8_t NO_SLOT = 0xFF;
+
+    const char* m_names[256] = {};
+    uint8_t m_slot[256];                 // Index into m_targets by code
+    std::vector<Target> m_targets;
+    std::vector<Member> m_members;       // Members of all targets, in target order
+    std::vector<int16_t> m_code_by_action; // Indexed by ActionId; -1 when no code starts the action alone
+    uint32_t m_generation = UINT32_MAX;  // Never built
+};
@@ -1,22 +1,40 @@
 #pragma once
 
 #include "Motion_types.hpp"
-#include <functional>
+#include "motion_manager/BehaviorEngine.hpp"
+#include "motion_manager/MotionPlatform.hpp"
+#include "motion_manager/MpscRing.hpp"
+#include <atomic>
 
 class MotionController; // Forward declaration
 
+// Feeds posted events to the BehaviorEngine. Producers post from any task;
+// the motion executor handles them in its BEHAVIOR stage, so there is no
+// task or timer of its own.
 class DecisionMaker
 {
 public:
     DecisionMaker(MotionController& motion_controller);
-    void start();
+
+    // Event sources. Any task; never block.
     void set_face_location(const FaceLocation& location);
+    void post_wake_word();
+    void post_sound(int bearing_deg); // Degrees from straight ahead, positive to the left
+    void post_action_finished(uint8_t roles, int64_t now_us);
+
+    // Handles events in posting order until none are left or the clock
+    // passes deadline_us; the rest wait for the next call. Motion executor only.
+    void process_pending_events(int64_t deadline_us);
+
+    uint32_t commands_issued() const { return m_commands_issued.load(std::memory_order_relaxed); }
+    uint32_t events_dropped() const { return m_events_dropped.load(std::memory_order_relaxed); }
 
 private:
-    void decision_maker_task();
+    void post(const Behavior::Event& event);
 
     MotionController& m_motion_controller;
-    FaceLocation m_last_face_location;
-    // Add any state variables needed for decision making
-    // e.g., bool m_is_walking;
-};
\ No newline at end of file
+    BehaviorEngine m_engine; // Motion executor only
+    MpscRing<Behavior::Event, 16> m_events;
+    std::atomic<uint32_t> m_commands_issued{0};
+    std::atomic<uint32_t> m_events_dropped{0};
+};
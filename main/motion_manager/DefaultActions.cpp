@@ -0,0 +1,1604 @@
+#include "motion_manager/DefaultActions.hpp"
+#include "motion_manager/ServoCalibration.hpp"
+#include <cmath>
+#include <cstring>
+#include <array>
+
+#define PI 3.1415926
+
+namespace DefaultActions {
+
+namespace {
+
+// --- constexpr counterparts of the strcpy/memcpy the builders used to do ---
+// Names double as NVS keys, so they must fit MOTION_NAME_MAX_LEN including the
+// terminator. An overlong name stops the build instead of overflowing.
+constexpr void copy_name(char (&dst)[MOTION_NAME_MAX_LEN], const char* src) {
+    size_t i = 0;
+    for (; src[i] != '\0'; ++i) {
+        if (i >= MOTION_NAME_MAX_LEN - 1) {
+            throw "default action name too long";
+        }
+        dst[i] = src[i];
+    }
+    for (; i < MOTION_NAME_MAX_LEN; ++i) {
+        dst[i] = '\0';
+    }
+}
+
+constexpr void copy_positions(float (&dst)[GAIT_JOINT_COUNT], const std::array<float, GAIT_JOINT_COUNT>& src) {
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        dst[i] = src[i];
+    }
+}
+
+// Calibrated home pose, the base every keyframe is expressed against
+constexpr std::array<float, GAIT_JOINT_COUNT> create_home_pos() {
+    std::array<float, GAIT_JOINT_COUNT> pos = {};
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        pos[i] = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
+    }
+    return pos;
+}
+
+// Scope for walk_forward_kf (Generated from periodic gait - Emo-like shuffle)
+constexpr RegisteredAction make_walk_forward_kf() {
+    RegisteredAction walk_forward_kf = {};
+    copy_name(walk_forward_kf.name, "walk_forward_kf");
+    walk_forward_kf.type = ActionType::KEYFRAME_SEQUENCE;
+    walk_forward_kf.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    walk_forward_kf.is_atomic = false;
+    walk_forward_kf.default_steps = 4; // Loop the full cycle 4 times
+    
+    auto& kf_data = walk_forward_kf.data.keyframe;
+    kf_data.frame_count = 0;
+    kf_data.interpolation = KeyframeInterpolation::CATMULL_ROM; // Continuous loop, no stop at each frame
+
+    const int frame_time = 1200 / 16; // 93.75ms
+
+    // Frame 0
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 15.00f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 15.00f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 1
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += 12.63f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += 12.63f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 13.86f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 13.86f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] -= 19.13f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] += 19.13f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 2
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += 23.33f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += 23.33f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 10.61f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 10.61f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] -= 35.36f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] += 35.36f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 3
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += 30.48f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += 30.48f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 5.74f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 5.74f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] -= 46.19f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] += 46.19f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 4
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += 33.00f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += 33.00f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 0.00f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 0.00f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] -= 50.00f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] += 50.00f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 5
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += 30.48f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += 30.48f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= 5.74f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= 5.74f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] -= 46.19f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] += 46.19f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 6
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += 23.33f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += 23.33f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= 10.61f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= 10.61f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] -= 35.36f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] += 35.36f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 7
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += 12.63f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += 12.63f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= 13.86f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= 13.86f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] -= 19.13f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] += 19.13f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 8
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += 0.00f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += 0.00f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= 15.00f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= 15.00f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] -= 0.00f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] += 0.00f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 9
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= 12.63f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= 12.63f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= 13.86f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= 13.86f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] += 19.13f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] -= 19.13f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 10
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= 23.33f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= 23.33f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= 10.61f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= 10.61f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] += 35.36f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] -= 35.36f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 11
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= 30.48f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= 30.48f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= 5.74f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= 5.74f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] += 46.19f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] -= 46.19f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 12
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= 33.00f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= 33.00f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= 0.00f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= 0.00f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] += 50.00f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] -= 50.00f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 13
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= 30.48f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= 30.48f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 5.74f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 5.74f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] += 46.19f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] -= 46.19f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 14
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= 23.33f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= 23.33f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 10.61f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 10.61f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] += 35.36f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] -= 35.36f;
+        copy_positions(frame.positions, pos);
+    }
+    // Frame 15
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= 12.63f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= 12.63f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 13.86f;  
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 13.86f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] += 19.13f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] -= 19.13f;
+        copy_positions(frame.positions, pos);
+    }
+
+    return walk_forward_kf;
+}
+
+constexpr RegisteredAction make_forward() {
+    RegisteredAction forward = {};
+    copy_name(forward.name, "walk_forward");
+    forward.type = ActionType::GAIT_PERIODIC;
+    forward.data.gait.harmonic_count = 1;
+    forward.is_atomic = false;
+    forward.default_steps = 4;
+    forward.data.gait.gait_period_ms = 1500;
+    forward.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_LEG_ROTATE)]  = 33;
+    forward.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_LEG_ROTATE)] = 33;
+    forward.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_ANKLE_LIFT)]   = 15;
+    forward.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_ANKLE_LIFT)]  = 15;
+    forward.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_ARM_SWING)]  = -50;
+    forward.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_ARM_SWING)]  = 50;
+    forward.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::LEFT_ANKLE_LIFT)]   = PI / 2;
+    forward.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::RIGHT_ANKLE_LIFT)]  = PI / 2;
+    return forward;
+}
+
+constexpr RegisteredAction make_backward() {
+    RegisteredAction backward = make_forward();
+    copy_name(backward.name, "walk_backward");
+    backward.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_LEG_ROTATE)]  = -33;
+    backward.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_LEG_ROTATE)] = -33;
+    backward.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_ARM_SWING)]  = -60;
+    backward.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_ARM_SWING)]  = -60;
+    return backward;
+}
+
+// Scope for turn_left_kf (Shuffle-Turn Logic V2)
+constexpr RegisteredAction make_turn_left_kf() {
+    RegisteredAction turn_left_kf = {};
+    copy_name(turn_left_kf.name, "turn_left");
+    turn_left_kf.type = ActionType::KEYFRAME_SEQUENCE;
+    turn_left_kf.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    turn_left_kf.is_atomic = false;
+    turn_left_kf.default_steps = 4;
+    
+    auto& kf_data = turn_left_kf.data.keyframe;
+    kf_data.frame_count = 0;
+
+    const int frame_time = 1200 / 16; // Faster cycle
+
+    // Parameters for a left shuffle-turn (V2 - Reduced amplitude)
+    const float r_leg_rot_amp = 20.0f;  // Right leg swings more
+    const float l_leg_rot_amp = -20.0f; // Left leg swings backward less
+    const float lift_amp = 20.0f;       // Lift height for both feet
+    const float arm_amp = -30.0f;       // Arms swing opposite to body rotation
+
+    for (int i = 0; i < 16; ++i) {
+        if (kf_data.frame_count >= MAX_KEYFRAMES_PER_ACTION) break;
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        float theta = (float)i * 2.0f * PI / 16.0f + PI;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += r_leg_rot_amp * sin(theta);
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)]  += l_leg_rot_amp * sin(theta);
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += lift_amp * cos(theta) ; // cos(theta) is sin(theta + PI/2)
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)]  += lift_amp * 1.2 * cos(theta) + 8.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)]  -= arm_amp * sin(theta);
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)]   += arm_amp * sin(theta);
+
+        copy_positions(frame.positions, pos);
+    }
+
+    return turn_left_kf;
+}
+
+// Scope for turn_right_kf (Shuffle-Turn Logic V2)
+constexpr RegisteredAction make_turn_right_kf() {
+    RegisteredAction turn_right_kf = {};
+    copy_name(turn_right_kf.name, "turn_right");
+    turn_right_kf.type = ActionType::KEYFRAME_SEQUENCE;
+    turn_right_kf.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    turn_right_kf.is_atomic = false;
+    turn_right_kf.default_steps = 4;
+    
+    auto& kf_data = turn_right_kf.data.keyframe;
+    kf_data.frame_count = 0;
+
+    const int frame_time = 1200 / 16; // Faster cycle
+
+    // Parameters for a right shuffle-turn (V2 - Reduced amplitude, mirrored)
+    const float r_leg_rot_amp = -10.0f; // Right leg swings backward less
+    const float l_leg_rot_amp = 28.0f;  // Left leg swings more
+    const float lift_amp = 20.0f;       // Lift height for both feet
+    const float arm_amp = 30.0f;        // Arms swing opposite to body rotation
+
+    for (int i = 0; i < 16; ++i) {
+        if (kf_data.frame_count >= MAX_KEYFRAMES_PER_ACTION) break;
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        float theta = (float)i * 2.0f * PI / 16.0f;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += r_leg_rot_amp * sin(theta);
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)]  += l_leg_rot_amp * sin(theta);
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += lift_amp * cos(theta) + 5.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)]  += lift_amp * cos(theta) + 8.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)]  += arm_amp * sin(theta);
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)]   -= arm_amp * sin(theta);
+
+        copy_positions(frame.positions, pos);
+    }
+    
+    return turn_right_kf;
+}
+
+constexpr RegisteredAction make_wiggle_ears() {
+    RegisteredAction wiggle_ears = {};
+    copy_name(wiggle_ears.name, "wiggle_ears");
+    wiggle_ears.type = ActionType::GAIT_PERIODIC;
+    wiggle_ears.data.gait.harmonic_count = 1;
+    wiggle_ears.is_atomic = false;
+    wiggle_ears.default_steps = 2;
+    wiggle_ears.data.gait.gait_period_ms = 1500;
+    wiggle_ears.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_EAR_LIFT)] = 15;
+    wiggle_ears.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_EAR_LIFT)] = 15;
+    wiggle_ears.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_EAR_SWING)] = 10;
+    wiggle_ears.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_EAR_SWING)] = 10;
+    return wiggle_ears;
+}
+
+// Scope for wave_hand
+constexpr RegisteredAction make_wave_hand() {
+    RegisteredAction wave_hand = {};
+    copy_name(wave_hand.name, "wave_hand");
+    wave_hand.type = ActionType::KEYFRAME_SEQUENCE;
+    wave_hand.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    wave_hand.is_atomic = false;
+    wave_hand.default_steps = 1;
+    
+    auto& kf_data = wave_hand.data.keyframe;
+    kf_data.frame_count = 0;
+
+    // Frame 0: Return to home
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 100;
+        auto pos = create_home_pos(); // Return all to home
+        copy_positions(frame.positions, pos);
+    }
+
+    return wave_hand;
+}
+
+constexpr RegisteredAction make_nod_head() {
+    RegisteredAction nod_head = {};
+    copy_name(nod_head.name, "nod_head");
+    nod_head.type = ActionType::GAIT_PERIODIC;
+    nod_head.data.gait.harmonic_count = 1;
+    nod_head.is_atomic = false;
+    nod_head.default_steps = 2;
+    nod_head.data.gait.gait_period_ms = 1500;
+    nod_head.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::HEAD_TILT)] = 10;
+    return nod_head;
+}
+
+constexpr RegisteredAction make_shake_head() {
+    RegisteredAction shake_head = make_nod_head();
+    copy_name(shake_head.name, "shake_head");
+    shake_head.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::HEAD_PAN)] = 20;
+    shake_head.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::HEAD_TILT)] = 0;
+    return shake_head;
+}
+
+constexpr RegisteredAction make_walk_backward_kf() {
+    RegisteredAction walk_backward_kf = {};
+    copy_name(walk_backward_kf.name, "walk_back_kf");
+    walk_backward_kf.type = ActionType::KEYFRAME_SEQUENCE;
+    walk_backward_kf.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    walk_backward_kf.is_atomic = false;
+    walk_backward_kf.default_steps = 4; // Loop the full cycle 4 times
+    
+    auto& kf_data = walk_backward_kf.data.keyframe;
+    kf_data.frame_count = 0;
+    kf_data.interpolation = KeyframeInterpolation::CATMULL_ROM; // Continuous loop, no stop at each frame
+
+    const float original_rot_amp = 55.0f;
+    const float forward_rot_amp = original_rot_amp * 0.90f;
+    const float backward_rot_amp = original_rot_amp * 0.80f;
+    const float lift_amp = 40.0f;
+    const int frame_time = 180;
+
+    // Backward sequence starts here
+    // Frame 0: Start by lifting right foot high
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= lift_amp; // Right foot at peak lift
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 1: Right leg 50% backward, Left leg 50% forward, Right foot landing
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += forward_rot_amp * 0.5f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += forward_rot_amp * 0.5f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= lift_amp * 0.5f; // Right foot moving down to land
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 2: Right leg full backward, Left leg full forward
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += forward_rot_amp;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += forward_rot_amp;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= lift_amp * 0.5f; // Left foot pushing off
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 3: Right leg 50% backward, Left leg 50% forward, Left foot lifting
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += forward_rot_amp * 0.5f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += forward_rot_amp * 0.5f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += lift_amp * 0.5f; // Left foot lifting high
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 4: Legs neutral, Left foot at max height
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += lift_amp; // Left foot at peak lift
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 5: Left leg 50% backward, Right leg 50% forward, Left foot landing
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= backward_rot_amp * 0.5f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= backward_rot_amp * 0.5f;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += lift_amp * 0.5f; // Left foot moving down to land
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 6: Left leg full backward, Right leg full forward
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= backward_rot_amp;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= backward_rot_amp;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += lift_amp * 0.5f; // Right foot pushing off
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 7: Left leg 50% backward, Right leg 50% forward, Right foot lifting
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= backward_rot_amp * 0.5f;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= backward_rot_amp * 0.5f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= lift_amp * 0.5f; // Right foot lifting high
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    return walk_backward_kf;
+}
+
+constexpr RegisteredAction make_silly() {
+    RegisteredAction silly = {};
+    copy_name(silly.name, "dance");
+    silly.type = ActionType::KEYFRAME_SEQUENCE;
+    silly.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    silly.is_atomic = false; // can be interrupted
+    silly.default_steps = 2; // Play sequence only once
+    
+    auto& kf_data = silly.data.keyframe;
+    kf_data.frame_count = 0;
+
+    // Keyframe 1: Look Left, Arms Out (Attention!) - 1.0s
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 95;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 90;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 100;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 85;
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 70;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 30;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 30;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Keyframe 2: Look Right, Crouch - 1.3s
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 110;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 80;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 75;
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 110;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] = 100;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] = 60;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 110;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 100;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Keyframe 3: Dance Twist Left (STABILITY V3) - 1.8s
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1500;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 65;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 150;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 150;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 40;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 30;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] = 45;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] = 90;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] = 45;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] = 105;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Keyframe 4: Dance Twist Right (V4 COORDINATION FIX) - 1.8s
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1500;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 75;       // Reduced head nod
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 30;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 30;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 110;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 100;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] = 110;  // Reduced left leg outward rotation
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] = 110;  // Reduced left leg lift
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] = 135;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] = 90;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Keyframe 5: Shimmy 1 - 1.3s
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1100;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 75;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 110;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 70;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 80;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 110;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 120;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 120;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 50;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 50;
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] = 90;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] = 70;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Keyframe 6: Shimmy 2 - 1.3s
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1300;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 105;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 70;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 70;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 100;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 90;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Keyframe 7: Ta-da Pose - 1.8s
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1500;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 60;
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 100;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 100;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 70;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 160;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 10;
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] = 150;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Keyframe 8: Return to Neutral - 1.8s
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1200;
+        auto pos = create_home_pos();
+        copy_positions(frame.positions, pos);
+    }
+
+    return silly;
+}
+
+constexpr RegisteredAction make_funny() {
+    RegisteredAction funny = {};
+    copy_name(funny.name, "funny");
+    funny.type = ActionType::GAIT_PERIODIC;
+    funny.data.gait.harmonic_count = 1;
+    funny.is_atomic = false;
+    funny.default_steps = 4;
+    funny.data.gait.gait_period_ms = 1500;
+    funny.data.gait.harmonic_terms[0].offset[static_cast<uint8_t>(ServoChannel::RIGHT_LEG_ROTATE)] = 30;
+    funny.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_LEG_ROTATE)] = 10;
+    funny.data.gait.harmonic_terms[0].offset[static_cast<uint8_t>(ServoChannel::LEFT_LEG_ROTATE)] = -30;
+    funny.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_LEG_ROTATE)] = 10;
+    funny.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::LEFT_LEG_ROTATE)] = PI;
+    funny.data.gait.harmonic_terms[0].offset[static_cast<uint8_t>(ServoChannel::LEFT_ARM_LIFT)] = 5;
+    funny.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_ARM_LIFT)] = 10;
+    funny.data.gait.harmonic_terms[0].offset[static_cast<uint8_t>(ServoChannel::RIGHT_ARM_LIFT)] = 5;
+    funny.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_ARM_LIFT)] = 10;
+    funny.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::RIGHT_ARM_LIFT)] = PI;
+    funny.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_EAR_LIFT)] = 5;
+    funny.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_EAR_LIFT)] = 5;
+    funny.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::RIGHT_EAR_LIFT)] = PI;
+    return funny;
+}
+
+constexpr RegisteredAction make_happy() {
+    RegisteredAction happy = {};
+    copy_name(happy.name, "happy");
+    happy.type = ActionType::KEYFRAME_SEQUENCE;
+    happy.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    happy.is_atomic = false;
+    happy.default_steps = 1;
+    
+    auto& kf_data = happy.data.keyframe;
+    kf_data.frame_count = 0;
+
+    const float sway_lean = 15.0f;
+    const float arm_raise = 60.0f; // Increased arm amplitude
+    const float head_pan_amp = 15.0f;
+    const float ear_lift_offset = 10.0f; // For forward/back ear movement
+    const float ear_swing_offset = 10.0f; // For in/out ear movement
+
+    // Frame 0: Settle into a stable stance
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 600;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 10;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 10;
+        copy_positions(frame.positions, pos);
+    }
+
+    // --- Sway Loop (x2) ---
+    for (int i = 0; i < 2; ++i) {
+        // Frame: Sway Left
+        if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+            auto& frame = kf_data.frames[kf_data.frame_count++];
+            frame.transition_time_ms = 400; // Faster
+            auto pos = create_home_pos();
+            // Lean left
+            pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += sway_lean;
+            pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= sway_lean;
+            // Arms gesture
+            pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] += arm_raise;
+            pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] -= arm_raise / 2;
+            // Head pan
+            pos[static_cast<int>(ServoChannel::HEAD_PAN)] += head_pan_amp;
+            // Ear movements for Sway Left
+            pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = ServoCalibration::get_home_pos(ServoChannel::LEFT_EAR_LIFT) - ear_lift_offset; // Back
+            pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = ServoCalibration::get_home_pos(ServoChannel::LEFT_EAR_SWING) + ear_swing_offset; // Out
+            pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = ServoCalibration::get_home_pos(ServoChannel::RIGHT_EAR_LIFT) + ear_lift_offset; // Forward
+            pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = ServoCalibration::get_home_pos(ServoChannel::RIGHT_EAR_SWING) - ear_swing_offset; // In
+            copy_positions(frame.positions, pos);
+        }
+
+        // Frame: Sway Right
+        if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+            auto& frame = kf_data.frames[kf_data.frame_count++];
+            frame.transition_time_ms = 400; // Faster
+            auto pos = create_home_pos();
+            // Lean right
+            pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= sway_lean;
+            pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += sway_lean;
+            // Arms gesture
+            pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] -= arm_raise / 2;
+            pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] += arm_raise;
+            // Head pan
+            pos[static_cast<int>(ServoChannel::HEAD_PAN)] -= head_pan_amp;
+            // Ear movements for Sway Right
+            pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = ServoCalibration::get_home_pos(ServoChannel::LEFT_EAR_LIFT) + ear_lift_offset; // Forward
+            pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = ServoCalibration::get_home_pos(ServoChannel::LEFT_EAR_SWING) - ear_swing_offset; // In
+            pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = ServoCalibration::get_home_pos(ServoChannel::RIGHT_EAR_LIFT) - ear_lift_offset; // Back
+            pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = ServoCalibration::get_home_pos(ServoChannel::RIGHT_EAR_SWING) + ear_swing_offset; // Out
+            copy_positions(frame.positions, pos);
+        }
+    }
+
+    // Frame: Return to Center
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 500; // Faster
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 10;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 10;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = ServoCalibration::get_home_pos(ServoChannel::LEFT_ARM_SWING) + arm_raise;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = ServoCalibration::get_home_pos(ServoChannel::RIGHT_ARM_SWING) + arm_raise;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame: Return to Home
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 600;
+        auto pos = create_home_pos();
+        copy_positions(frame.positions, pos);
+    }
+
+    return happy;
+}
+
+constexpr RegisteredAction make_look_around() {
+    RegisteredAction look_around = {};
+    copy_name(look_around.name, "look_around");
+    look_around.type = ActionType::KEYFRAME_SEQUENCE;
+    look_around.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    look_around.is_atomic = false;
+    look_around.default_steps = 1; // Play sequence only once
+    
+    auto& kf_data = look_around.data.keyframe;
+    kf_data.frame_count = 0;
+
+    // Frame 0: Head bottom-left, ears droop inwards
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 600; // Reduced for faster hand movement
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 75.0f; // Down
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 60.0f;  // Left
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f; // Forward
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 100.0f;
+        // Subtle ears
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 110.0f; // Back
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;  // In
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 80.0f;  // Back
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 115.0f; // In
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 1: Head mid, ears perk outwards
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 720; // Reduced for faster hand movement
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 70.0f; // Mid
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 90.0f;  // Mid
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 50.0f; // Backward
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 50.0f;
+        // Subtle ears
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 95.0f;   // Front
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 90.0f; // Out
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 100.0f;  // Front
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 80.0f;  // Out
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 2: Head top-right, ears droop outwards
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 660; // Reduced for faster hand movement
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 60.0f; // Up
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 115.0f;  // Right
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f; // Forward
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 100.0f;
+        // Subtle ears
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 110.0f; // Back
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 90.0f; // Out
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 80.0f;  // Back
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 80.0f;  // Out
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 3: Head mid, ears perk outwards (same as frame 1)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 720; // Reduced for faster hand movement
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 70.0f; // Mid
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 90.0f;  // Mid
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 50.0f; // Backward
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 50.0f;
+        // Subtle ears
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 95.0f;   // Front
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 90.0f; // Out
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 100.0f;  // Front
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 80.0f;  // Out
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 4: Head bottom-left, ears droop inwards (same as frame 0)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 600; // Reduced for faster hand movement
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 75.0f; // Down
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 60.0f;  // Left
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f; // Forward
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 100.0f;
+        // Subtle ears
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 110.0f; // Back
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;  // In
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 80.0f;  // Back
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 115.0f; // In
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 5: Return to home
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos();
+        copy_positions(frame.positions, pos);
+    }
+
+    return look_around;
+}
+
+constexpr RegisteredAction make_very_happy() {
+    RegisteredAction very_happy = {};
+    copy_name(very_happy.name, "very_happy"); // Replacing laughing
+    very_happy.type = ActionType::KEYFRAME_SEQUENCE;
+    very_happy.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    very_happy.is_atomic = false;
+    very_happy.default_steps = 1;
+    
+    auto& kf_data = very_happy.data.keyframe;
+    kf_data.frame_count = 0;
+
+    // --- Part 1: Symmetrical Dance ---
+
+    // Frame 0: Arms up, body crouch
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 800;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 130; // up
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 130; // up
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] = 100; // crouch
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] = 110; // crouch
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 95; // slightly forward
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 95; // slightly forward
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 75; // slightly in
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 110; // slightly in
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 1: Arms down, stand up
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 800;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 60; // down
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 60; // down
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] = 80; // stand
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] = 95; // stand
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 105; // slightly back
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 85; // slightly back
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 85; // slightly out
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 100; // slightly out
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 2: Arms in, body twist left
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 800;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 110; // in
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 110; // in
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] = 45;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] = 125;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 90; // forward
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 100; // forward
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 70; // in
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120; // in
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 3: Arms out, body twist right
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 800;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 30; // out
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 30; // out
+        pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] = 125;
+        pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] = 45;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 110; // back
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 80; // back
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 90; // out
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 90; // out
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 4: Transition to home
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000; // Slow transition to home
+        auto pos = create_home_pos();
+        copy_positions(frame.positions, pos);
+    }
+
+    // --- Part 2: Replace with walk_forward_kf logic (first 15 frames) ---
+    const int frame_time = 1200 / 16; 
+
+    // Generate and add frames from walk_forward_kf
+    for (int i = 0; i < 15; ++i) { // Add 15 frames to reach the 20-frame limit
+        if (kf_data.frame_count >= MAX_KEYFRAMES_PER_ACTION) break;
+
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = frame_time;
+        auto pos = create_home_pos();
+        float theta = (float)i * 2.0f * PI / 16.0f;
+
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 78.0f;
+        if (i < 8) { // First half of the cycle
+            theta = (float)i * 2.0f * PI / 16.0f;
+            pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] += 33.0f * sin(theta);
+            pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] += 33.0f * sin(theta);
+            pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] += 15.0f * cos(theta);
+            pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] += 15.0f * cos(theta);
+            pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] -= 50.0f * sin(theta);
+            pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] += 50.0f * sin(theta);
+        } else { // Second half of the cycle
+            theta = (float)(i-8) * 2.0f * PI / 16.0f;
+            pos[static_cast<int>(ServoChannel::LEFT_LEG_ROTATE)] -= 33.0f * sin(theta);
+            pos[static_cast<int>(ServoChannel::RIGHT_LEG_ROTATE)] -= 33.0f * sin(theta);
+            pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] -= 15.0f * cos(theta);
+            pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] -= 15.0f * cos(theta);
+            pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] += 50.0f * sin(theta);
+            pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] -= 50.0f * sin(theta);
+        }
+        copy_positions(frame.positions, pos);
+    }
+
+    return very_happy;
+}
+
+constexpr RegisteredAction make_angry_head() {
+    RegisteredAction angry_head = {};
+    copy_name(angry_head.name, "angry_head");
+    angry_head.type = ActionType::KEYFRAME_SEQUENCE;
+    angry_head.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    angry_head.is_atomic = true;
+    angry_head.default_steps = 1;
+    
+    auto& kf_data = angry_head.data.keyframe;
+    kf_data.frame_count = 0;
+
+    // Frame 0: Initial Pose - Head down, arms set (100ms)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 100;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 75.0f; // Look down (less pronounced)
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 70.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 50.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 1: Head moves left (500ms)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 500;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 75.0f; // Keep down
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 10.0f;  // Full left
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 70.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 50.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 2: Head holds (500ms)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 500;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 75.0f; // Keep down
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 10.0f;  // Hold left
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 70.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 50.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 3: "Roll eyes", Head lifts (200ms)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 200;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 60.0f; // Head lifts
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 27.5f;  // Halfway center
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 85.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 95.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 70.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 4: Return to bottom-left (200ms)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 200;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 75.0f; // Down
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 10.0f;  // Full left
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 70.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 50.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 5 & 6: Hold pose (1500ms total)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1500;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 75.0f; // Hold
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 10.0f;  // Hold
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 70.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 50.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 7: Return to Home (500ms)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 500;
+        auto pos = create_home_pos();
+        copy_positions(frame.positions, pos);
+    }
+
+    return angry_head;
+}
+
+constexpr RegisteredAction make_stomp_left_foot() {
+    RegisteredAction stomp_left_foot = {};
+    copy_name(stomp_left_foot.name, "stomp_left_foot");
+    stomp_left_foot.type = ActionType::GAIT_PERIODIC;
+    stomp_left_foot.data.gait.harmonic_count = 1;
+    stomp_left_foot.is_atomic = false;
+    stomp_left_foot.default_steps = 4; // Run for 4 cycles
+    stomp_left_foot.data.gait.gait_period_ms = 1000; // 1 second per stomp cycle
+    // Use offset to create a two-part motion within the sine wave
+    // Part 1: Lift and kick forward (controlled by offset and amplitude)
+    stomp_left_foot.data.gait.harmonic_terms[0].offset[static_cast<uint8_t>(ServoChannel::LEFT_ANKLE_LIFT)] = 92.5f - 100.0f; // Center of motion is 92.5, home is 100
+    stomp_left_foot.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_ANKLE_LIFT)] = 27.5f; // Goes from 65 to 120
+    // Part 2: Phase shift to make ANKLE_LIFT lead the ROTATE, creating a circular path
+    stomp_left_foot.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::LEFT_LEG_ROTATE)] = PI / 2;
+
+    return stomp_left_foot;
+}
+
+constexpr RegisteredGroup make_angry_group() {
+    RegisteredGroup angry_group = {};
+    copy_name(angry_group.name, "angry");
+    angry_group.mode = ExecutionMode::SIMULTANEOUS; // Stamp while shaking the head
+    angry_group.action_count = 2;
+    copy_name(angry_group.action_names[0], "angry_head");
+    copy_name(angry_group.action_names[1], "stomp_left_foot");
+    return angry_group;
+}
+
+constexpr RegisteredAction make_sudden_shock() {
+    RegisteredAction sudden_shock = {};
+    copy_name(sudden_shock.name, "sudden_shock");
+    sudden_shock.type = ActionType::KEYFRAME_SEQUENCE;
+    sudden_shock.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    sudden_shock.is_atomic = true; // This is a fast, atomic reaction
+    sudden_shock.default_steps = 1;
+    
+    auto& kf_data = sudden_shock.data.keyframe;
+    kf_data.frame_count = 0;
+
+    // Frame 0: The Jolt - Head up, Ears out
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 350;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] = 110.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 60.0f; // Head jerks up (less than before)
+        // Ears fly up and out
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 1: Ear Recoil - Ears snap in and down
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 350;
+        auto pos = create_home_pos();
+        // Body and head hold the jolted pose
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] = 110.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 65.0f;
+        // Ears snap in and down
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 2: The Freeze (holding the recoil pose)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000; // Shortened freeze
+        auto pos = create_home_pos();
+        // Hold the recoil pose from frame 1
+        pos[static_cast<int>(ServoChannel::LEFT_ANKLE_LIFT)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ANKLE_LIFT)] = 110.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_LIFT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 65.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 3: Slow Head Scan Left
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1400;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 100.0f;
+        // Keep shocked expression
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 65.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 4: Slow Head Scan Right
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1400;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 40.0f;
+        // Keep shocked expression
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 65.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 5: Full Return to Home
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos();
+        copy_positions(frame.positions, pos);
+    }
+
+    return sudden_shock;
+}
+
+constexpr RegisteredAction make_curious_ponder() {
+    RegisteredAction curious_ponder = {};
+    copy_name(curious_ponder.name, "curious_ponder");
+    curious_ponder.type = ActionType::KEYFRAME_SEQUENCE;
+    curious_ponder.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    curious_ponder.is_atomic = false;
+    curious_ponder.default_steps = 1;
+    
+    auto& kf_data = curious_ponder.data.keyframe;
+    kf_data.frame_count = 0;
+
+    // Frame 0: Slight nod down
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 500;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f; // Slightly down from home (70)
+        // Ears perk up slightly
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 95.0f; // Slightly forward from home (100)
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 95.0f; // Slightly forward from home (90)
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 1: Slow turn left
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f; // Keep looking slightly down
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 130.0f; // Turn left (Home 90, Left is higher)
+        // Ears orient towards the sound
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 95.0f; // Left ear out
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 80.0f; // Right ear slightly out
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 2: Hold and observe
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1500; // Hold for 1.5 seconds
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 130.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 95.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 80.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 3: Return to Home
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos(); // All servos return to calibrated home
+        copy_positions(frame.positions, pos);
+    }
+
+    return curious_ponder;
+}
+
+constexpr RegisteredAction make_sad() {
+    RegisteredAction sad = {};
+    copy_name(sad.name, "sad");
+    sad.type = ActionType::KEYFRAME_SEQUENCE;
+    sad.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    sad.is_atomic = false;
+    sad.default_steps = 1;
+    
+    auto& kf_data = sad.data.keyframe;
+    kf_data.frame_count = 0;
+
+    // Frame 0: Droop
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1500;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 1: Head Shake "No" Left
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 60.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 2: Head Shake "No" Right
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 120.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 3: Look down further
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_SWING)] = 60.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_SWING)] = 120.0f;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 80.0f;
+        pos[static_cast<int>(ServoChannel::RIGHT_ARM_SWING)] = 100.0f;
+        pos[static_cast<int>(ServoChannel::HEAD_PAN)] = 90.0f;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 4: Return to home
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 2000;
+        auto pos = create_home_pos();
+        copy_positions(frame.positions, pos);
+    }
+
+    return sad;
+}
+
+constexpr RegisteredAction make_tracking_L() {
+    RegisteredAction tracking_L = {};
+    copy_name(tracking_L.name, "tracking_L");
+    tracking_L.type = ActionType::GAIT_PERIODIC;
+    tracking_L.data.gait.harmonic_count = 1;
+    tracking_L.default_steps = 1;
+    tracking_L.is_atomic = false;
+    tracking_L.data.gait.gait_period_ms = 1500;
+    tracking_L.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_LEG_ROTATE)]  = 40;
+    tracking_L.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_LEG_ROTATE)] = -40;
+    tracking_L.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_ANKLE_LIFT)] = -30;
+    tracking_L.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_ANKLE_LIFT)] = 35;
+    tracking_L.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::LEFT_LEG_ROTATE)] = PI / 2 + PI;
+    tracking_L.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::RIGHT_LEG_ROTATE)] = PI;
+    tracking_L.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::LEFT_ANKLE_LIFT)] = PI;
+    tracking_L.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::RIGHT_ANKLE_LIFT)] = 2 * PI;
+    return tracking_L;
+}
+
+constexpr RegisteredAction make_tracking_R() {
+    RegisteredAction tracking_R = make_tracking_L();
+    copy_name(tracking_R.name, "tracking_R");
+    tracking_R.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_LEG_ROTATE)]  = -40;
+    tracking_R.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_LEG_ROTATE)] = 40;
+    tracking_R.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::LEFT_ANKLE_LIFT)] = 35;
+    tracking_R.data.gait.harmonic_terms[0].amplitude[static_cast<uint8_t>(ServoChannel::RIGHT_ANKLE_LIFT)] = -35;
+    tracking_R.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::LEFT_LEG_ROTATE)] = 0;
+    tracking_R.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::RIGHT_LEG_ROTATE)] = PI / 2;
+    tracking_R.data.gait.harmonic_terms[0].phase_diff[static_cast<uint8_t>(ServoChannel::RIGHT_ANKLE_LIFT)] = 0;
+    return tracking_R;
+}
+
+// Scope for wave_hello - V3, faster wave
+constexpr RegisteredAction make_wave_hello() {
+    RegisteredAction wave_hello = {};
+    copy_name(wave_hello.name, "wave_hello");
+    wave_hello.type = ActionType::KEYFRAME_SEQUENCE;
+    wave_hello.data.keyframe = KeyframeActionData{}; // Make the keyframe member active
+    wave_hello.is_atomic = false;
+    wave_hello.default_steps = 1;
+    
+    auto& kf_data = wave_hello.data.keyframe;
+    kf_data.frame_count = 0;
+
+    // Frame 1: Raise arm and tilt head up (1.0s)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 145;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 70;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 60;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 95;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 100;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 2: Wave In (0.2s)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 400; // FASTER
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 145;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 100;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 60;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 110;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 80;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 3: Wave Out (0.2s)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 400; // FASTER
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 145;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 70;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 60;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 110;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 80;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 4: Wave In (0.2s)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 400; // FASTER
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 145;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 100;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 60;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 95;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 100;
+        copy_positions(frame.positions, pos);
+    }
+    
+    // Frame 5: Wave Out (0.2s)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 400; // FASTER
+        auto pos = create_home_pos();
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_SWING)] = 145;
+        pos[static_cast<int>(ServoChannel::LEFT_ARM_LIFT)] = 70;
+        pos[static_cast<int>(ServoChannel::HEAD_TILT)] = 60;
+        pos[static_cast<int>(ServoChannel::LEFT_EAR_LIFT)] = 95;
+        pos[static_cast<int>(ServoChannel::RIGHT_EAR_LIFT)] = 100;
+        copy_positions(frame.positions, pos);
+    }
+
+    // Frame 6: Lower arm (1.0s)
+    if (kf_data.frame_count < MAX_KEYFRAMES_PER_ACTION) {
+        auto& frame = kf_data.frames[kf_data.frame_count++];
+        frame.transition_time_ms = 1000;
+        auto pos = create_home_pos(); // Return all to home
+        copy_positions(frame.positions, pos);
+    }
+
+    return wave_hello;
+}
+
+// Evaluated at compile time; the tables are placed in flash.
+constexpr RegisteredAction s_actions[] = {
+    make_walk_forward_kf(),
+    make_forward(),
+    make_backward(),
+    make_turn_left_kf(),
+    make_turn_right_kf(),
+    make_wiggle_ears(),
+    make_wave_hand(),
+    make_nod_head(),
+    make_shake_head(),
+    make_walk_backward_kf(),
+    make_silly(),
+    make_funny(),
+    make_happy(),
+    make_look_around(),
+    make_very_happy(),
+    make_angry_head(),
+    make_stomp_left_foot(),
+    make_sudden_shock(),
+    make_curious_ponder(),
+    make_sad(),
+    make_tracking_L(),
+    make_tracking_R(),
+    make_wave_hello(),
+};
+
+constexpr RegisteredGroup s_groups[] = {
+    make_angry_group(),
+};
+
+bool names_equal(const char* a, const char* b) {
+    return strncmp(a, b, MOTION_NAME_MAX_LEN) == 0;
+}
+
+} // namespace
+
+std::span<const RegisteredAction> actions() {
+    return s_actions;
+}
+
+std::span<const RegisteredGroup> groups() {
+    return s_groups;
+}
+
+const RegisteredAction* find_action(const char* name) {
+    for (const auto& action : s_actions) {
+        if (names_equal(action.name, name)) {
+            return &action;
+        }
+    }
+    return nullptr;
+}
+
+const RegisteredGroup* find_group(const char* name) {
+    for (const auto& group : s_groups) {
+        if (names_equal(group.name, name)) {
+            return &group;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace DefaultActions
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "motion_manager/Motion_types.hpp"
+#include <span>
+
+// Built-in action library. Every action and group is evaluated by the
+// compiler into const tables that live in flash (.rodata), so nothing is
+// constructed or copied at boot and lookups return pointers into flash.
+namespace DefaultActions {
+
+std::span<const RegisteredAction> actions();
+std::span<const RegisteredGroup> groups();
+
+// nullptr if there is no built-in entry with this name.
+const RegisteredAction* find_action(const char* name);
+const RegisteredGroup* find_group(const char* name);
+
+} // namespace DefaultActions
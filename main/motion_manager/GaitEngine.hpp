@@ -0,0 +1,217 @@
+#pragma once
+
+#include "motion_manager/Motion_types.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+// Evaluation of GAIT_PERIODIC actions for the mixer. All harmonics of all
+// joints are driven from one shared phase per action and tick. Running
+// instances use a per-instance phasor (advance()); evaluate_harmonics() is the
+// stateless path, with sines from a table in flash instead of sin() calls.
+namespace GaitEngine {
+
+// Phases are unsigned 32-bit fractions of a turn (2^32 is one cycle), so the
+// k-th harmonic is a plain multiply and every sum wraps for free.
+typedef uint32_t Phase;
+
+constexpr int SINE_TABLE_BITS = 10;
+constexpr int SINE_TABLE_SIZE = 1 << SINE_TABLE_BITS;
+constexpr int SINE_FRACTION_BITS = 32 - SINE_TABLE_BITS;
+constexpr float AMPLITUDE_EPSILON = 0.01f; // Smaller amplitudes leave the joint free for other actions
+constexpr float INV_TWO_PI = 0.15915494309189535f;
+
+namespace detail {
+
+// Odd Taylor series, accurate to ~1e-12 on [-pi/2, pi/2] where it is used.
+constexpr double taylor_sin(double x) {
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 12; ++n) {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr std::array<float, SINE_TABLE_SIZE + 1> make_sine_table() {
+    constexpr double pi = 3.14159265358979323846;
+    std::array<float, SINE_TABLE_SIZE + 1> table = {};
+    for (int i = 0; i <= SINE_TABLE_SIZE; ++i) {
+        double x = 2.0 * pi * i / SINE_TABLE_SIZE; // [0, 2*pi]
+        if (x > 1.5 * pi) x -= 2.0 * pi;           // [-pi/2, 1.5*pi]
+        else if (x > 0.5 * pi) x = pi - x;         // sin(pi - x) = sin(x)
+        table[i] = static_cast<float>(taylor_sin(x));
+    }
+    return table;
+}
+
+} // namespace detail
+
+// One full cycle plus a guard entry for interpolation, built by the compiler.
+inline constexpr std::array<float, SINE_TABLE_SIZE + 1> SINE_TABLE = detail::make_sine_table();
+
+// Linearly interpolated table sine; worst-case error is about 5e-6.
+inline float sin_phase(Phase phase) {
+    uint32_t index = phase >> SINE_FRACTION_BITS;
+    float frac = static_cast<float>(phase & ((1u << SINE_FRACTION_BITS) - 1)) * (1.0f / (1u << SINE_FRACTION_BITS));
+    float a = SINE_TABLE[index];
+    return a + (SINE_TABLE[index + 1] - a) * frac;
+}
+
+// Any real number of turns, wrapped into one cycle.
+inline Phase phase_from_turns(float turns) {
+    return static_cast<Phase>(static_cast<int64_t>(turns * 4294967296.0f));
+}
+
+inline float apply_easing(float t_linear, EasingType type) {
+    switch (type) {
+        case EasingType::EASE_IN_QUAD:
+            return t_linear * t_linear;
+        case EasingType::EASE_OUT_QUAD:
+            return 1.0f - (1.0f - t_linear) * (1.0f - t_linear);
+        case EasingType::EASE_IN_OUT_QUAD:
+            return t_linear < 0.5f ? 2.0f * t_linear * t_linear
+                                   : 1.0f - 2.0f * (1.0f - t_linear) * (1.0f - t_linear);
+        case EasingType::LINEAR:
+        default:
+            return t_linear;
+    }
+}
+
+// Fills wave[i] with the harmonic sum of joint i at cycle position t in [0, 1),
+// offsets excluded. Returns a bit mask of the joints with any non-negligible
+// amplitude; the other joints get 0.
+inline uint32_t evaluate_harmonics(const GaitActionData& gait, float t, float (&wave)[GAIT_JOINT_COUNT]) {
+    static_assert(GAIT_JOINT_COUNT <= 32, "Joint mask is 32-bit");
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        wave[i] = 0.0f;
+    }
+
+    const Phase base = phase_from_turns(apply_easing(t, gait.easing_type));
+    const int count = gait.harmonic_count < MAX_GAIT_HARMONICS ? gait.harmonic_count : MAX_GAIT_HARMONICS;
+    uint32_t driven = 0;
+    for (int h = 0; h < count; ++h) {
+        const motion_params_t& term = gait.harmonic_terms[h];
+        const Phase harmonic_phase = base * static_cast<Phase>(h + 1);
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            const float amp = term.amplitude[i];
+            if (std::fabs(amp) <= AMPLITUDE_EPSILON) continue;
+            wave[i] += amp * sin_phase(harmonic_phase + phase_from_turns(term.phase_diff[i] * INV_TWO_PI));
+            driven |= 1u << i;
+        }
+    }
+    return driven;
+}
+
+// --- Phasor oscillator (GaitOscillator) ---
+// Linear-eased gaits run on the instance's phasor: one complex multiply per
+// tick plus one per extra harmonic, then two multiply-adds per term and joint.
+// The phasor is set exactly from the clock on start, at every cycle boundary,
+// and whenever a tick does not land one tick length after the previous one
+// (overrun, rate change), so rounding never accumulates past one cycle.
+
+constexpr uint16_t NORMALIZE_INTERVAL = 64; // Ticks between magnitude corrections
+
+// Folds the joint phase offsets of every term into sin/cos weights. Call again
+// after the template is edited; the next advance() resynchronizes the phasor.
+inline void load_terms(GaitOscillator& osc, const GaitActionData& gait) {
+    osc.harmonic_count = gait.harmonic_count < MAX_GAIT_HARMONICS ? gait.harmonic_count : MAX_GAIT_HARMONICS;
+    osc.driven_mask = 0;
+    for (int h = 0; h < MAX_GAIT_HARMONICS; ++h) {
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            float amp = h < osc.harmonic_count ? gait.harmonic_terms[h].amplitude[i] : 0.0f;
+            if (std::fabs(amp) <= AMPLITUDE_EPSILON) {
+                osc.sin_weight[h][i] = 0.0f;
+                osc.cos_weight[h][i] = 0.0f;
+                continue;
+            }
+            float phase = gait.harmonic_terms[h].phase_diff[i];
+            osc.sin_weight[h][i] = amp * std::cos(phase);
+            osc.cos_weight[h][i] = amp * std::sin(phase);
+            osc.driven_mask |= 1u << i;
+        }
+    }
+    osc.step_us = 0;
+}
+
+inline void start_oscillator(GaitOscillator& osc, const GaitActionData& gait, int64_t now_us) {
+    load_terms(osc, gait);
+    osc.cycle_start_us = now_us;
+    osc.phase_time_us = now_us;
+}
+
+namespace detail {
+
+inline void sync_phasor(GaitOscillator& osc, int64_t period_us, uint32_t tick_us) {
+    constexpr float two_pi = 6.28318530717958648f;
+    float theta = two_pi * static_cast<float>(osc.phase_time_us - osc.cycle_start_us) / static_cast<float>(period_us);
+    osc.re = std::cos(theta);
+    osc.im = std::sin(theta);
+    if (osc.step_us != tick_us) {
+        float step = two_pi * static_cast<float>(tick_us) / static_cast<float>(period_us);
+        osc.step_re = std::cos(step);
+        osc.step_im = std::sin(step);
+        osc.step_us = tick_us;
+    }
+    osc.steps_since_normalize = 0;
+}
+
+} // namespace detail
+
+// Moves the oscillator to the tick at now_us and fills wave[] like
+// evaluate_harmonics(). tick_us is the mixer period the tick belongs to.
+inline uint32_t advance(GaitOscillator& osc, const GaitActionData& gait, int64_t now_us, uint32_t tick_us,
+                        float (&wave)[GAIT_JOINT_COUNT]) {
+    const int64_t period_us = static_cast<int64_t>(gait.gait_period_ms) * 1000;
+
+    // Stay on the nominal tick grid while ticks arrive on time; a wake-up a
+    // little early or late still counts as the next tick.
+    const int64_t next_us = osc.phase_time_us + tick_us;
+    const int64_t drift_us = now_us - next_us;
+    bool resync = osc.step_us != tick_us || drift_us > tick_us / 2 || drift_us < -static_cast<int64_t>(tick_us / 2);
+    osc.phase_time_us = resync ? now_us : next_us;
+    if (osc.phase_time_us - osc.cycle_start_us >= period_us) {
+        osc.cycle_start_us += (osc.phase_time_us - osc.cycle_start_us) / period_us * period_us;
+        resync = true;
+    }
+
+    if (gait.easing_type != EasingType::LINEAR) {
+        // A warped cycle position is not a uniform rotation: use the table.
+        float t = static_cast<float>(osc.phase_time_us - osc.cycle_start_us) / static_cast<float>(period_us);
+        return evaluate_harmonics(gait, t, wave);
+    }
+
+    if (resync) {
+        detail::sync_phasor(osc, period_us, tick_us);
+    } else {
+        float re = osc.re * osc.step_re - osc.im * osc.step_im;
+        float im = osc.re * osc.step_im + osc.im * osc.step_re;
+        if (++osc.steps_since_normalize >= NORMALIZE_INTERVAL) {
+            float gain = 1.5f - 0.5f * (re * re + im * im); // One Newton step towards |z| = 1
+            re *= gain;
+            im *= gain;
+            osc.steps_since_normalize = 0;
+        }
+        osc.re = re;
+        osc.im = im;
+    }
+
+    // sin(k*theta + P) = sin(k*theta) * cos(P) + cos(k*theta) * sin(P)
+    float s = osc.im;
+    float c = osc.re;
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        wave[i] = s * osc.sin_weight[0][i] + c * osc.cos_weight[0][i];
+    }
+    for (int h = 1; h < osc.harmonic_count; ++h) {
+        float next_c = c * osc.re - s * osc.im;
+        s = s * osc.re + c * osc.im;
+        c = next_c;
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            wave[i] += s * osc.sin_weight[h][i] + c * osc.cos_weight[h][i];
+        }
+    }
+    return osc.driven_mask;
+}
+
+} // namespace GaitEngine
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// Face tracking works on bearings: the angle of the face from the body, in
+// the head's pan/tilt offset frame. A face report gives the bearing as the
+// head offset at capture time plus the face's distance from the image centre.
+// An alpha-beta filter per axis smooths the bearings and estimates their rate,
+// and the mixer points the head at the bearing extrapolated to the time the
+// servos will get there.
+namespace HeadTrack {
+
+constexpr int FRAME_CENTER_X = 640 / 2;
+constexpr int FRAME_CENTER_Y = 480 / 2;
+constexpr float DEG_PER_PIXEL = 0.1f;             // About a 64 deg horizontal field of view
+constexpr int64_t CAPTURE_LATENCY_US = 60000;     // Camera capture to UART receipt, estimated
+constexpr int64_t ACTUATION_LEAD_US = 40000;      // Mixer command to servo position: PWM frame and head output filter
+constexpr int64_t PREDICTION_HORIZON_US = 200000; // Longest extrapolation past the last report
+constexpr float MAX_RATE_DPS = 120.0f;            // Fastest face motion the prediction follows
+constexpr float PAN_LIMIT = 70.0f;
+constexpr float TILT_LIMIT = 40.0f;
+constexpr float TRACKING_TURN_DEG = 40.0f;        // Pan bearing change of a tracking_L/R body turn
+
+// One axis of bearing and rate, updated at each face report.
+class AlphaBetaFilter {
+public:
+    static constexpr float ALPHA = 0.6f;
+    static constexpr float BETA = 0.15f;
+
+    void reset(float value) {
+        m_value = value;
+        m_rate = 0.0f;
+    }
+
+    // Takes a measurement dt seconds after the previous one.
+    void update(float measured, float dt) {
+        const float predicted = m_value + m_rate * dt;
+        const float residual = measured - predicted;
+        m_value = predicted + ALPHA * residual;
+        m_rate = std::clamp(m_rate + BETA * residual / dt, -MAX_RATE_DPS, MAX_RATE_DPS);
+    }
+
+    // Moves the estimate without touching the rate, e.g. when the body turns.
+    void shift(float delta) { m_value += delta; }
+
+    float value() const { return m_value; }
+    float rate() const { return m_rate; }
+
+private:
+    float m_value = 0.0f; // Degrees
+    float m_rate = 0.0f;  // Degrees per second
+};
+
+// Head offsets as a function of time, published by the face tracker at each
+// report and evaluated by the mixer at every tick.
+struct Prediction {
+    float pan;       // Degrees at time_us
+    float tilt;
+    float pan_rate;  // Degrees per second
+    float tilt_rate;
+    int64_t time_us;
+
+    void evaluate(int64_t at_us, float& pan_out, float& tilt_out) const {
+        const float dt = static_cast<float>(std::clamp(at_us - time_us, int64_t(0), PREDICTION_HORIZON_US)) * 1e-6f;
+        pan_out = std::clamp(pan + pan_rate * dt, -PAN_LIMIT, PAN_LIMIT);
+        tilt_out = std::clamp(tilt + tilt_rate * dt, -TILT_LIMIT, TILT_LIMIT);
+    }
+};
+
+} // namespace HeadTrack
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Fixed-capacity, in-place array with vector-style iteration. Storage lives
+// inside the object, so acquiring and releasing slots never touches the heap.
+// Element order is preserved by erase(), which matters to the mixer because
+// layers of equal priority are blended in start order.
+template <typename T, size_t Capacity>
+class InstancePool {
+    static_assert(std::is_trivially_copyable<T>::value, "InstancePool holds plain data only");
+    static_assert(Capacity <= UINT8_MAX, "InstancePool count is 8-bit");
+
+public:
+    // Returns a zeroed slot at the end, or nullptr when the pool is full.
+    T* acquire() {
+        if (m_count >= Capacity) {
+            return nullptr;
+        }
+        T* slot = &m_items[m_count++];
+        *slot = T{};
+        return slot;
+    }
+
+    // Drops [first, last); the tail is shifted down to keep order.
+    void erase(T* first, T* last) {
+        T* out = first;
+        for (T* in = last; in != end(); ++in) {
+            *out++ = *in;
+        }
+        m_count = static_cast<uint8_t>(out - m_items);
+    }
+
+    void clear() { m_count = 0; }
+
+    T* begin() { return m_items; }
+    T* end() { return m_items + m_count; }
+    const T* begin() const { return m_items; }
+    const T* end() const { return m_items + m_count; }
+    size_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+    bool full() const { return m_count >= Capacity; }
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    T m_items[Capacity];
+    uint8_t m_count = 0;
+};
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "motion_manager/Motion_types.hpp"
+#include "motion_manager/ServoCalibration.hpp"
+#include <cmath>
+
+// Low-pass filters for all joints, one lane per joint. Every lane is a
+// transposed direct form II biquad; a first-order filter is a biquad with
+// b2 = a2 = 0 and a bypassed joint has b0 = 1, so process() is one
+// branch-free loop over plain float arrays that the compiler vectorizes.
+// Coefficients are designed for a sample rate and redesigned when it
+// changes; all filters have unity gain at DC.
+class JointFilterBank {
+public:
+    JointFilterBank() {
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            m_design[i] = ServoCalibration::output_filters[i];
+            m_output[i] = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
+        }
+        set_sample_rate(50.0f);
+    }
+
+    // Redesigns every lane for sample_hz. The outputs carry on from where
+    // they are.
+    void set_sample_rate(float sample_hz) {
+        if (sample_hz == m_sample_hz) return;
+        m_sample_hz = sample_hz;
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            design(i);
+        }
+    }
+
+    void set_filter(int joint, const ServoCalibration::OutputFilter& filter) {
+        m_design[joint] = filter;
+        design(joint);
+    }
+
+    // Puts a joint at rest at value.
+    void reset(int joint, float value) {
+        m_output[joint] = value;
+        settle(joint);
+    }
+
+    // Filters one sample of every joint in place.
+    void process(float* angles) {
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            const float x = angles[i];
+            const float y = m_b0[i] * x + m_z1[i];
+            m_z1[i] = m_b1[i] * x - m_a1[i] * y + m_z2[i];
+            m_z2[i] = m_b2[i] * x - m_a2[i] * y;
+            m_output[i] = y;
+            angles[i] = y;
+        }
+    }
+
+private:
+    void design(int joint) {
+        const ServoCalibration::OutputFilter& filter = m_design[joint];
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+        // Keep the cutoff below Nyquist whatever the mixer rate
+        const float cutoff_hz = std::fmin(filter.cutoff_hz, 0.45f * m_sample_hz);
+        const float w0 = 2.0f * static_cast<float>(M_PI) * cutoff_hz / m_sample_hz;
+        if (filter.order == ServoCalibration::FilterOrder::FIRST && cutoff_hz > 0.0f) {
+            // y += k (x - y)
+            const float k = 1.0f - std::exp(-w0);
+            b0 = k;
+            a1 = k - 1.0f;
+        } else if (filter.order == ServoCalibration::FilterOrder::SECOND && cutoff_hz > 0.0f && filter.q > 0.0f) {
+            // Bilinear-transform low-pass (RBJ cookbook), normalized by a0
+            const float cos_w0 = std::cos(w0);
+            const float alpha = std::sin(w0) / (2.0f * filter.q);
+            const float inv_a0 = 1.0f / (1.0f + alpha);
+            b0 = 0.5f * (1.0f - cos_w0) * inv_a0;
+            b1 = (1.0f - cos_w0) * inv_a0;
+            b2 = b0;
+            a1 = -2.0f * cos_w0 * inv_a0;
+            a2 = (1.0f - alpha) * inv_a0;
+        }
+        m_b0[joint] = b0;
+        m_b1[joint] = b1;
+        m_b2[joint] = b2;
+        m_a1[joint] = a1;
+        m_a2[joint] = a2;
+        settle(joint);
+    }
+
+    // State of a lane whose input and output have both been m_output for ever.
+    void settle(int joint) {
+        const float v = m_output[joint];
+        m_z2[joint] = (m_b2[joint] - m_a2[joint]) * v;
+        m_z1[joint] = (m_b1[joint] - m_a1[joint]) * v + m_z2[joint];
+    }
+
+    ServoCalibration::OutputFilter m_design[GAIT_JOINT_COUNT];
+    float m_sample_hz = 0.0f;
+    float m_b0[GAIT_JOINT_COUNT];
+    float m_b1[GAIT_JOINT_COUNT];
+    float m_b2[GAIT_JOINT_COUNT];
+    float m_a1[GAIT_JOINT_COUNT];
+    float m_a2[GAIT_JOINT_COUNT];
+    float m_z1[GAIT_JOINT_COUNT];
+    float m_z2[GAIT_JOINT_COUNT];
+    float m_output[GAIT_JOINT_COUNT]; // Last output, for redesigning without a jump
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "motion_manager/Motion_types.hpp"
+#include "motion_manager/ServoCalibration.hpp"
+#include <cstdint>
+
+// CATMULL_ROM keyframe sequences. The frames are knots of a cyclic,
+// non-uniform Catmull-Rom spline: the velocity at frame j is the slope between
+// its neighbours over the time separating them, so it is the same on both
+// sides of the frame. build_spline() turns each transition into a cubic Hermite
+// segment once, at load; the mixer then costs three multiply-adds per joint.
+namespace KeyframeEngine {
+
+constexpr float MIN_TRANSITION_MS = 1.0f; // Zero-length transitions are treated as 1 ms
+
+namespace detail {
+
+inline float transition_ms(const KeyframeActionData& data, int frame) {
+    float ms = static_cast<float>(data.frames[frame].transition_time_ms);
+    return ms < MIN_TRANSITION_MS ? MIN_TRANSITION_MS : ms;
+}
+
+// Hermite segment from p0 to p1 with end slopes m0, m1 in degrees per unit u.
+inline void set_segment(SplineSegment& seg, int joint, float p0, float p1, float m0, float m1) {
+    seg.a[joint] = 2.0f * p0 - 2.0f * p1 + m0 + m1;
+    seg.b[joint] = -3.0f * p0 + 3.0f * p1 - 2.0f * m0 - m1;
+    seg.c[joint] = m0;
+    seg.d[joint] = p0;
+}
+
+} // namespace detail
+
+// Precomputes every segment of a keyframe action. The entry segments start
+// from the calibrated home pose, where start_action_instance() begins.
+inline void build_spline(const KeyframeActionData& data, KeyframeSpline& out) {
+    const int n = data.frame_count < MAX_KEYFRAMES_PER_ACTION ? data.frame_count : MAX_KEYFRAMES_PER_ACTION;
+    out.frame_count = static_cast<uint8_t>(n);
+    if (n == 0) return;
+
+    // Segment j runs from frame j-1 to frame j over frame j's transition time;
+    // segment 0 closes the loop from the last frame.
+    float duration[MAX_KEYFRAMES_PER_ACTION];
+    for (int j = 0; j < n; ++j) {
+        duration[j] = detail::transition_ms(data, j);
+    }
+
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        // Velocity at each frame in degrees per ms
+        float velocity[MAX_KEYFRAMES_PER_ACTION];
+        for (int j = 0; j < n; ++j) {
+            const int prev = (j + n - 1) % n;
+            const int next = (j + 1) % n;
+            velocity[j] = (data.frames[next].positions[i] - data.frames[prev].positions[i]) /
+                          (duration[j] + duration[next]);
+        }
+
+        for (int j = 0; j < n; ++j) {
+            const int prev = (j + n - 1) % n;
+            detail::set_segment(out.segments[j], i, data.frames[prev].positions[i], data.frames[j].positions[i],
+                                velocity[prev] * duration[j], velocity[j] * duration[j]);
+        }
+
+        const float home = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
+        const float first = data.frames[0].positions[i];
+        detail::set_segment(out.segments[SPLINE_SEGMENT_ENTRY], i, home, first, 0.0f, velocity[0] * duration[0]);
+        detail::set_segment(out.segments[SPLINE_SEGMENT_ENTRY_EXIT], i, home, first, 0.0f, 0.0f);
+
+        const int last = n - 1;
+        const int before_last = (n + last - 1) % n;
+        detail::set_segment(out.segments[SPLINE_SEGMENT_EXIT], i, data.frames[before_last].positions[i],
+                            data.frames[last].positions[i], velocity[before_last] * duration[last], 0.0f);
+    }
+}
+
+// Segment for the transition into frame `index`. The first transition of an
+// instance starts from rest at home, and the last one of its final repetition
+// comes to rest on the last frame.
+inline uint8_t select_segment(const KeyframeSpline& spline, uint8_t index, bool looped, uint32_t remaining_steps) {
+    const bool first = !looped && index == 0;
+    const bool last = remaining_steps == 1 && index + 1 == spline.frame_count;
+    if (first && last) return SPLINE_SEGMENT_ENTRY_EXIT;
+    if (first) return SPLINE_SEGMENT_ENTRY;
+    if (last) return SPLINE_SEGMENT_EXIT;
+    return index;
+}
+
+// Weight of a start pose other than home over an entry segment: the Hermite
+// basis that is 1 at u = 0 and 0 at u = 1 with zero slope at both ends, so
+// the offset fades out without moving the segment's end or its end velocities.
+inline float entry_offset_weight(float u) {
+    return (2.0f * u - 3.0f) * u * u + 1.0f;
+}
+
+// Position of joint i at normalized transition time u in [0, 1].
+inline float evaluate(const SplineSegment& seg, int i, float u) {
+    return ((seg.a[i] * u + seg.b[i]) * u + seg.c[i]) * u + seg.d[i];
+}
+
+} // namespace KeyframeEngine
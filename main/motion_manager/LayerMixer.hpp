@@ -0,0 +1,80 @@
+#pragma once
+
+#include "motion_manager/Motion_types.hpp"
+#include "motion_manager/ServoCalibration.hpp"
+#include <array>
+#include <cstdint>
+
+// Weighted blending of action layers for the mixer. Every quantity is a
+// plain float array indexed by joint, so each blend step is one branch-free
+// loop over the joints that the compiler can keep in registers or vectorize.
+namespace LayerMixer {
+
+namespace detail {
+
+constexpr std::array<float, GAIT_JOINT_COUNT> make_home_pose() {
+    std::array<float, GAIT_JOINT_COUNT> pose = {};
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        pose[i] = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
+    }
+    return pose;
+}
+
+} // namespace detail
+
+inline constexpr std::array<float, GAIT_JOINT_COUNT> HOME_POSE = detail::make_home_pose();
+
+// Accumulated pose of the layers blended so far. Joints no layer touched
+// keep the home pose in angle[] but are left out of touched.
+typedef struct {
+    float angle[GAIT_JOINT_COUNT];
+    uint32_t touched;
+} Buffer;
+
+inline void begin(Buffer& mix) {
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        mix.angle[i] = HOME_POSE[i];
+    }
+    mix.touched = 0;
+}
+
+// Blends one layer's absolute joint angles into mix. Only joints in mask are
+// affected; weight is the layer weight with any fade already applied.
+inline void blend(Buffer& mix, const float (&angles)[GAIT_JOINT_COUNT], uint32_t mask, LayerBlend mode, float weight) {
+    if (mask == 0 || weight <= 0.0f) return;
+    if (weight > 1.0f) weight = 1.0f;
+
+    float w[GAIT_JOINT_COUNT];
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        w[i] = (mask >> i) & 1u ? weight : 0.0f;
+    }
+    if (mode == LayerBlend::ADDITIVE) {
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            mix.angle[i] += w[i] * (angles[i] - HOME_POSE[i]);
+        }
+    } else {
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            mix.angle[i] += w[i] * (angles[i] - mix.angle[i]);
+        }
+    }
+    mix.touched |= mask;
+}
+
+// Layer weight of a running instance at now_us, fades included.
+inline float instance_weight(const ActionInstance& instance, int64_t now_us) {
+    const ActionLayer& layer = instance.layer;
+    float weight = layer.weight;
+    if (layer.fade_in_ms > 0) {
+        float t = static_cast<float>(now_us - instance.start_time_us) / (layer.fade_in_ms * 1000.0f);
+        if (t < 1.0f) weight *= t > 0.0f ? t : 0.0f;
+    }
+    if (instance.fading_out) {
+        float t = layer.fade_out_ms > 0
+                      ? static_cast<float>(now_us - instance.fade_out_start_us) / (layer.fade_out_ms * 1000.0f)
+                      : 1.0f;
+        weight *= t < 1.0f ? 1.0f - t : 0.0f;
+    }
+    return weight;
+}
+
+} // namespace LayerMixer
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Selectable motion mixer rates. The value is the tick rate in Hz.
+enum class MixerRate : uint16_t {
+    HZ_50 = 50,
+    HZ_100 = 100,
+    HZ_200 = 200
+};
+
+inline uint32_t mixer_period_us(MixerRate rate) {
+    return 1000000u / static_cast<uint32_t>(rate);
+}
+
+// Upper bounds (inclusive, in us) of the histogram buckets; the last bucket is open-ended.
+constexpr uint32_t MIXER_HIST_BOUNDS_US[] = {50, 100, 250, 500, 1000, 2000, 5000, 10000};
+constexpr int MIXER_HIST_BUCKETS = sizeof(MIXER_HIST_BOUNDS_US) / sizeof(MIXER_HIST_BOUNDS_US[0]) + 1;
+
+// Snapshot of mixer clock health, see MixerTimingRecorder.
+typedef struct {
+    uint32_t period_us;                       // Current tick period
+    uint32_t ticks;                           // Ticks recorded since the last reset
+    uint32_t overruns;                        // Ticks that started after their deadline had already passed
+    uint32_t max_jitter_us;                   // Worst |wake time - deadline|
+    uint32_t max_compute_us;                  // Worst wake-to-output time
+    uint32_t jitter_hist[MIXER_HIST_BUCKETS];  // Wake-up jitter distribution
+    uint32_t compute_hist[MIXER_HIST_BUCKETS]; // Compute time distribution
+} MixerTimingStats;
+
+// Lock-free recorder written by the mixer task once per tick and readable
+// from any task. Counters are individually atomic; a snapshot taken while
+// the mixer is running may straddle one tick, which is fine for diagnostics.
+class MixerTimingRecorder {
+public:
+    void record(uint32_t jitter_us, uint32_t compute_us, bool overrun) {
+        m_ticks.fetch_add(1, std::memory_order_relaxed);
+        if (overrun) {
+            m_overruns.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_jitter_hist[bucket(jitter_us)].fetch_add(1, std::memory_order_relaxed);
+        m_compute_hist[bucket(compute_us)].fetch_add(1, std::memory_order_relaxed);
+        if (jitter_us > m_max_jitter_us.load(std::memory_order_relaxed)) {
+            m_max_jitter_us.store(jitter_us, std::memory_order_relaxed);
+        }
+        if (compute_us > m_max_compute_us.load(std::memory_order_relaxed)) {
+            m_max_compute_us.store(compute_us, std::memory_order_relaxed);
+        }
+    }
+
+    void set_period_us(uint32_t period_us) { m_period_us.store(period_us, std::memory_order_relaxed); }
+
+    MixerTimingStats snapshot() const {
+        MixerTimingStats stats = {};
+        stats.period_us = m_period_us.load(std::memory_order_relaxed);
+        stats.ticks = m_ticks.load(std::memory_order_relaxed);
+        stats.overruns = m_overruns.load(std::memory_order_relaxed);
+        stats.max_jitter_us = m_max_jitter_us.load(std::memory_order_relaxed);
+        stats.max_compute_us = m_max_compute_us.load(std::memory_order_relaxed);
+        for (int i = 0; i < MIXER_HIST_BUCKETS; ++i) {
+            stats.jitter_hist[i] = m_jitter_hist[i].load(std::memory_order_relaxed);
+            stats.compute_hist[i] = m_compute_hist[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    void reset() {
+        m_ticks.store(0, std::memory_order_relaxed);
+        m_overruns.store(0, std::memory_order_relaxed);
+        m_max_jitter_us.store(0, std::memory_order_relaxed);
+        m_max_compute_us.store(0, std::memory_order_relaxed);
+        for (int i = 0; i < MIXER_HIST_BUCKETS; ++i) {
+            m_jitter_hist[i].store(0, std::memory_order_relaxed);
+            m_compute_hist[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static int bucket(uint32_t value_us) {
+        for (int i = 0; i < MIXER_HIST_BUCKETS - 1; ++i) {
+            if (value_us <= MIXER_HIST_BOUNDS_US[i]) return i;
+        }
+        return MIXER_HIST_BUCKETS - 1;
+    }
+
+private:
+    std::atomic<uint32_t> m_period_us{0};
+    std::atomic<uint32_t> m_ticks{0};
+    std::atomic<uint32_t> m_overruns{0};
+    std::atomic<uint32_t> m_max_jitter_us{0};
+    std::atomic<uint32_t> m_max_compute_us{0};
+    std::atomic<uint32_t> m_jitter_hist[MIXER_HIST_BUCKETS] = {};
+    std::atomic<uint32_t> m_compute_hist[MIXER_HIST_BUCKETS] = {};
+};
+
+// Stages of one motion executor tick, in the order they run.
+enum class MotionStage : uint8_t {
+    TRACKING, // Face reports into the head prediction
+    BEHAVIOR, // DecisionMaker events into commands
+    DISPATCH, // Commands into staged action edits
+    MIXER,    // Actions into servo output
+    COUNT
+};
+constexpr int MOTION_STAGE_COUNT = static_cast<int>(MotionStage::COUNT);
+
+// Per-tick compute budget of each stage. BEHAVIOR and DISPATCH stop taking
+// work once over budget and leave the rest queued for the next tick; the
+// other stages always finish and only count the overrun. The MIXER stage
+// also writes the servo frame, so its budget is this plus the driver's
+// frame time (Servo::frame_time_us()), set by MotionController::init().
+constexpr uint32_t MOTION_STAGE_BUDGET_US[MOTION_STAGE_COUNT] = {250, 250, 1000, 3000};
+
+typedef struct {
+    uint32_t budget_us[MOTION_STAGE_COUNT];   // Budget of each stage
+    uint32_t max_us[MOTION_STAGE_COUNT];      // Worst time of each stage
+    uint32_t over_budget[MOTION_STAGE_COUNT]; // Ticks the stage went over its budget
+} StageTimingStats;
+
+// Written by the executor once per stage and tick, readable from any task.
+class StageTimingRecorder {
+public:
+    StageTimingRecorder() {
+        for (int i = 0; i < MOTION_STAGE_COUNT; ++i) {
+            m_budget_us[i].store(MOTION_STAGE_BUDGET_US[i], std::memory_order_relaxed);
+        }
+    }
+
+    void set_budget_us(MotionStage stage, uint32_t budget_us) {
+        m_budget_us[static_cast<int>(stage)].store(budget_us, std::memory_order_relaxed);
+    }
+    uint32_t budget_us(MotionStage stage) const {
+        return m_budget_us[static_cast<int>(stage)].load(std::memory_order_relaxed);
+    }
+    // The whole tick: no mixer period shorter than this can keep up
+    uint32_t tick_budget_us() const {
+        uint32_t total = 0;
+        for (int i = 0; i < MOTION_STAGE_COUNT; ++i) {
+            total += m_budget_us[i].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void record(MotionStage stage, uint32_t elapsed_us) {
+        const int i = static_cast<int>(stage);
+        if (elapsed_us > m_budget_us[i].load(std::memory_order_relaxed)) {
+            m_over_budget[i].fetch_add(1, std::memory_order_relaxed);
+        }
+        if (elapsed_us > m_max_us[i].load(std::memory_order_relaxed)) {
+            m_max_us[i].store(elapsed_us, std::memory_order_relaxed);
+        }
+    }
+
+    StageTimingStats snapshot() const {
+        StageTimingStats stats = {};
+        for (int i = 0; i < MOTION_STAGE_COUNT; ++i) {
+            stats.budget_us[i] = m_budget_us[i].load(std::memory_order_relaxed);
+            stats.max_us[i] = m_max_us[i].load(std::memory_order_relaxed);
+            stats.over_budget[i] = m_over_budget[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    void reset() {
+        for (int i = 0; i < MOTION_STAGE_COUNT; ++i) {
+            m_max_us[i].store(0, std::memory_order_relaxed);
+            m_over_budget[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<uint32_t> m_budget_us[MOTION_STAGE_COUNT];
+    std::atomic<uint32_t> m_max_us[MOTION_STAGE_COUNT] = {};
+    std::atomic<uint32_t> m_over_budget[MOTION_STAGE_COUNT] = {};
+};
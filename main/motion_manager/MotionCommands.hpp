@@ -0,0 +1,45 @@
+#pragma once
+
+// Motion command codes: the motion_type byte of a motion_command_t, as sent
+// by the host over UART and queued through MotionController::queue_command().
+
+#define MOTION_STOP           0x00
+#define MOTION_FORWARD        0x01
+#define MOTION_BACKWARD       0x02
+#define MOTION_LEFT           0x03
+#define MOTION_RIGHT          0x04
+
+#define MOTION_WAVE_HAND      0x05
+#define MOTION_MOVE_EAR       0x06
+#define MOTION_NOD_HEAD       0x07
+#define MOTION_SHAKE_HEAD     0x08
+#define MOTION_WALK_BACKWARD_KF 0x09
+#define MOTION_WAVE_HELLO     0x0C
+#define MOTION_FACE_TRACE     0x0A
+#define MOTION_FACE_END       0x0B
+
+#define MOTION_HAPPY          0x10
+#define MOTION_LOOKAROUND     0x11
+#define MOTION_DANCE          0x12
+#define MOTION_FUNNY          0x13
+#define MOTION_VERY_HAPPY     0x14
+#define MOTION_ANGRY          0x15
+#define MOTION_CRYING         0x16
+#define MOTION_SURPRISED      0x17
+#define MOTION_SAD            0x18
+#define MOTION_LOVOT_SHAKE    0x19
+#define MOTION_WAKE_DETECT    0xC0
+#define MOTION_PLAY_ANIMATION 0xD0
+#define MOTION_PLAY_MOTION    0xD1
+
+#define MOTION_TRACKING_L     0x1A
+#define MOTION_TRACKING_R     0x1B
+#define MOTION_WALK_FORWARD_KF 0x1C
+#define MOTION_STARTLE_AND_SIGH 0x1D
+
+
+#define MOTION_TUNE_PARAM     0x20
+#define MOTION_SAVE_PARAMS    0x21
+#define MOTION_GET_PARAMS     0x22
+#define MOTION_SOUND_SOURCE   0xD2
+#define MOTION_SERVO_CONTROL  0xF0
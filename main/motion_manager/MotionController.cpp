@@ -1,42 +1,32 @@
 #include "MotionController.hpp"
 #include "motion_manager/ServoCalibration.hpp"
+#include "motion_manager/GaitEngine.hpp"
+#include "motion_manager/KeyframeEngine.hpp"
+#include "motion_manager/LayerMixer.hpp"
 #include "esp_log.h"
 #include <cmath>
 #include <string.h>
+#include <cstdio>
 #include <algorithm>
-#include <queue>
 
 #define PI 3.1415926
 
 static const char* TAG = "MotionController";
-static std::queue<motion_command_t> s_turning_queue;
+
+static const uint16_t SEQUENCE_GAIT_ENTRY_MS = 200; // Shortest ease-in of a gait that follows in a sequence
 
 // --- Constructor / Destructor ---
 MotionController::MotionController(Servo& servo_driver, ActionManager& action_manager) 
     : m_servo_driver(servo_driver), 
       m_action_manager(action_manager),
-      m_motion_queue(NULL),
-      m_actions_mutex(NULL),
       m_interrupt_flag(false),
-      m_increment_was_limited_last_cycle(false),
       m_is_manual_control_active(false), // Initialize new member
-      m_manual_control_timeout_us(0),
-      m_default_filter_alpha(0.8f), // Initialize default alpha
-      m_current_filter_alpha(0.8f) // Initialize current alpha // Initialize new member
+      m_manual_control_timeout_us(0)
 {
     m_decision_maker = std::make_unique<DecisionMaker>(*this);
 }
 
 MotionController::~MotionController() {
-    if (m_motion_queue != NULL) {
-        vQueueDelete(m_motion_queue);
-    }
-    if (m_actions_mutex != NULL) {
-        vSemaphoreDelete(m_actions_mutex);
-    }
-    if (m_face_location_queue != NULL) {
-        vQueueDelete(m_face_location_queue);
-    }
 }
 
 void MotionController::init_joint_channel_map() {
@@ -47,90 +37,71 @@ void MotionController::init_joint_channel_map() {
 }
 
 // --- Public Methods ---
-void MotionController::init() {
+void MotionController::init(bool start_tasks) {
     init_joint_channel_map();
 
-    // Initialize angle filters first to prevent race condition
-    m_angle_filters.resize(GAIT_JOINT_COUNT);
-    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
-        m_angle_filters[i].set_alpha(m_default_filter_alpha);
-        m_angle_filters[i].reset(ServoCalibration::get_home_pos(static_cast<ServoChannel>(i)));
-    }
-
-    m_gait_command_map[MOTION_FORWARD] = "walk_forward";
-    m_gait_command_map[MOTION_BACKWARD] = "walk_backward";
-    m_gait_command_map[MOTION_LEFT] = "turn_left";
-    m_gait_command_map[MOTION_RIGHT] = "turn_right";
-    m_gait_command_map[MOTION_WAVE_HAND] = "wave_hand";
-    m_gait_command_map[MOTION_WAVE_HELLO] = "wave_hello"; // New lively wave
-    m_gait_command_map[MOTION_MOVE_EAR] = "wiggle_ears";
-    m_gait_command_map[MOTION_NOD_HEAD] = "nod_head";
-    m_gait_command_map[MOTION_SHAKE_HEAD] = "shake_head";
-    m_gait_command_map[MOTION_WALK_BACKWARD_KF] = "walk_backward_kf";
-    m_gait_command_map[MOTION_FACE_TRACE] = "face_trace";
-    m_gait_command_map[MOTION_HAPPY] = "happy";
-    m_gait_command_map[MOTION_SAD] = "sad"; // Corrected mapping
-    m_gait_command_map[MOTION_LOOKAROUND] = "Look_Around";
-    m_gait_command_map[MOTION_DANCE] = "dance";
-    m_gait_command_map[MOTION_FUNNY] = "funny";
-    m_gait_command_map[MOTION_VERY_HAPPY] = "very_happy";
-    m_gait_command_map[MOTION_ANGRY] = "angry";
-    m_gait_command_map[MOTION_CRYING] = "sudden_shock";
-    m_gait_command_map[MOTION_SURPRISED] = "curious_ponder";
+    // The MIXER stage ends in a full servo frame: budget its bus time too
+    m_stage_timing.set_budget_us(MotionStage::MIXER, MOTION_STAGE_BUDGET_US[static_cast<int>(MotionStage::MIXER)] +
+                                                         m_servo_driver.frame_time_us(GAIT_JOINT_COUNT));
+    ESP_LOGI(TAG, "Motion tick budget %u us, servo frame included.",
+             static_cast<unsigned>(m_stage_timing.tick_budget_us()));
+
+    m_command_table.bind(MOTION_FORWARD, "walk_forward");
+    m_command_table.bind(MOTION_BACKWARD, "walk_backward");
+    m_command_table.bind(MOTION_LEFT, "turn_left");
+    m_command_table.bind(MOTION_RIGHT, "turn_right");
+    m_command_table.bind(MOTION_WAVE_HAND, "wave_hand");
+    m_command_table.bind(MOTION_WAVE_HELLO, "wave_hello"); // New lively wave
+    m_command_table.bind(MOTION_MOVE_EAR, "wiggle_ears");
+    m_command_table.bind(MOTION_NOD_HEAD, "nod_head");
+    m_command_table.bind(MOTION_SHAKE_HEAD, "shake_head");
+    m_command_table.bind(MOTION_WALK_BACKWARD_KF, "walk_back_kf");
+    m_command_table.bind(MOTION_HAPPY, "happy");
+    m_command_table.bind(MOTION_SAD, "sad"); // Corrected mapping
+    m_command_table.bind(MOTION_LOOKAROUND, "look_around");
+    m_command_table.bind(MOTION_DANCE, "dance");
+    m_command_table.bind(MOTION_FUNNY, "funny");
+    m_command_table.bind(MOTION_VERY_HAPPY, "very_happy");
+    m_command_table.bind(MOTION_ANGRY, "angry");
+    m_command_table.bind(MOTION_CRYING, "sudden_shock");
+    m_command_table.bind(MOTION_SURPRISED, "curious_ponder");
 
     // --- 修正特殊动作的映射 ---
-    m_gait_command_map[MOTION_TRACKING_L] = "tracking_L";
-    m_gait_command_map[MOTION_TRACKING_R] = "tracking_R";
-    m_gait_command_map[MOTION_WALK_FORWARD_KF] = "walk_forward_kf";
-    m_gait_command_map[MOTION_STARTLE_AND_SIGH] = "startle_and_sigh";
-    
-
-    m_motion_queue = xQueueCreate(10, sizeof(motion_command_t));
-    if (m_motion_queue == NULL) {
-        ESP_LOGE(TAG, "Failed to create motion queue");
-        return;
-    }
-
-    m_actions_mutex = xSemaphoreCreateMutex();
-    if (m_actions_mutex == NULL) {
-        ESP_LOGE(TAG, "Failed to create actions mutex");
-        return;
-    }
+    m_command_table.bind(MOTION_TRACKING_L, "tracking_L");
+    m_command_table.bind(MOTION_TRACKING_R, "tracking_R");
+    m_command_table.bind(MOTION_WALK_FORWARD_KF, "walk_forward_kf");
+    m_command_table.bind(MOTION_STARTLE_AND_SIGH, "startle_and_sigh");
+    m_command_table.build(m_action_manager, m_action_manager.edit_generation());
 
-    m_face_location_queue = xQueueCreate(5, sizeof(FaceLocation)); // Queue size 5, adjust as needed
-    if (m_face_location_queue == NULL) {
-        ESP_LOGE(TAG, "Failed to create face location queue");
-        return;
-    }
-
-    // Initialize PID controller variables
-    m_pid_pan_error_last = 0;
-    m_pid_tilt_error_last = 0;
-    m_pan_offset = 0.0f;
-    m_tilt_offset = 0.0f;
     m_last_tracking_turn_end_time = 0;
     m_is_head_frozen = false;
 
     // Initialize Face Tracking Action state
     m_is_tracking_active = false;
-    memset(&m_head_tracking_action, 0, sizeof(ActionInstance));
-    strncpy(m_head_tracking_action.action.name, "head_track", MOTION_NAME_MAX_LEN - 1);
-    m_head_tracking_action.action.type = ActionType::GAIT_PERIODIC;
-    m_head_tracking_action.action.is_atomic = false;
-    m_head_tracking_action.action.default_steps = 1; // Will run continuously
-    m_head_tracking_action.action.data.gait.gait_period_ms = 1000;
+    memset(&m_head_tracking_action, 0, sizeof(RegisteredAction));
+    strncpy(m_head_tracking_action.name, "head_track", MOTION_NAME_MAX_LEN - 1);
+    m_head_tracking_id = m_action_manager.intern_action_id(m_head_tracking_action.name);
+    m_head_tracking_action.type = ActionType::GAIT_PERIODIC;
+    m_head_tracking_action.is_atomic = false;
+    m_head_tracking_action.default_steps = 1; // Will run continuously
+    m_head_tracking_action.data.gait.gait_period_ms = 1000;
+    m_head_tracking_action.data.gait.harmonic_count = 1;
     for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
-        m_head_tracking_action.action.data.gait.params.offset[i] = 0.0f;
-        m_head_tracking_action.action.data.gait.params.amplitude[i] = 0.01f; // Very small amplitude to allow fine control
-        m_head_tracking_action.action.data.gait.params.phase_diff[i] = 0.0f;
+        m_head_tracking_action.data.gait.harmonic_terms[0].offset[i] = 0.0f;
+        m_head_tracking_action.data.gait.harmonic_terms[0].amplitude[i] = 0.01f; // Very small amplitude to allow fine control
+        m_head_tracking_action.data.gait.harmonic_terms[0].phase_diff[i] = 0.0f;
     }
+    m_head_track_prediction.publish({0.0f, 0.0f, 0.0f, 0.0f, 0});
 
-    m_decision_maker->start(); // Start the new decision maker task
+    m_trace.init(MotionTrace::DEFAULT_CAPACITY, start_tasks);
+
+    if (!start_tasks) {
+        ESP_LOGI(TAG, "Motion Controller initialized, tasks left to the caller.");
+        return;
+    }
 
-    xTaskCreatePinnedToCore(start_task_wrapper, "motion_engine_task", 8192, this, 6, NULL, 1);
-    xTaskCreatePinnedToCore(start_mixer_task_wrapper, "motion_mixer_task", 4096, this, 7, NULL, 1); // Higher priority for mixer
-    xTaskCreatePinnedToCore(start_face_tracking_task_wrapper, "face_tracking_task", 4096, this, 6, NULL, 1);
-    ESP_LOGI(TAG, "Motion Controller initialized and tasks started.");
+    MotionPlatform::start_task(start_executor_task_wrapper, "motion_executor", 8192, this, 7, 1);
+    ESP_LOGI(TAG, "Motion Controller initialized and executor started.");
 }
 
 bool MotionController::queue_command(const motion_command_t& cmd) {
@@ -142,15 +113,40 @@ bool MotionController::queue_command(const motion_command_t& cmd) {
     // Clear manual control flag if a new action is queued
     m_is_manual_control_active.store(false);
 
-    if (xQueueSend(m_motion_queue, &cmd, 0) != pdTRUE) {
+    if (!m_motion_commands.push({cmd, MotionPlatform::now_us()})) {
+        m_commands_dropped.fetch_add(1, std::memory_order_relaxed);
         ESP_LOGW(TAG, "Motion queue is full. Command dropped.");
         return false;
     }
+    m_commands_queued.fetch_add(1, std::memory_order_relaxed);
+    uint32_t depth = static_cast<uint32_t>(m_motion_commands.size());
+    uint32_t high_water = m_commands_high_water.load(std::memory_order_relaxed);
+    while (depth > high_water &&
+           !m_commands_high_water.compare_exchange_weak(high_water, depth, std::memory_order_relaxed)) {
+    }
     return true;
 }
 
+MotionCommandStats MotionController::get_command_stats() const {
+    MotionCommandStats stats;
+    stats.queued = m_commands_queued.load(std::memory_order_relaxed);
+    stats.dropped = m_commands_dropped.load(std::memory_order_relaxed);
+    stats.flushed = m_commands_flushed.load(std::memory_order_relaxed);
+    stats.high_water = m_commands_high_water.load(std::memory_order_relaxed);
+    stats.deferred = m_commands_deferred.load(std::memory_order_relaxed);
+    stats.coalesced = m_commands_coalesced.load(std::memory_order_relaxed);
+    stats.expired = m_commands_expired.load(std::memory_order_relaxed);
+    stats.latency_max_us = m_command_latency_max_us.load(std::memory_order_relaxed);
+    stats.latency_last_us = m_command_latency_last_us.load(std::memory_order_relaxed);
+    return stats;
+}
+
 bool MotionController::queue_face_location(const FaceLocation& face_loc) {
-    if (xQueueSend(m_face_location_queue, &face_loc, 0) != pdTRUE) {
+    FaceLocation stamped = face_loc;
+    if (stamped.timestamp_us == 0) {
+        stamped.timestamp_us = MotionPlatform::now_us();
+    }
+    if (!m_face_locations.push(stamped)) {
         ESP_LOGW(TAG, "Face location queue is full. Data dropped.");
         return false;
     }
@@ -158,421 +154,900 @@ bool MotionController::queue_face_location(const FaceLocation& face_loc) {
 }
 
 motion_command_t MotionController::get_current_command() {
-    motion_command_t current_cmd = {0, {}};
-    if (xSemaphoreTake(m_actions_mutex, portMAX_DELAY) == pdTRUE) {
-        if (!m_active_actions.empty()) {
-            const ActionInstance& instance = m_active_actions.front();
-            for (const auto& pair : m_gait_command_map) {
-                if (pair.second == instance.action.name) {
-                    current_cmd.motion_type = pair.first;
+    motion_command_t current_cmd = {};
+    ActiveActionSnapshot active = read_active_snapshot();
+    uint8_t code;
+    if (active.count > 0 && m_command_table.code_for(active.actions[0].id, code)) {
+        current_cmd.motion_type = code;
+    }
+    return current_cmd;
+}
+
+// --- Active Action Set ---
+void MotionController::stage_action_edit(ActionEditType type, const RegisteredAction* action, ActionId id) {
+    if (!m_action_edits.push({type, action, id})) {
+        m_edits_dropped.fetch_add(1, std::memory_order_relaxed);
+        ESP_LOGW(TAG, "Action edit ring is full. Edit for '%s' dropped.", action ? action->name : "<all>");
+    }
+}
+
+ActiveActionSnapshot MotionController::read_active_snapshot() const {
+    ActiveActionSnapshot snapshot;
+    uint32_t retries = m_active_snapshot.read(snapshot);
+    if (retries > 0) {
+        m_snapshot_retries.fetch_add(retries, std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+ActionSetStats MotionController::get_action_set_stats() const {
+    ActionSetStats stats;
+    stats.edits_applied = m_edits_applied.load(std::memory_order_relaxed);
+    stats.edits_dropped = m_edits_dropped.load(std::memory_order_relaxed);
+    stats.sequences_dropped = m_sequences_dropped.load(std::memory_order_relaxed);
+    stats.snapshot_retries = m_snapshot_retries.load(std::memory_order_relaxed);
+    stats.mixer_wait_max_us = m_mixer_wait_max_us.load(std::memory_order_relaxed);
+    stats.mixer_wait_total_us = m_mixer_wait_total_us.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Stages a resolved command target: every member of a group, or the single
+// action. Whether a group member is already running is decided by the mixer
+// when it applies the edit, so two commands staged within one tick cannot
+// start duplicates.
+void MotionController::dispatch_target(const CommandTable::Target& target, const char* name) {
+    for (uint8_t i = 0; i < target.member_count; ++i) {
+        if (target.members[i].action->is_atomic) m_atomic_staged = true;
+    }
+    if (target.group && target.group->mode == ExecutionMode::SEQUENTIAL && target.member_count > 0) {
+        // The whole chain goes over at once; the mixer starts each member on
+        // the tick the one before it finishes.
+        ESP_LOGI(TAG, "Processing sequential action group: '%s'", name);
+        stage_action_edit(ActionEditType::START_SEQUENCE, target.members[0].action, target.members[0].id);
+        for (uint8_t i = 1; i < target.member_count; ++i) {
+            stage_action_edit(ActionEditType::APPEND_TO_SEQUENCE, target.members[i].action, target.members[i].id);
+        }
+        return;
+    }
+    if (target.group) {
+        ESP_LOGI(TAG, "Processing action group: '%s'", name);
+        for (uint8_t i = 0; i < target.member_count; ++i) {
+            stage_action_edit(ActionEditType::START_IF_INACTIVE, target.members[i].action, target.members[i].id);
+        }
+        return;
+    }
+    // Already running actions are extended
+    stage_action_edit(ActionEditType::START_OR_EXTEND, target.members[0].action, target.members[0].id);
+}
+
+// --- DISPATCH Stage ---
+// Dispatches queued commands in order until the ring is empty or the stage
+// runs out of budget; the rest stay queued for the next tick. While an atomic
+// action runs, or has been staged this tick, commands other than STOP are
+// deferred instead (see CommandQueue.hpp) and dispatched by class on the
+// first tick after it ends.
+void MotionController::run_dispatch_stage(int64_t deadline_us) {
+    // Edited templates were published under new pointers: resolve the codes again
+    const uint32_t edit_generation = m_action_manager.edit_generation();
+    if (edit_generation != m_command_table.generation()) {
+        m_command_table.build(m_action_manager, edit_generation);
+    }
+
+    const uint32_t expired = m_deferred_commands.expire(MotionPlatform::now_us());
+    if (expired > 0) {
+        m_commands_expired.fetch_add(expired, std::memory_order_relaxed);
+        ESP_LOGW(TAG, "%u deferred commands expired.", static_cast<unsigned>(expired));
+    }
+
+    m_atomic_staged = false;
+    bool atomic_running = false;
+    ActiveActionSnapshot active = read_active_snapshot();
+    for (uint8_t i = 0; i < active.count; ++i) {
+        atomic_running |= active.actions[i].is_atomic;
+    }
+
+    CommandQueue::Entry deferred;
+    while (!atomic_running && !m_atomic_staged && MotionPlatform::now_us() < deadline_us &&
+           m_deferred_commands.pop(deferred)) {
+        note_dispatched(deferred.queued_us);
+        dispatch_command(deferred.command);
+    }
+
+    QueuedCommand queued;
+    while (MotionPlatform::now_us() < deadline_us && m_motion_commands.pop(queued)) {
+        if (queued.command.motion_type != MOTION_STOP &&
+            (atomic_running || m_atomic_staged || !m_deferred_commands.empty())) {
+            defer_command(queued);
+            continue;
+        }
+        note_dispatched(queued.queued_us);
+        dispatch_command(queued.command);
+    }
+}
+
+void MotionController::defer_command(const QueuedCommand& queued) {
+    const uint8_t code = queued.command.motion_type;
+    switch (m_deferred_commands.push(queued.command, queued.queued_us)) {
+        case CommandQueue::PushResult::ADDED:
+            ESP_LOGI(TAG, "Deferring command (0x%02X) until the atomic action ends.", code);
+            break;
+        case CommandQueue::PushResult::COALESCED:
+            m_commands_coalesced.fetch_add(1, std::memory_order_relaxed);
+            ESP_LOGI(TAG, "Deferring command (0x%02X) in place of an older one of its class.", code);
+            break;
+        case CommandQueue::PushResult::EVICTED:
+            m_commands_dropped.fetch_add(1, std::memory_order_relaxed);
+            ESP_LOGW(TAG, "Deferred command queue is full. Oldest lowest-priority command dropped for 0x%02X.", code);
+            break;
+        case CommandQueue::PushResult::REJECTED:
+            m_commands_dropped.fetch_add(1, std::memory_order_relaxed);
+            ESP_LOGW(TAG, "Deferred command queue is full. Command (0x%02X) dropped.", code);
+            return;
+    }
+    m_commands_deferred.fetch_add(1, std::memory_order_relaxed);
+}
+
+void MotionController::note_dispatched(int64_t queued_us) {
+    if (m_tick_oldest_command_us == 0 || queued_us < m_tick_oldest_command_us) {
+        m_tick_oldest_command_us = queued_us;
+    }
+}
+
+void MotionController::dispatch_command(const motion_command_t& received_cmd) {
+    if (m_interrupt_flag.load() && received_cmd.motion_type == MOTION_STOP) {
+        ESP_LOGW(TAG, "STOP command received. Clearing all actions and queue.");
+        stage_action_edit(ActionEditType::CLEAR_ALL, nullptr, INVALID_ACTION_ID);
+        QueuedCommand flushed;
+        while (m_motion_commands.pop(flushed)) {
+            m_commands_flushed.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_commands_flushed.fetch_add(m_deferred_commands.clear(), std::memory_order_relaxed);
+        drop_face_locations();
+        m_is_tracking_active.store(false); // Deactivate face tracking
+        m_interrupt_flag.store(false);
+        // No home() here: it writes the servos behind the follower's back and
+        // sleeps. With every action cleared the mixer returns the joints home
+        // at the follower's limits from this tick on.
+        // Clear manual control flag on STOP
+        m_is_manual_control_active.store(false);
+        return;
+    }
+
+    ActiveActionSnapshot active = read_active_snapshot();
+
+    // Clear manual control flag if a new action is about to be added
+    m_is_manual_control_active.store(false);
+
+    switch (received_cmd.motion_type) {
+        case MOTION_WAKE_DETECT: {break;} // do nothing, just avoid warnings
+        case 0xF0: // MOTION_SERVO_CONTROL
+        {
+            // This case is now handled by the mixer logic, but we can keep it for compatibility
+            // It will create a temporary gait action, which is not ideal but works.
+            ESP_LOGW(TAG, "MOTION_SERVO_CONTROL is deprecated and will be handled by mixer.");
+            break;
+        }
+        case MOTION_PLAY_MOTION: // 0xD1
+        {
+            if (received_cmd.param_len > 0) {
+                char action_name[MOTION_CMD_PARAMS_MAX + 1];
+                memcpy(action_name, received_cmd.params, received_cmd.param_len);
+                action_name[received_cmd.param_len] = '\0';
+                ESP_LOGI(TAG, "Received MOTION_PLAY_MOTION for: '%s'", action_name);
+                CommandTable::Member members[MAX_ACTIONS_PER_GROUP];
+                CommandTable::Target target;
+                if (CommandTable::resolve(m_action_manager, action_name, members, target)) {
+                    dispatch_target(target, action_name);
+                }
+            } else {
+                ESP_LOGW(TAG, "Received MOTION_PLAY_MOTION with no action name.");
+            }
+            break;
+        }
+        case MOTION_FACE_TRACE: { 
+            bool is_already_active = false;
+            for (uint8_t i = 0; i < active.count; ++i) {
+                if (active.actions[i].roles & ACTION_ROLE_HEAD_TRACK) {
+                    is_already_active = true;
+                    break;
+                }
+                if (active.actions[i].roles & ACTION_ROLE_TRACKING_TURN) {
+                    motion_command_t stop = {};
+                    stop.motion_type = MOTION_STOP;
+                    queue_command(stop);
                     break;
                 }
             }
+            if (!is_already_active) {
+                stage_action_edit(ActionEditType::START_IF_INACTIVE, &m_head_tracking_action, m_head_tracking_id);
+                ESP_LOGI(TAG, "Face tracking action activated.");
+            }
+            break;
+        }
+        default: {
+            const CommandTable::Target* target = m_command_table.find(received_cmd.motion_type);
+            if (target) {
+                dispatch_target(*target, m_command_table.name(received_cmd.motion_type));
+            } else if (m_command_table.name(received_cmd.motion_type)) {
+                ESP_LOGE(TAG, "Action '%s' not found in manager!", m_command_table.name(received_cmd.motion_type));
+            } else {
+                ESP_LOGW(TAG, "Unknown motion type: 0x%02X", received_cmd.motion_type);
+            }
+            break;
         }
-        xSemaphoreGive(m_actions_mutex);
     }
-    return current_cmd;
 }
 
-// --- Core Engine Task (Dispatcher) ---
-void MotionController::motion_engine_task() {
-    ESP_LOGI(TAG, "Motion engine (dispatcher) task running...");
-    motion_command_t received_cmd;
+// --- Motion Executor Task ---
+// The only motion task. Each tick runs tracking, behaviour, dispatch and
+// mixing in that order (see run_tick()), so a command queued before a tick
+// reaches the servos in that tick.
+// Runs on an absolute-deadline clock: each tick is scheduled one period after
+// the previous deadline, not after the previous tick finished, so compute
+// time and bus time do not stretch the period. Timing is measured against the
+// platform microsecond clock and recorded in m_mixer_timing.
+void MotionController::motion_executor_task() {
+    ESP_LOGI(TAG, "Motion executor running at %d Hz...", static_cast<int>(m_mixer_rate.load()));
+
+    uint32_t period_us = mixer_period_us(m_mixer_rate.load());
+    m_mixer_timing.set_period_us(period_us);
+    uint32_t last_wake = MotionPlatform::tick_count();
+    int64_t deadline_us = 0;
+    bool reanchor = true; // Align the us deadline to the first wake after (re)start
+
     while (1) {
-        if (xQueueReceive(m_motion_queue, &received_cmd, portMAX_DELAY)) {
-            
-            if (m_interrupt_flag.load() && received_cmd.motion_type == MOTION_STOP) {
-                ESP_LOGW(TAG, "STOP command received. Clearing all actions and queue.");
-                if (xSemaphoreTake(m_actions_mutex, portMAX_DELAY) == pdTRUE) {
-                    m_active_actions.clear();
-                    xSemaphoreGive(m_actions_mutex);
-                }
-                xQueueReset(m_motion_queue);
-                xQueueReset(m_face_location_queue); // Clear face location queue
-                m_is_tracking_active.store(false); // Deactivate face tracking
-                m_interrupt_flag.store(false);
-                home();
-                // Clear manual control flag on STOP
-                m_is_manual_control_active.store(false);
-                continue;
+        int64_t wake_us = MotionPlatform::now_us();
+        if (reanchor) {
+            deadline_us = wake_us;
+            reanchor = false;
+        }
+        int64_t lateness_us = wake_us - deadline_us;
+
+        run_tick(wake_us);
+
+        int64_t done_us = MotionPlatform::now_us();
+        uint32_t compute_us = static_cast<uint32_t>(done_us - wake_us);
+        uint32_t jitter_us = static_cast<uint32_t>(lateness_us < 0 ? -lateness_us : lateness_us);
+        record_trace(compute_us, jitter_us);
+
+        uint32_t new_period_us = mixer_period_us(m_mixer_rate.load());
+        if (new_period_us != period_us) {
+            period_us = new_period_us;
+            m_mixer_timing.set_period_us(period_us);
+        }
+        deadline_us += period_us;
+
+        bool overrun = !MotionPlatform::delay_until(last_wake, period_us / 1000);
+        if (overrun) {
+            // The next deadline already passed: skip the missed ticks and
+            // re-anchor instead of bursting to catch up.
+            last_wake = MotionPlatform::tick_count();
+            reanchor = true;
+        }
+        m_mixer_timing.record(jitter_us, compute_us, overrun);
+    }
+}
+
+// Simulated ticks take no time and land exactly on their deadline.
+void MotionController::step(int64_t now_us) {
+    run_tick(now_us);
+    record_trace(0, 0);
+}
+
+// Stages that handle queues stop at their budget and carry the rest over;
+// the others always finish. Every stage's time is recorded in m_stage_timing.
+void MotionController::run_tick(int64_t now_us) {
+    // No stage resolves a template before this; see note_executor_generation()
+    const uint32_t edit_generation = m_action_manager.edit_generation();
+    const int64_t start_us = MotionPlatform::now_us();
+    run_tracking_stage();
+    const int64_t tracking_us = MotionPlatform::now_us();
+    m_stage_timing.record(MotionStage::TRACKING, static_cast<uint32_t>(tracking_us - start_us));
+
+    if (m_decision_maker) {
+        m_decision_maker->process_pending_events(
+            tracking_us + m_stage_timing.budget_us(MotionStage::BEHAVIOR));
+    }
+    const int64_t behavior_us = MotionPlatform::now_us();
+    m_stage_timing.record(MotionStage::BEHAVIOR, static_cast<uint32_t>(behavior_us - tracking_us));
+
+    run_dispatch_stage(behavior_us + m_stage_timing.budget_us(MotionStage::DISPATCH));
+    const int64_t dispatch_us = MotionPlatform::now_us();
+    m_stage_timing.record(MotionStage::DISPATCH, static_cast<uint32_t>(dispatch_us - behavior_us));
+
+    mixer_tick(now_us);
+    m_stage_timing.record(MotionStage::MIXER, static_cast<uint32_t>(MotionPlatform::now_us() - dispatch_us));
+    record_command_latency();
+    m_action_manager.note_executor_generation(edit_generation);
+}
+
+// Time from the oldest command dispatched this tick being queued to the end
+// of the servo write that carried it out.
+void MotionController::record_command_latency() {
+    if (m_tick_oldest_command_us == 0) return;
+    const int64_t latency_us = MotionPlatform::now_us() - m_tick_oldest_command_us;
+    m_tick_oldest_command_us = 0;
+    const uint32_t latency = static_cast<uint32_t>(latency_us < 0 ? 0 : latency_us);
+    m_command_latency_last_us.store(latency, std::memory_order_relaxed);
+    if (latency > m_command_latency_max_us.load(std::memory_order_relaxed)) {
+        m_command_latency_max_us.store(latency, std::memory_order_relaxed);
+    }
+}
+
+void MotionController::record_trace(uint32_t compute_us, uint32_t jitter_us) {
+    m_trace_record.compute_us = MotionTrace::saturate_us(compute_us);
+    m_trace_record.jitter_us = MotionTrace::saturate_us(jitter_us);
+    m_trace.record(m_trace_record);
+}
+
+bool MotionController::write_motion_trace(const MotionTraceRecorder::Sink& sink) {
+    // Name table indexed by ActionId. Ids are only created during init, so
+    // the count is stable by the time a trace can be requested.
+    uint16_t name_count = static_cast<uint16_t>(m_action_manager.action_id_count());
+    std::vector<char> names(static_cast<size_t>(name_count) * MOTION_NAME_MAX_LEN, '\0');
+    for (uint16_t id = 0; id < name_count; ++id) {
+        const char* name = m_action_manager.get_action_name(id);
+        if (name) {
+            strncpy(&names[static_cast<size_t>(id) * MOTION_NAME_MAX_LEN], name, MOTION_NAME_MAX_LEN - 1);
+        }
+    }
+    return m_trace.write(sink, reinterpret_cast<const char (*)[MOTION_NAME_MAX_LEN]>(names.data()), name_count,
+                         mixer_period_us(m_mixer_rate.load()));
+}
+
+bool MotionController::save_motion_trace(const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) {
+        ESP_LOGE(TAG, "Failed to open %s for the motion trace.", path);
+        return false;
+    }
+    bool ok = write_motion_trace([file](const void* data, size_t size) {
+        return fwrite(data, 1, size, file) == size;
+    });
+    ok = (fclose(file) == 0) && ok;
+    ESP_LOGI(TAG, "Motion trace %s %s.", ok ? "saved to" : "could not be saved to", path);
+    return ok;
+}
+
+bool MotionController::set_mixer_rate(MixerRate rate) {
+    const uint32_t tick_budget_us = m_stage_timing.tick_budget_us();
+    if (mixer_period_us(rate) < tick_budget_us) {
+        ESP_LOGE(TAG, "Mixer rate %d Hz refused: a tick needs %u us, servo frame included.", static_cast<int>(rate),
+                 static_cast<unsigned>(tick_budget_us));
+        return false;
+    }
+    m_mixer_rate.store(rate);
+    ESP_LOGI(TAG, "Mixer rate set to %d Hz.", static_cast<int>(rate));
+    return true;
+}
+
+// Evaluates one running action at now_us into absolute joint angles, before
+// limits. Returns the joints it produced; the others in angles are undefined.
+uint32_t MotionController::evaluate_instance(ActionInstance& instance, int64_t now_us, uint32_t tick_us,
+                                             float (&angles)[GAIT_JOINT_COUNT]) {
+    const RegisteredAction& action = *instance.action;
+    switch (action.type) {
+        case ActionType::GAIT_PERIODIC: {
+            if (action.data.gait.gait_period_ms == 0) return 0;
+
+            // Head tracking replaces the template's head offsets with the
+            // tracker's prediction for when this tick's output reaches the servos.
+            const bool head_track = (instance.roles & ACTION_ROLE_HEAD_TRACK) != 0;
+            float head_pan_offset = 0.0f, head_tilt_offset = 0.0f;
+            if (head_track) {
+                HeadTrack::Prediction prediction;
+                m_head_track_prediction.read(prediction);
+                prediction.evaluate(now_us + HeadTrack::ACTUATION_LEAD_US, head_pan_offset, head_tilt_offset);
             }
 
-            if (xSemaphoreTake(m_actions_mutex, portMAX_DELAY) == pdTRUE) {
-                bool is_blocked_by_atomic = false;
-                for (const auto& instance : m_active_actions) {
-                    if (instance.action.is_atomic) {
-                        ESP_LOGW(TAG, "Ignoring command (0x%02X) because atomic action '%s' is running.", 
-                                 received_cmd.motion_type, instance.action.name);
-                        is_blocked_by_atomic = true;
-                        break;
-                    }
+            float wave[GAIT_JOINT_COUNT];
+            uint32_t produced =
+                GaitEngine::advance(m_oscillators[instance.oscillator_slot], action.data.gait, now_us, tick_us, wave);
+
+            for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+                float offset = action.data.gait.harmonic_terms[0].offset[i];
+                if (head_track) {
+                    if (i == static_cast<int>(ServoChannel::HEAD_PAN)) offset = head_pan_offset;
+                    else if (i == static_cast<int>(ServoChannel::HEAD_TILT)) offset = head_tilt_offset;
                 }
-                
-                if (is_blocked_by_atomic) {
-                    xSemaphoreGive(m_actions_mutex);
-                    continue;
+                if (std::abs(offset) > GaitEngine::AMPLITUDE_EPSILON) {
+                    produced |= 1u << i;
                 }
+                angles[i] = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i)) + offset + wave[i];
+            }
+            return produced;
+        }
 
-                // Clear manual control flag if a new action is about to be added
-                m_is_manual_control_active.store(false);
-
-                // Helper to create and add a new action instance
-                auto add_new_action = [&](const RegisteredAction* action_template) {
-                    if (!action_template) return;
-
-                    // If starting a body-moving action, freeze the head to prevent conflict.
-                    if (is_body_moving(*action_template))
-                    {
-                        m_is_head_frozen.store(true);
-                    }
+        case ActionType::KEYFRAME_SEQUENCE: {
+            const auto& keyframe_data = action.data.keyframe;
+            if (keyframe_data.frame_count == 0) return 0;
 
-                    ActionInstance new_instance = {};
-                    new_instance.action = *action_template;
-                    new_instance.remaining_steps = action_template->default_steps;
-                    new_instance.start_time_ms = esp_timer_get_time() / 1000;
-
-                    if (new_instance.action.type == ActionType::KEYFRAME_SEQUENCE) {
-                        new_instance.current_keyframe_index = 0;
-                        new_instance.transition_start_time_ms = new_instance.start_time_ms;
-                        // Initialize start positions to calibrated home for the first transition
-                        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
-                            new_instance.start_positions[i] = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
-                        }
-                    }
+            const auto& target_frame = keyframe_data.frames[instance.current_keyframe_index];
+            int64_t transition_duration = static_cast<int64_t>(target_frame.transition_time_ms) * 1000;
+            if (transition_duration == 0) transition_duration = 1; // Avoid division by zero
 
-                    if (strcmp(action_template->name, "walk_forward_kf") == 0) {
-                        apply_filter_alpha(0.3f); // Set alpha to 0.3 specifically for walk_forward_kf
-                    }
+            // Calculate interpolation progress (alpha)
+            int64_t elapsed_in_transition = now_us - instance.transition_start_time_us;
+            float linear_alpha = (float)elapsed_in_transition / (float)transition_duration;
+            linear_alpha = std::max(0.0f, std::min(1.0f, linear_alpha)); // Clamp alpha
 
-                    m_active_actions.push_back(new_instance);
-                    is_active = true; // Set active flag
-                    ESP_LOGI(TAG, "Action '%s' added to active list.", action_template->name);
-                };
-
-                switch (received_cmd.motion_type) {
-                    case MOTION_WAKE_DETECT: {break;} // do nothing, just avoid warnings
-                    case 0xF0: // MOTION_SERVO_CONTROL
-                    {
-                        // This case is now handled by the mixer logic, but we can keep it for compatibility
-                        // It will create a temporary gait action, which is not ideal but works.
-                        ESP_LOGW(TAG, "MOTION_SERVO_CONTROL is deprecated and will be handled by mixer.");
-                        break;
-                    }
-                    case MOTION_PLAY_MOTION: // 0xD1
-                    {
-                        if (!received_cmd.params.empty()) {
-                            std::string action_name(received_cmd.params.begin(), received_cmd.params.end());
-                            ESP_LOGI(TAG, "Received MOTION_PLAY_MOTION for: '%s'", action_name.c_str());
-
-                            // First, check if it's an action group
-                            const RegisteredGroup* group_to_add = m_action_manager.get_group(action_name);
-                            if (group_to_add) {
-                                ESP_LOGI(TAG, "Processing action group: '%s'", action_name.c_str());
-                                for (uint8_t i = 0; i < group_to_add->action_count; ++i) {
-                                    std::string member_action_name = group_to_add->action_names[i];
-                                    const RegisteredAction* member_action = m_action_manager.get_action(member_action_name);
-                                    if (member_action) {
-                                        // Check if member action is already active
-                                        bool member_action_already_exists = false;
-                                        for (const auto& existing_instance : m_active_actions) {
-                                            if (strcmp(existing_instance.action.name, member_action_name.c_str()) == 0) {
-                                                member_action_already_exists = true;
-                                                ESP_LOGW(TAG, "Member action '%s' from group '%s' is already active. Ignoring.", member_action_name.c_str(), action_name.c_str());
-                                                break;
-                                            }
-                                        }
-                                        if (!member_action_already_exists) {
-                                            add_new_action(member_action);
-                                        }
-                                    } else {
-                                        ESP_LOGE(TAG, "Member action '%s' not found for group '%s'!", member_action_name.c_str(), action_name.c_str());
-                                    }
-                                }
-                            } else {
-                                // If not a group, treat as a single action
-                                auto it = std::find_if(m_active_actions.begin(), m_active_actions.end(),
-                                    [&](const ActionInstance& instance) {
-                                        return strcmp(instance.action.name, action_name.c_str()) == 0;
-                                    });
-
-                                if (it != m_active_actions.end()) {
-                                    // Action is already active. Extend its duration.
-                                    const RegisteredAction* action_template = m_action_manager.get_action(action_name);
-                                    if (action_template) {
-                                        it->remaining_steps += action_template->default_steps;
-                                        ESP_LOGI(TAG, "Action '%s' is already active. Extending by %d steps. Total remaining: %d",
-                                                 action_name.c_str(), (int)action_template->default_steps, (int)it->remaining_steps);
-                                    }
-                                } else {
-                                    // Action is not active. Add it as a new instance.
-                                    const RegisteredAction* action_to_add = m_action_manager.get_action(action_name);
-                                    if (action_to_add) {
-                                        add_new_action(action_to_add);
-                                    } else {
-                                        ESP_LOGE(TAG, "Action '%s' not found in manager!", action_name.c_str());
-                                    }
-                                }
-                            }
-                        } else {
-                            ESP_LOGW(TAG, "Received MOTION_PLAY_MOTION with no action name.");
-                        }
-                        break;
-                    }
-                    case MOTION_FACE_TRACE: { 
-                        bool is_already_active = false;
-                        for(auto const& instance : m_active_actions) {
-                            if(strcmp(instance.action.name, "head_track") == 0) {
-                                is_already_active = true;
-                                break;
-                            }
-                            if(strcmp(instance.action.name, "tracking_L") == 0 || strcmp(instance.action.name, "tracking_R") == 0) {
-                                queue_command({MOTION_STOP, {}});
-                                break;
-                            }
-                        }
-                        if (!is_already_active) {
-                            ActionInstance head_instance = m_head_tracking_action;
-                            head_instance.start_time_ms = esp_timer_get_time() / 1000;
-                            m_active_actions.push_back(head_instance);
-                            ESP_LOGI(TAG, "Face tracking action activated.");
-                        }
-                        is_active = true;
-                        break;
-                    }
-                    default: {
-                        if (m_gait_command_map.count(received_cmd.motion_type)) {
-                            const std::string& action_name = m_gait_command_map.at(received_cmd.motion_type);
-                            
-                            // First, check if it's an action group
-                            const RegisteredGroup* group_to_add = m_action_manager.get_group(action_name);
-                            if (group_to_add) {
-                                ESP_LOGI(TAG, "Processing action group: '%s'", action_name.c_str());
-                                for (uint8_t i = 0; i < group_to_add->action_count; ++i) {
-                                    std::string member_action_name = group_to_add->action_names[i];
-                                    const RegisteredAction* member_action = m_action_manager.get_action(member_action_name);
-                                    if (member_action) {
-                                        bool member_action_already_exists = false;
-                                        for (const auto& existing_instance : m_active_actions) {
-                                            if (strcmp(existing_instance.action.name, member_action_name.c_str()) == 0) {
-                                                member_action_already_exists = true;
-                                                break;
-                                            }
-                                        }
-                                        if (!member_action_already_exists) {
-                                            add_new_action(member_action);
-                                        }
-                                    } else {
-                                        ESP_LOGE(TAG, "Member action '%s' not found for group '%s'!", member_action_name.c_str(), action_name.c_str());
-                                    }
-                                }
-                            } else {
-                                // If not a group, treat as a single action
-                                auto it = std::find_if(m_active_actions.begin(), m_active_actions.end(),
-                                    [&](const ActionInstance& instance) {
-                                        return strcmp(instance.action.name, action_name.c_str()) == 0;
-                                    });
-
-                                if (it != m_active_actions.end()) {
-                                    // Action is already active. Extend its duration.
-                                    const RegisteredAction* action_template = m_action_manager.get_action(action_name);
-                                    if (action_template) {
-                                        it->remaining_steps += action_template->default_steps;
-                                        ESP_LOGI(TAG, "Action '%s' is already active. Extending by %d steps. Total remaining: %d",
-                                                 action_name.c_str(), (int)action_template->default_steps, (int)it->remaining_steps);
-                                    }
-                                } else {
-                                    // Action is not active. Add it as a new instance.
-                                    const RegisteredAction* action_to_add = m_action_manager.get_action(action_name);
-                                    if (action_to_add) {
-                                        add_new_action(action_to_add);
-                                    } else {
-                                        ESP_LOGE(TAG, "Action '%s' not found in manager!", action_name.c_str());
-                                    }
-                                }
-                            }
-                        } else {
-                            ESP_LOGW(TAG, "Unknown motion type: 0x%02X", received_cmd.motion_type);
-                        }
-                        break;
+            if (instance.spline) {
+                // Precomputed spline segment: velocity carries through the frame
+                const SplineSegment& segment = instance.spline->segments[instance.spline_segment];
+                for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+                    angles[i] = KeyframeEngine::evaluate(segment, i, linear_alpha);
+                }
+                if (!instance.looped && instance.current_keyframe_index == 0) {
+                    // Entry segments start at home; ease in from start_positions instead
+                    const float weight = KeyframeEngine::entry_offset_weight(linear_alpha);
+                    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+                        angles[i] += weight * (instance.start_positions[i] - LayerMixer::HOME_POSE[i]);
                     }
                 }
-                 xSemaphoreGive(m_actions_mutex);
+                return ALL_JOINTS_MASK;
+            }
+
+            // Apply cosine easing for smooth acceleration and deceleration
+            float eased_alpha = 0.5f * (1.0f - cosf(linear_alpha * PI));
+            for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+                float start_pos = instance.start_positions[i];
+                angles[i] = start_pos + (target_frame.positions[i] - start_pos) * eased_alpha;
             }
+            return ALL_JOINTS_MASK;
         }
     }
+    return 0;
 }
 
-// --- Motion Mixer Task ---
-void MotionController::motion_mixer_task() {
-    ESP_LOGI(TAG, "Motion mixer task running...");
-    const int control_period_ms = 20; // 50Hz control rate
+void MotionController::mixer_tick(int64_t current_time_us) {
+    float final_angles[GAIT_JOINT_COUNT];
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        final_angles[i] = -1.0f; // -1 indicates not set
+    }
 
-    while (1) {
-        uint32_t current_time_ms = esp_timer_get_time() / 1000;
+    // Take ownership of whatever DISPATCH staged this tick, and of the
+    // templates edited since the last one. Both arrive lock-free: staged
+    // edits through a ring, templates as published pointers. This never blocks.
+    int64_t wait_start_us = MotionPlatform::now_us();
+    apply_staged_edits(current_time_us);
+    adopt_published_templates();
+    uint32_t wait_us = static_cast<uint32_t>(MotionPlatform::now_us() - wait_start_us);
+    m_mixer_wait_total_us.fetch_add(wait_us, std::memory_order_relaxed);
+    if (wait_us > m_mixer_wait_max_us.load(std::memory_order_relaxed)) {
+        m_mixer_wait_max_us.store(wait_us, std::memory_order_relaxed);
+    }
+
+    float manual_angles[GAIT_JOINT_COUNT];
+    const uint32_t manual_written = apply_manual_writes(current_time_us, manual_angles);
 
-        float final_angles[GAIT_JOINT_COUNT];
+    // Check for manual control timeout
+    if (m_is_manual_control_active.load()) {
+        if (current_time_us > m_manual_control_timeout_us) {
+            m_is_manual_control_active.store(false);
+            ESP_LOGI(TAG, "Manual control timed out. Returning to idle behavior.");
+        }
+    }
+
+    if (m_active_actions.empty() && !m_is_manual_control_active.load()) { // Only go home if idle AND not in manual control
+        is_active = false;
         for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
-            final_angles[i] = -1.0f; // -1 indicates not set
+            final_angles[i] = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
+        }
+    } else if (!m_active_actions.empty()) { // Process active actions if any
+        is_active = true;
+        const uint32_t tick_us = mixer_period_us(m_mixer_rate.load(std::memory_order_relaxed));
+
+        // --- Blend all active actions as layers, lowest priority first ---
+        // Insertion sort keeps start order among equal priorities.
+        ActionInstance* order[MAX_ACTIVE_ACTIONS];
+        size_t layer_count = 0;
+        for (auto& instance : m_active_actions) {
+            size_t pos = layer_count++;
+            while (pos > 0 && order[pos - 1]->layer.priority > instance.layer.priority) {
+                order[pos] = order[pos - 1];
+                --pos;
+            }
+            order[pos] = &instance;
         }
 
-        if (xSemaphoreTake(m_actions_mutex, portMAX_DELAY) == pdTRUE) {
-            
-            // Check for manual control timeout
-            if (m_is_manual_control_active.load()) {
-                if (esp_timer_get_time() > m_manual_control_timeout_us) {
-                    m_is_manual_control_active.store(false);
-                    ESP_LOGI(TAG, "Manual control timed out. Returning to idle behavior.");
-                }
+        LayerMixer::Buffer mix;
+        LayerMixer::begin(mix);
+        for (size_t n = 0; n < layer_count; ++n) {
+            ActionInstance& instance = *order[n];
+            float angles[GAIT_JOINT_COUNT];
+            uint32_t produced = evaluate_instance(instance, current_time_us, tick_us, angles);
+            if (instance.entry_ms > 0) {
+                ease_sequence_entry(instance, current_time_us, produced, angles);
+            }
+            if (instance.next_step_count > 0) {
+                // Where the next member of the sequence starts from
+                memcpy(instance.last_pose, angles, sizeof(instance.last_pose));
+                instance.last_pose_mask = produced & instance.layer.joint_mask;
             }
+            LayerMixer::blend(mix, angles, produced & instance.layer.joint_mask, instance.layer.blend,
+                              LayerMixer::instance_weight(instance, current_time_us));
+        }
 
-            if (m_active_actions.empty() && !m_is_manual_control_active.load()) { // Only go home if idle AND not in manual control
-                is_active = false;
-                for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
-                    final_angles[i] = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            if (!(mix.touched & (1u << i))) continue;
+            const auto& limit = ServoCalibration::limits[i];
+            final_angles[i] = std::max(limit.min, std::min(limit.max, mix.angle[i]));
+        }
+    } else { // If active_actions is empty AND not in manual control, final_angles already set to home
+        // If active_actions is empty AND in manual control, do nothing, servos hold last position
+    }
+    // A manual write goes out unless an action drives the joint this tick
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        if ((manual_written & (1u << i)) && final_angles[i] < 0.0f) {
+            final_angles[i] = manual_angles[i];
+        }
+    }
+
+    // --- Action Completion and Removal Logic ---
+    m_active_actions.erase(
+        std::remove_if(m_active_actions.begin(), m_active_actions.end(),
+            [&](ActionInstance& instance) {
+                bool finished = false;
+                int64_t end_us = current_time_us; // Nominal end, for the next member of a sequence
+                if (instance.roles & ACTION_ROLE_HEAD_TRACK) return false; // Never remove head tracking
+                if (instance.fading_out) {
+                    return (current_time_us - instance.fade_out_start_us) >= static_cast<int64_t>(instance.layer.fade_out_ms) * 1000;
                 }
-            } else if (!m_active_actions.empty()) { // Process active actions if any
-                is_active = true;
-                // --- Process all active actions ---
-                for (auto& instance : m_active_actions) {
-                    // --- Handle Head Tracking Action Separately ---
-                    if (strcmp(instance.action.name, "head_track") == 0) {
-                        instance.action.data.gait.params.offset[static_cast<uint8_t>(ServoChannel::HEAD_PAN)] = m_head_tracking_action.action.data.gait.params.offset[static_cast<uint8_t>(ServoChannel::HEAD_PAN)];
-                        instance.action.data.gait.params.offset[static_cast<uint8_t>(ServoChannel::HEAD_TILT)] = m_head_tracking_action.action.data.gait.params.offset[static_cast<uint8_t>(ServoChannel::HEAD_TILT)];
-                    }
 
-                    // --- Switch based on Action Type ---
-                    switch (instance.action.type) {
-                        case ActionType::GAIT_PERIODIC: {
-                            uint32_t period_ms = instance.action.data.gait.gait_period_ms;
-                            if (period_ms == 0) continue;
-
-                            float t = (float)((current_time_ms - instance.start_time_ms) % period_ms) / period_ms;
-
-                            for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
-                                if (final_angles[i] >= 0.0f) continue; // Don't override already set angles
-
-                                float amp = instance.action.data.gait.params.amplitude[i];
-                                float offset = instance.action.data.gait.params.offset[i];
-                                
-                                if (std::abs(amp) > 0.01f || std::abs(offset) > 0.01f) {
-                                    float wave_component = (std::abs(amp) > 0.01f) 
-                                                         ? amp * sin(2 * PI * t + instance.action.data.gait.params.phase_diff[i]) 
-                                                         : 0.0f;
-                                    
-                                    float home_pos = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
-                                    float angle = home_pos + offset + wave_component;
-                                    const auto& limit = ServoCalibration::limits[i];
-                                    final_angles[i] = std::max(limit.min, std::min(limit.max, angle));
-                                }
+                const RegisteredAction& action = *instance.action;
+                if (action.type == ActionType::GAIT_PERIODIC) {
+                    int64_t total_duration_us = static_cast<int64_t>(action.default_steps) * action.data.gait.gait_period_ms * 1000;
+                    if ((current_time_us - instance.start_time_us) >= total_duration_us) {
+                        finished = true;
+                        end_us = instance.start_time_us + total_duration_us;
+                    }
+                } else if (action.type == ActionType::KEYFRAME_SEQUENCE) {
+                    const auto& kf_data = action.data.keyframe;
+                    const auto& target_frame = kf_data.frames[instance.current_keyframe_index];
+                    
+                    int64_t transition_duration_us = static_cast<int64_t>(target_frame.transition_time_ms) * 1000;
+                    if ((current_time_us - instance.transition_start_time_us) >= transition_duration_us) {
+                        // Current frame transition finished, move to next. The next transition
+                        // starts at this one's nominal end so tick quantization doesn't accumulate.
+                        memcpy(instance.start_positions, target_frame.positions, sizeof(instance.start_positions));
+                        instance.current_keyframe_index++;
+                        instance.transition_start_time_us += transition_duration_us;
+
+                        if (instance.current_keyframe_index >= kf_data.frame_count) {
+                            // End of sequence
+                            instance.remaining_steps--;
+                            if (instance.remaining_steps == 0) {
+                                finished = true;
+                                end_us = instance.transition_start_time_us;
+                                // Hold the last frame while the layer fades out
+                                instance.current_keyframe_index = kf_data.frame_count - 1;
+                                instance.transition_start_time_us -= transition_duration_us;
+                            } else {
+                                // Loop sequence
+                                instance.current_keyframe_index = 0;
+                                instance.looped = true;
                             }
-                            break;
                         }
-
-                        case ActionType::KEYFRAME_SEQUENCE: {
-                            const auto& keyframe_data = instance.action.data.keyframe;
-                            if (keyframe_data.frame_count == 0) continue;
-
-                            // Get current and next keyframes
-                            const auto& target_frame = keyframe_data.frames[instance.current_keyframe_index];
-                            uint32_t transition_duration = target_frame.transition_time_ms;
-                            if (transition_duration == 0) transition_duration = 1; // Avoid division by zero
-
-                            // Calculate interpolation progress (alpha)
-                            uint32_t elapsed_in_transition = current_time_ms - instance.transition_start_time_ms;
-                            float linear_alpha = (float)elapsed_in_transition / (float)transition_duration;
-                            linear_alpha = std::max(0.0f, std::min(1.0f, linear_alpha)); // Clamp alpha
-
-                            // Apply cosine easing for smooth acceleration and deceleration
-                            float eased_alpha = 0.5f * (1.0f - cosf(linear_alpha * PI));
-
-                            // Interpolate for each joint
-                            for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
-                                if (final_angles[i] >= 0.0f) continue;
-
-                                float start_pos = instance.start_positions[i];
-                                float target_pos = target_frame.positions[i];
-                                float angle = start_pos + (target_pos - start_pos) * eased_alpha;
-                                
-                                const auto& limit = ServoCalibration::limits[i];
-                                final_angles[i] = std::max(limit.min, std::min(limit.max, angle));
-                            }
-                            break;
+                        if (!finished && instance.spline) {
+                            instance.spline_segment = KeyframeEngine::select_segment(
+                                *instance.spline, instance.current_keyframe_index, instance.looped, instance.remaining_steps);
                         }
                     }
                 }
-            } else { // If active_actions is empty AND not in manual control, final_angles already set to home
-                // If active_actions is empty AND in manual control, do nothing, servos hold last position
-            }
 
-            // --- Action Completion and Removal Logic ---
-            m_active_actions.erase(
-                std::remove_if(m_active_actions.begin(), m_active_actions.end(),
-                    [&](ActionInstance& instance) {
-                        bool finished = false;
-                        if (strcmp(instance.action.name, "head_track") == 0) return false; // Never remove head tracking
+                if (finished) {
+                    const bool fade_out = instance.layer.fade_out_ms > 0;
+                    ESP_LOGI(TAG, "Action '%s' finished%s.", action.name, fade_out ? ", fading out" : " and removed");
+                    if (instance.roles & ACTION_ROLE_TRACKING_TURN) {
+                        m_last_tracking_turn_end_time = current_time_us;
+                    }
+                    if (instance.roles & ACTION_ROLE_BODY_MOVING) {
+                        m_is_head_frozen.store(false);
+                    }
+                    if (m_decision_maker) {
+                        m_decision_maker->post_action_finished(instance.roles, current_time_us);
+                    }
+                    if (instance.next_step_count > 0) {
+                        // The next member of the sequence takes over this slot
+                        start_next_in_sequence(instance, end_us);
+                        return false;
+                    }
+                    if (fade_out) {
+                        // Keep blending the layer until its weight reaches 0
+                        instance.fading_out = true;
+                        instance.fade_out_start_us = current_time_us;
+                        return false;
+                    }
+                }
+                return finished;
+            }),
+        m_active_actions.end()
+    );
 
-                        if (instance.action.type == ActionType::GAIT_PERIODIC) {
-                            uint32_t total_duration_ms = instance.action.default_steps * instance.action.data.gait.gait_period_ms;
-                            if ((current_time_ms - instance.start_time_ms) >= total_duration_ms) {
-                                finished = true;
-                            }
-                        } else if (instance.action.type == ActionType::KEYFRAME_SEQUENCE) {
-                            const auto& kf_data = instance.action.data.keyframe;
-                            const auto& target_frame = kf_data.frames[instance.current_keyframe_index];
-                            
-                            if ((current_time_ms - instance.transition_start_time_ms) >= target_frame.transition_time_ms) {
-                                // Current frame transition finished, move to next
-                                memcpy(instance.start_positions, target_frame.positions, sizeof(instance.start_positions));
-                                instance.current_keyframe_index++;
-                                instance.transition_start_time_ms = current_time_ms;
-
-                                if (instance.current_keyframe_index >= kf_data.frame_count) {
-                                    // End of sequence
-                                    instance.remaining_steps--;
-                                    if (instance.remaining_steps == 0) {
-                                        finished = true;
-                                    } else {
-                                        // Loop sequence
-                                        instance.current_keyframe_index = 0;
-                                    }
-                                }
-                            }
-                        }
+    if (m_active_actions.empty()) {
+        is_active = false;
+    }
 
-                        if (finished) {
-                            ESP_LOGI(TAG, "Action '%s' finished and removed.", instance.action.name);
-                            if (strcmp(instance.action.name, "tracking_L") == 0 || strcmp(instance.action.name, "tracking_R") == 0) {
-                                m_last_tracking_turn_end_time = esp_timer_get_time();
-                            }
-                            if (is_body_moving(instance.action)) {
-                                m_is_head_frozen.store(false);
-                                apply_filter_alpha(m_default_filter_alpha); // Revert alpha to default
-                            }
-                        }
-                        return finished;
-                    }),
-                m_active_actions.end()
-            );
+    publish_active_snapshot();
+
+    // --- Apply final angles to servos in a single batched write ---
+    // The trace record is completed and committed by the executor, which
+    // knows the tick's compute time.
+    MotionTrace::Record& trace = m_trace_record;
+    const MixerRate rate = m_mixer_rate.load(std::memory_order_relaxed);
+    uint32_t driven = 0;
+    float targets[GAIT_JOINT_COUNT];
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        // Joints nobody drives feed the filters where they are held, so a
+        // joint that is picked up again starts from rest.
+        if (final_angles[i] >= 0.0f) driven |= 1u << i;
+        targets[i] = final_angles[i] >= 0.0f ? final_angles[i] : m_follower.position(i);
+    }
+    m_output_filters.set_sample_rate(static_cast<float>(rate));
+    m_output_filters.process(targets);
+    m_follower.step(targets, driven, mixer_period_us(rate) * 1e-6f);
+
+    float channel_angles[GAIT_JOINT_COUNT];
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        channel_angles[i] = NAN; // NaN holds the channel at its last position
+    }
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        if (driven & (1u << i)) {
+            uint8_t channel = m_joint_channel_map[i];
+            channel_angles[channel] = m_follower.position(i);
+            trace.commanded[i] = MotionTrace::encode_angle(final_angles[i]);
+            trace.filtered[i] = MotionTrace::encode_angle(channel_angles[channel]);
+        } else {
+            trace.commanded[i] = MotionTrace::NOT_DRIVEN;
+            trace.filtered[i] = MotionTrace::NOT_DRIVEN;
+        }
+    }
+    m_servo_driver.set_angles(channel_angles);
+
+    trace.time_us = static_cast<uint32_t>(current_time_us);
+    trace.sequence = m_trace_sequence++;
+    trace.wait_us = MotionTrace::saturate_us(wait_us);
+    trace.action_count = 0;
+    for (const auto& instance : m_active_actions) {
+        trace.action_ids[trace.action_count++] = instance.id;
+    }
+    for (int n = trace.action_count; n < MAX_ACTIVE_ACTIONS; ++n) {
+        trace.action_ids[n] = INVALID_ACTION_ID;
+    }
+    trace.flags = (m_is_manual_control_active.load(std::memory_order_relaxed) ? MotionTrace::RECORD_FLAG_MANUAL : 0) |
+                  (m_active_actions.empty() ? MotionTrace::RECORD_FLAG_IDLE : 0);
+}
+
+// Moves running instances and queued sequence members onto the templates
+// editors published since the last tick, so the ones they replace can be
+// freed. Edits keep an action's type and frames; only a deleted override
+// can be replaced by a different kind of action, and an instance running
+// it keeps it, as deleted overrides are never freed.
+void MotionController::adopt_published_templates() {
+    const uint32_t edit_generation = m_action_manager.edit_generation();
+    if (edit_generation == m_seen_edit_generation) return;
+    m_seen_edit_generation = edit_generation;
+    for (auto& instance : m_active_actions) {
+        const RegisteredAction* latest = m_action_manager.get_action(instance.id);
+        if (latest && latest != instance.action && latest->type == instance.action->type &&
+            (latest->type != ActionType::KEYFRAME_SEQUENCE ||
+             latest->data.keyframe.frame_count == instance.action->data.keyframe.frame_count)) {
+            instance.action = latest;
+            if (latest->type == ActionType::GAIT_PERIODIC) {
+                // The oscillator weights derive from the template
+                GaitEngine::load_terms(m_oscillators[instance.oscillator_slot], latest->data.gait);
+            }
+        }
+        for (uint8_t n = 0; n < instance.next_step_count; ++n) {
+            latest = m_action_manager.get_action(instance.next_steps[n].id);
+            if (latest) instance.next_steps[n].action = latest;
+        }
+    }
+}
+
+void MotionController::apply_staged_edits(int64_t now_us) {
+    ActionEdit edit;
+    ActionInstance* sequence = nullptr;  // Where APPEND_TO_SEQUENCE edits go; nullptr once the group is dropped
+    uint8_t sequence_base = 0;           // sequence->next_step_count before the group's steps
+    const char* sequence_name = nullptr; // First member of the group, for the log
+    while (m_action_edits.pop(edit)) {
+        m_edits_applied.fetch_add(1, std::memory_order_relaxed);
+        if (edit.type == ActionEditType::CLEAR_ALL) {
+            m_active_actions.clear();
+            sequence = nullptr;
+            continue;
+        }
+        if (edit.type == ActionEditType::APPEND_TO_SEQUENCE) {
+            if (!sequence) continue; // Its group was dropped, and counted, at an earlier edit
+            if (sequence->next_step_count < MAX_ACTIONS_PER_GROUP - 1) {
+                sequence->next_steps[sequence->next_step_count++] = {edit.action, edit.id};
+            } else {
+                // All or nothing: take back the steps this group already queued
+                sequence->next_step_count = sequence_base;
+                sequence = nullptr;
+                drop_sequence(sequence_name, "no room to queue it behind the running sequence");
+            }
+            continue;
+        }
+        if (edit.type == ActionEditType::START_SEQUENCE) {
+            sequence = nullptr;
+            sequence_name = edit.action->name;
+        }
 
-            if (m_active_actions.empty()) {
-                is_active = false;
+        // A fading-out instance has already finished: a new start crossfades
+        // against it instead of extending it.
+        auto it = std::find_if(m_active_actions.begin(), m_active_actions.end(),
+            [&](const ActionInstance& instance) {
+                return instance.id == edit.id && !instance.fading_out;
+            });
+        if (it == m_active_actions.end()) {
+            ActionInstance* started = start_action_instance(*edit.action, edit.id, now_us);
+            if (edit.type == ActionEditType::START_SEQUENCE) {
+                sequence = started;
+                sequence_base = 0;
+                if (!started) drop_sequence(sequence_name, "no free action slot");
             }
+        } else if (edit.type == ActionEditType::START_SEQUENCE) {
+            // Retriggered while its first member still runs: the group runs
+            // again once that instance, and whatever follows it, has finished
+            sequence_base = it->next_step_count;
+            if (it->next_step_count < MAX_ACTIONS_PER_GROUP - 1) {
+                it->next_steps[it->next_step_count++] = {edit.action, edit.id};
+                sequence = &*it;
+                ESP_LOGI(TAG, "Action '%s' is already active. Sequence queued behind it.", edit.action->name);
+            } else {
+                drop_sequence(sequence_name, "no room to queue it behind the running sequence");
+            }
+        } else if (edit.type == ActionEditType::START_OR_EXTEND) {
+            // Action is already active. Extend its duration.
+            it->remaining_steps += edit.action->default_steps;
+            ESP_LOGI(TAG, "Action '%s' is already active. Extending by %d steps. Total remaining: %d",
+                     edit.action->name, (int)edit.action->default_steps, (int)it->remaining_steps);
+        } else {
+            ESP_LOGW(TAG, "Action '%s' is already active. Ignoring.", edit.action->name);
+        }
+    }
+}
+
+ActionInstance* MotionController::start_action_instance(const RegisteredAction& action, ActionId id, int64_t now_us) {
+    if (m_active_actions.full()) {
+        ESP_LOGW(TAG, "Too many active actions (%d). Action '%s' not started.", MAX_ACTIVE_ACTIONS, action.name);
+        return nullptr;
+    }
+
+    ActionInstance& new_instance = *m_active_actions.acquire();
+    new_instance.oscillator_slot = NO_OSCILLATOR_SLOT;
+    init_action_instance(new_instance, action, id, now_us);
+    new_instance.next_step_count = 0;
+    ESP_LOGI(TAG, "Action '%s' added to active list.", action.name);
+    return &new_instance;
+}
+
+void MotionController::init_action_instance(ActionInstance& new_instance, const RegisteredAction& action, ActionId id,
+                                            int64_t start_us) {
+    uint8_t roles = m_action_manager.get_action_roles(id);
+
+    // If starting a body-moving action, freeze the head to prevent conflict.
+    if (roles & ACTION_ROLE_BODY_MOVING) {
+        m_is_head_frozen.store(true);
+    }
 
-            xSemaphoreGive(m_actions_mutex);
+    new_instance.action = &action;
+    new_instance.id = id;
+    new_instance.roles = roles;
+    new_instance.remaining_steps = action.default_steps;
+    new_instance.start_time_us = start_us;
+    new_instance.layer = m_action_manager.get_action_layer(id);
+    new_instance.fading_out = false;
+    new_instance.entry_ms = 0;
+
+    if (action.type == ActionType::GAIT_PERIODIC) {
+        // A gait following a gait in sequence keeps its slot
+        if (new_instance.oscillator_slot == NO_OSCILLATOR_SLOT) {
+            new_instance.oscillator_slot = free_oscillator_slot();
         }
+        GaitEngine::start_oscillator(m_oscillators[new_instance.oscillator_slot], action.data.gait, start_us);
+    } else {
+        new_instance.oscillator_slot = NO_OSCILLATOR_SLOT;
+    }
+
+    if (action.type == ActionType::KEYFRAME_SEQUENCE) {
+        new_instance.current_keyframe_index = 0;
+        new_instance.transition_start_time_us = new_instance.start_time_us;
+        new_instance.looped = false;
+        new_instance.spline = m_action_manager.get_keyframe_spline(id);
+        if (new_instance.spline) {
+            new_instance.spline_segment = KeyframeEngine::select_segment(
+                *new_instance.spline, 0, false, new_instance.remaining_steps);
+        }
+        // Initialize start positions to calibrated home for the first transition
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            new_instance.start_positions[i] = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
+        }
+    }
+
+    is_active = true; // Set active flag
+}
+
+// Turns a finished sequence member into the next one, in the same slot and
+// on the same tick. It starts at the finished member's nominal end and, for
+// keyframes, from the pose that member output last, so the joints carry on
+// from where they are: no fade, no idle tick and no detour through home.
+// Slots are not released: whatever no live instance names is free. There
+// is a slot per possible instance, so one is always free.
+static_assert(MAX_ACTIVE_ACTIONS <= 32, "Oscillator slots are tracked in a 32-bit mask");
+
+uint8_t MotionController::free_oscillator_slot() const {
+    uint32_t used = 0;
+    for (const auto& instance : m_active_actions) {
+        if (instance.oscillator_slot != NO_OSCILLATOR_SLOT) used |= 1u << instance.oscillator_slot;
+    }
+    uint8_t slot = 0;
+    while (used & (1u << slot)) ++slot;
+    return slot;
+}
+
+void MotionController::drop_sequence(const char* first_name, const char* reason) {
+    m_sequences_dropped.fetch_add(1, std::memory_order_relaxed);
+    ESP_LOGW(TAG, "Sequence starting with '%s' dropped: %s.", first_name, reason);
+}
 
-        // --- Apply final angles to servos ---
+void MotionController::start_next_in_sequence(ActionInstance& instance, int64_t start_us) {
+    const SequenceStep next = instance.next_steps[0];
+    const uint8_t remaining = instance.next_step_count - 1;
+    memmove(instance.next_steps, instance.next_steps + 1, remaining * sizeof(SequenceStep));
+
+    init_action_instance(instance, *next.action, next.id, start_us);
+    instance.next_step_count = remaining;
+    if (next.action->type == ActionType::KEYFRAME_SEQUENCE) {
         for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
-            if (final_angles[i] >= 0.0f) {
-                uint8_t channel = m_joint_channel_map[i];
-                float filtered_angle = m_angle_filters[i].apply(final_angles[i]);
-                m_servo_driver.set_angle(channel, static_cast<uint16_t>(filtered_angle));
-                vTaskDelay(pdMS_TO_TICKS(1));
+            if (instance.last_pose_mask & (1u << i)) {
+                instance.start_positions[i] = instance.last_pose[i];
             }
         }
+    } else {
+        // A gait starts from its own phase 0 pose; ease in from last_pose instead
+        instance.entry_ms = std::max(instance.layer.fade_in_ms, SEQUENCE_GAIT_ENTRY_MS);
+        instance.entry_pending = true;
+    }
+    instance.layer.fade_in_ms = 0;
+    ESP_LOGI(TAG, "Action '%s' follows in sequence, %d more after it.", next.action->name, (int)remaining);
+}
 
-        vTaskDelay(pdMS_TO_TICKS(control_period_ms));
+// The offset is sized on the first tick so that tick's output is last_pose
+// exactly, then fades out with the same Hermite weight as a spline entry.
+void MotionController::ease_sequence_entry(ActionInstance& instance, int64_t now_us, uint32_t produced,
+                                           float (&angles)[GAIT_JOINT_COUNT]) {
+    const float u = static_cast<float>(now_us - instance.start_time_us) / (instance.entry_ms * 1000.0f);
+    if (u >= 1.0f) {
+        instance.entry_ms = 0;
+        return;
+    }
+    const float weight = KeyframeEngine::entry_offset_weight(std::max(u, 0.0f));
+    if (instance.entry_pending) {
+        instance.entry_pending = false;
+        const uint32_t joints = produced & instance.last_pose_mask;
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            instance.entry_offset[i] = (joints & (1u << i)) ? (instance.last_pose[i] - angles[i]) / weight : 0.0f;
+        }
     }
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        angles[i] += weight * instance.entry_offset[i];
+    }
+}
+
+void MotionController::publish_active_snapshot() {
+    ActiveActionSnapshot snapshot = {};
+    for (const auto& instance : m_active_actions) {
+        if (instance.fading_out) continue; // Finished, only its fade is still blended
+        if (snapshot.count >= MAX_ACTIVE_ACTIONS) break;
+        ActiveActionInfo& info = snapshot.actions[snapshot.count++];
+        memcpy(info.name, instance.action->name, sizeof(info.name));
+        info.id = instance.id;
+        info.roles = instance.roles;
+        info.is_atomic = instance.action->is_atomic;
+    }
+    m_active_snapshot.publish(snapshot);
 }
 
 void MotionController::home(HomeMode mode, const std::vector<ServoChannel>& channels) {
@@ -599,183 +1074,169 @@ void MotionController::home(HomeMode mode, const std::vector<ServoChannel>& chan
         }
 
         if (should_home) {
-            m_servo_driver.set_angle(i, static_cast<uint16_t>(ServoCalibration::get_home_pos(current_channel)));
+            queue_manual_write({i, ServoCalibration::get_home_pos(current_channel), false});
         }
     }
-    vTaskDelay(pdMS_TO_TICKS(100));
 }
 
 void MotionController::set_single_servo(uint8_t channel, float angle) {
-
-    m_servo_driver.set_angle(channel, angle);
-
-    m_is_manual_control_active.store(true);
-
-    m_manual_control_timeout_us = esp_timer_get_time() + 120 * 1000 * 1000; // 2 minutes timeout
+    queue_manual_write({channel, angle, true});
 }
-// --- Face Tracking Task ---
-void MotionController::face_tracking_task() {
-    ESP_LOGI(TAG, "Face tracking task running...");
-
-    const int control_period_ms = 50; // 20Hz control rate
-    const float Kp = 0.08f, Kd = 0.04f; // PD gains
-    const int deadzone_pixels = 5;      // Deadzone in pixels
-    const float delta_limit = 10.0f;      // The single-frame movement limit
-
-    const int screen_center_x = 640 / 2;
-    const int screen_center_y = 480 / 2;
 
-    FaceLocation last_processed_location = {0, 0, 0, 0, false};
-
-    while (1) {
-        vTaskDelay(pdMS_TO_TICKS(control_period_ms));
-
-        bool new_data_received = false;
-        FaceLocation current_face_location;
-
-        // Always try to get the latest face location
-        if (xQueueReceive(m_face_location_queue, &current_face_location, 0) == pdTRUE) {
-            new_data_received = true;
-            if (m_decision_maker) {
-                m_decision_maker->set_face_location(current_face_location);
-            }
-            last_processed_location = current_face_location;
-        } else {
-            // If no new data, use the last known location for decision making, but don't move
-            current_face_location = last_processed_location;
-        }
+void MotionController::queue_manual_write(const ManualServoWrite& write) {
+    if (!m_manual_writes.push(write)) {
+        ESP_LOGW(TAG, "Manual write queue is full. Write to channel %d dropped.", write.channel);
+    }
+}
 
-        // If face is lost for a while, reset detected state
-        if (!current_face_location.detected && last_processed_location.detected) {
-             // Potentially add a timer here to only reset after a few frames of no detection
-            last_processed_location.detected = false;
-        }
-        
-        bool head_track_is_active = false;
-        if (xSemaphoreTake(m_actions_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-            for (const auto& instance : m_active_actions) {
-                if (strcmp(instance.action.name, "head_track") == 0) {
-                    head_track_is_active = true;
-                    break;
-                }
-            }
-            xSemaphoreGive(m_actions_mutex);
+// Takes the manual writes queued since the last tick into angles, by joint,
+// and returns the joints they set. A written joint's output filter and
+// follower are put at rest there, so the write is sent as it is and later
+// motion starts from it. MIXER stage only.
+uint32_t MotionController::apply_manual_writes(int64_t now_us, float (&angles)[GAIT_JOINT_COUNT]) {
+    uint32_t written = 0;
+    ManualServoWrite write;
+    while (m_manual_writes.pop(write)) {
+        int joint = 0;
+        while (joint < GAIT_JOINT_COUNT && m_joint_channel_map[joint] != write.channel) {
+            ++joint;
         }
-
-        if (!head_track_is_active || m_is_head_frozen.load()) {
-            if (m_is_tracking_active.load()) {
-                m_pid_pan_error_last = 0;
-                m_pid_tilt_error_last = 0;
-                m_is_tracking_active.store(false);
-            }
+        if (joint == GAIT_JOINT_COUNT) {
+            ESP_LOGE(TAG, "Invalid channel for manual write: %d", write.channel);
             continue;
         }
-
-        if (!new_data_received) {
-            continue;
+        const auto& limit = ServoCalibration::limits[joint];
+        angles[joint] = std::max(limit.min, std::min(limit.max, write.angle));
+        m_output_filters.reset(joint, angles[joint]);
+        m_follower.reset(joint, angles[joint]);
+        written |= 1u << joint;
+        if (write.manual_control) {
+            m_is_manual_control_active.store(true);
+            m_manual_control_timeout_us = now_us + 120 * 1000 * 1000; // 2 minutes timeout
         }
+    }
+    return written;
+}
+// --- TRACKING Stage ---
+// Handles every face report that arrived since the last tick.
+void MotionController::run_tracking_stage() {
+    FaceLocation face;
+    while (m_face_locations.pop(face)) {
+        track_face(face);
+    }
+}
 
-        if (current_face_location.w > 30 && current_face_location.h > 30) {
-            m_is_tracking_active.store(true);
-        } else {
-            m_is_tracking_active.store(false);
-        }
+// Drops queued reports and recentres the head, for STOP. Executor only.
+void MotionController::drop_face_locations() {
+    FaceLocation dropped;
+    while (m_face_locations.pop(dropped)) {
+    }
+    stop_face_track(MotionPlatform::now_us());
+}
 
-        if (!m_is_tracking_active.load()) {
-            m_pid_pan_error_last = 0;
-            m_pid_tilt_error_last = 0;
-            m_increment_was_limited_last_cycle = false;
-            continue;
-        }
+// Turns one face report into a bearing, updates the bearing filters and
+// publishes the new head prediction for the mixer.
+void MotionController::track_face(const FaceLocation& face) {
+    if (m_decision_maker) {
+        m_decision_maker->set_face_location(face);
+    }
 
-        int error_pan = screen_center_x - (current_face_location.x + current_face_location.w / 2);
-        if (std::abs(error_pan) < deadzone_pixels) { error_pan = 0; }
-        float derivative_pan = error_pan - m_pid_pan_error_last;
-        float output_pan = Kp * error_pan + Kd * derivative_pan;
-        m_pid_pan_error_last = error_pan;
+    ActiveActionSnapshot active = read_active_snapshot();
+    if (!has_active_role(active, ACTION_ROLE_HEAD_TRACK) || m_is_head_frozen.load()) {
+        stop_face_track(MotionPlatform::now_us());
+        return;
+    }
+    if (!face.detected || face.w <= 30 || face.h <= 30) {
+        stop_face_track(MotionPlatform::now_us());
+        return;
+    }
 
-        int error_tilt = (current_face_location.y + current_face_location.h / 2) - screen_center_y;
-        if (std::abs(error_tilt) < deadzone_pixels) { error_tilt = 0; }
-        float derivative_tilt = error_tilt - m_pid_tilt_error_last;
-        float output_tilt = Kp * 0.6f * error_tilt + Kd * derivative_tilt;
-        m_pid_tilt_error_last = error_tilt;
+    // Where the face was when the camera saw it, relative to the body
+    const int64_t capture_us = face.timestamp_us - HeadTrack::CAPTURE_LATENCY_US;
+    float head_pan, head_tilt;
+    head_offset_at(capture_us, head_pan, head_tilt);
+    const float pan = head_pan + (HeadTrack::FRAME_CENTER_X - (face.x + face.w / 2)) * HeadTrack::DEG_PER_PIXEL;
+    const float tilt = head_tilt + ((face.y + face.h / 2) - HeadTrack::FRAME_CENTER_Y) * HeadTrack::DEG_PER_PIXEL;
+
+    if (!m_is_tracking_active.load()) {
+        m_face_pan.reset(pan);
+        m_face_tilt.reset(tilt);
+        m_is_tracking_active.store(true);
+    } else {
+        // Real spacing of the reports, not a nominal camera period
+        const float dt = std::max(1e-3f, static_cast<float>(capture_us - m_last_face_capture_us) * 1e-6f);
+        m_face_pan.update(pan, dt);
+        m_face_tilt.update(tilt, dt);
+    }
+    m_last_face_capture_us = capture_us;
+
+    // Out of head travel: turn the body after the face
+    const int64_t COOLDOWN_PERIOD_US = 3000000; // 3 seconds
+    if (!has_active_role(active, ACTION_ROLE_TRACKING_TURN) &&
+        (MotionPlatform::now_us() - m_last_tracking_turn_end_time) > COOLDOWN_PERIOD_US) {
+        motion_command_t turn = {};
+        if (m_face_pan.value() <= -HeadTrack::PAN_LIMIT) { // At right limit
+            turn.motion_type = MOTION_TRACKING_R;
+            queue_command(turn);
+            m_face_pan.shift(HeadTrack::TRACKING_TURN_DEG);
+        } else if (m_face_pan.value() >= HeadTrack::PAN_LIMIT) { // At left limit
+            turn.motion_type = MOTION_TRACKING_L;
+            queue_command(turn);
+            m_face_pan.shift(-HeadTrack::TRACKING_TURN_DEG);
+        }
+    }
 
-        if (!std::isfinite(output_pan)) { output_pan = 0.0f; }
-        if (!std::isfinite(output_tilt)) { output_tilt = 0.0f; }
+    // In force from now: the report reaches the tracker after its receipt
+    publish_head_track({m_face_pan.value(), m_face_tilt.value(), m_face_pan.rate(), m_face_tilt.rate(), capture_us},
+                       MotionPlatform::now_us());
+}
 
-        bool is_delta_limited_this_cycle = false;
-        if (output_pan > delta_limit)  { output_pan = delta_limit;  is_delta_limited_this_cycle = true; }
-        if (output_pan < -delta_limit) { output_pan = -delta_limit; is_delta_limited_this_cycle = true; }
-        if (output_tilt > delta_limit * 0.6f) { output_tilt = delta_limit * 0.6f; is_delta_limited_this_cycle = true; }
-        if (output_tilt < -delta_limit * 0.6f){ output_tilt = -delta_limit * 0.6f; is_delta_limited_this_cycle = true; }
+// Holds the head where it is headed now; the next report starts a new track.
+void MotionController::stop_face_track(int64_t now_us) {
+    if (!m_is_tracking_active.exchange(false)) return;
+    float pan, tilt;
+    m_head_track_history[(m_head_track_history_next + HEAD_TRACK_HISTORY - 1) % HEAD_TRACK_HISTORY]
+        .prediction.evaluate(now_us + HeadTrack::ACTUATION_LEAD_US, pan, tilt);
+    publish_head_track({pan, tilt, 0.0f, 0.0f, now_us}, now_us);
+}
 
-        if (is_delta_limited_this_cycle) {
-            m_increment_was_limited_last_cycle = true;
-        } else {
-            m_increment_was_limited_last_cycle = false;
-        }
+void MotionController::publish_head_track(const HeadTrack::Prediction& prediction, int64_t now_us) {
+    m_head_track_history[m_head_track_history_next] = {now_us, prediction};
+    m_head_track_history_next = (m_head_track_history_next + 1) % HEAD_TRACK_HISTORY;
+    m_head_track_prediction.publish(prediction);
+}
 
-        m_pan_offset += output_pan;
-        m_tilt_offset += output_tilt;
+// The head offsets at time_us. The mixer evaluates the prediction in force
+// ACTUATION_LEAD_US ahead, which is when the head gets there.
+void MotionController::head_offset_at(int64_t time_us, float& pan, float& tilt) const {
+    const int64_t commanded_us = time_us - HeadTrack::ACTUATION_LEAD_US;
+    const PublishedHeadTrack* in_force = nullptr;
+    for (int n = 1; n <= HEAD_TRACK_HISTORY; ++n) {
+        const PublishedHeadTrack& entry =
+            m_head_track_history[(m_head_track_history_next + HEAD_TRACK_HISTORY - n) % HEAD_TRACK_HISTORY];
+        in_force = &entry; // Older than the whole history: the oldest is the best guess
+        if (entry.published_us <= commanded_us) break;
+    }
+    in_force->prediction.evaluate(time_us, pan, tilt);
+}
 
-        if (m_pan_offset < -70.0f) { m_pan_offset = -70.0f; }
-        if (m_pan_offset > 70.0f)  { m_pan_offset = 70.0f;  }
-        if (m_tilt_offset < -40.0f){ m_tilt_offset = -40.0f; }
-        if (m_tilt_offset > 40.0f) { m_tilt_offset = 40.0f;  }
 
-        const int64_t COOLDOWN_PERIOD_US = 3000000; // 3 seconds
-        bool is_turning = false;
-        if (xSemaphoreTake(m_actions_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-            for (const auto& action : m_active_actions) {
-                if (strcmp(action.action.name, "tracking_L") == 0 || strcmp(action.action.name, "tracking_R") == 0) {
-                    is_turning = true;
-                    break;
-                }
-            }
-            xSemaphoreGive(m_actions_mutex);
-        }
-
-        if (!is_turning) {
-            int64_t current_time = esp_timer_get_time();
-            if ((current_time - m_last_tracking_turn_end_time) > COOLDOWN_PERIOD_US) {
-                if (m_pan_offset <= -70.0f) { // At right limit
-                    queue_command({MOTION_TRACKING_R, {}});
-                    m_pan_offset += 4 * delta_limit;
-                } else if (m_pan_offset >= 70.0f) { // At left limit
-                    queue_command({MOTION_TRACKING_L, {}});
-                    m_pan_offset -= 4 * delta_limit;
-                }
-            }
+bool MotionController::has_active_role(const ActiveActionSnapshot& active, uint8_t role) const {
+    for (uint8_t i = 0; i < active.count; ++i) {
+        if (active.actions[i].roles & role) {
+            return true;
         }
-
-        m_head_tracking_action.action.data.gait.params.offset[static_cast<uint8_t>(ServoChannel::HEAD_PAN)] = m_pan_offset;
-        m_head_tracking_action.action.data.gait.params.offset[static_cast<uint8_t>(ServoChannel::HEAD_TILT)] = m_tilt_offset;
     }
+    return false;
 }
 
-
 bool MotionController::is_body_moving(const RegisteredAction& action) const {
-    const char* name = action.name;
-    return (strcmp(name, "walk_forward") == 0 ||
-            strcmp(name, "walk_backward") == 0 ||
-            strcmp(name, "turn_left") == 0 ||
-            strcmp(name, "turn_right") == 0 ||
-            strcmp(name, "tracking_L") == 0 ||
-            strcmp(name, "tracking_R") == 0);
+    ActionId id = m_action_manager.get_action_id(action.name);
+    return (m_action_manager.get_action_roles(id) & ACTION_ROLE_BODY_MOVING) != 0;
 }
 
 bool MotionController::is_body_moving() const {
-    bool moving = false;
-    if (xSemaphoreTake(m_actions_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        for (const auto& instance : m_active_actions) {
-            if (is_body_moving(instance.action)) { // Call the other version of the function
-                moving = true;
-                break;
-            }
-        }
-        xSemaphoreGive(m_actions_mutex);
-    }
-    return moving;
+    return has_active_role(read_active_snapshot(), ACTION_ROLE_BODY_MOVING);
 }
 
 DecisionMaker* MotionController::get_decision_maker() const
@@ -785,43 +1246,5 @@ DecisionMaker* MotionController::get_decision_maker() const
 
 bool MotionController::is_face_tracking_active() const
 {
-    bool is_tracking = false;
-    if (xSemaphoreTake(m_actions_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-        for (const auto& instance : m_active_actions) {
-            if (strcmp(instance.action.name, "head_track") == 0) {
-                is_tracking = true;
-                break;
-            }
-        }
-        xSemaphoreGive(m_actions_mutex);
-    }
-    return is_tracking;
+    return has_active_role(read_active_snapshot(), ACTION_ROLE_HEAD_TRACK);
 }
-
-void MotionController::set_filter_alpha(float alpha) {
-    if (alpha < 0.0f || alpha > 1.0f) {
-        ESP_LOGE(TAG, "Invalid alpha value %.2f. It should be between 0.0 and 1.0.", alpha);
-        return;
-    }
-    for (auto& filter : m_angle_filters) {
-        filter.set_alpha(alpha);
-    }
-    m_default_filter_alpha = alpha; // Update default alpha
-    m_current_filter_alpha = alpha; // Update current alpha
-    ESP_LOGI(TAG, "Set EMA filter alpha to %.2f for all joints.", alpha);
-}
-
-void MotionController::apply_filter_alpha(float alpha) {
-    if (alpha < 0.0f || alpha > 1.0f) {
-        ESP_LOGE(TAG, "Invalid alpha value %.2f. It should be between 0.0 and 1.0.", alpha);
-        return;
-    }
-    if (m_current_filter_alpha != alpha) {
-        for (auto& filter : m_angle_filters) {
-            filter.set_alpha(alpha);
-        }
-        m_current_filter_alpha = alpha;
-        ESP_LOGI(TAG, "Dynamically set EMA filter alpha to %.2f.", alpha);
-    }
-}
-
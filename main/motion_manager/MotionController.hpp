@@ -1,22 +1,26 @@
 #pragma once
 
-#include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
-#include "freertos/semphr.h"
-#include "esp_timer.h"
 #include "driver/servo.hpp"
-#include "config.h"
+#include "motion_manager/MotionCommands.hpp"
+#include "motion_manager/MotionPlatform.hpp"
 #include "motion_manager/Motion_types.hpp"
 #include "motion_manager/ActionManager.hpp"
+#include "motion_manager/CommandTable.hpp"
+#include "motion_manager/CommandQueue.hpp"
 #include "motion_manager/DecisionMaker.hpp" // Include the new header
-#include "motion_manager/EMAFilter.hpp"
+#include "motion_manager/HeadTrackPredictor.hpp"
+#include "motion_manager/JointFilterBank.hpp"
+#include "motion_manager/TrajectoryFollower.hpp"
+#include "motion_manager/MixerTiming.hpp"
+#include "motion_manager/SpscRing.hpp"
+#include "motion_manager/SeqlockBuffer.hpp"
+#include "motion_manager/InstancePool.hpp"
+#include "motion_manager/MpscRing.hpp"
+#include "motion_manager/MotionTraceRecorder.hpp"
 #include <memory>
 #include <string>
 #include <vector>
-#include <map>
 #include <atomic>
-#include <vector>
-#include <string>
 
 class DecisionMaker; // Forward declaration
 
@@ -31,8 +35,12 @@ class MotionController {
 public:
     explicit MotionController(Servo& servo_driver, ActionManager& action_manager);
     ~MotionController();
-    void init();
+    // start_tasks = false leaves the motion executor task unstarted; the
+    // caller then drives it through step() below.
+    void init(bool start_tasks = true);
     bool queue_command(const motion_command_t& cmd);
+    // Manual servo writes, from any task. The mixer sends them on its next
+    // tick, moving the joint there at once rather than along its limits.
     void set_single_servo(uint8_t channel, float angle);
     void home(HomeMode mode = HomeMode::All, const std::vector<ServoChannel>& channels = {});
     bool is_body_moving(const RegisteredAction& action) const;
@@ -41,73 +49,184 @@ public:
     DecisionMaker* get_decision_maker() const;
     bool is_face_tracking_active() const;
 
-    void set_filter_alpha(float alpha);
+    ServoWriteStats get_servo_write_stats() const { return m_servo_driver.get_write_stats(); }
+
+    // Mixer clock control and health. The new rate takes effect on the next
+    // tick. Rates whose period is shorter than the tick budget, servo frame
+    // included, are refused.
+    bool set_mixer_rate(MixerRate rate);
+    MixerRate get_mixer_rate() const { return m_mixer_rate.load(); }
+    MixerTimingStats get_mixer_timing_stats() const { return m_mixer_timing.snapshot(); }
+    void reset_mixer_timing_stats() {
+        m_mixer_timing.reset();
+        m_stage_timing.reset();
+    }
+    StageTimingStats get_stage_timing_stats() const { return m_stage_timing.snapshot(); }
+    ActionSetStats get_action_set_stats() const;
+
+    // Per-tick motion trace (see MotionTrace.hpp). Writing pauses recording
+    // for the duration of the dump; one dump at a time.
+    bool write_motion_trace(const MotionTraceRecorder::Sink& sink);
+    bool save_motion_trace(const char* path);
+    bool clear_motion_trace() { return m_trace.clear(); }
+    MotionCommandStats get_command_stats() const;
 
     motion_command_t get_current_command();
     bool is_idle() {
         return is_active == false;
     }
 
+    // One executor tick at now_us that takes no clock time, for running the
+    // controller on a clock other than the RTOS one (tools/motionsim). Only
+    // valid after init(false), from a single thread at a time.
+    void step(int64_t now_us);
+
 private:
     Servo& m_servo_driver; 
     ActionManager& m_action_manager;
-    QueueHandle_t m_motion_queue; 
-    std::map<uint8_t, std::string> m_gait_command_map; // Map command code to action name
-
-    bool is_active = false;
-    SemaphoreHandle_t m_actions_mutex;
-    std::vector<ActionInstance> m_active_actions;
-    // ---
+    // Commands from any task to the executor's DISPATCH stage, stamped with
+    // when they were queued. A full ring rejects the command instead of blocking.
+    struct QueuedCommand {
+        motion_command_t command;
+        int64_t queued_us;
+    };
+    MpscRing<QueuedCommand, 16> m_motion_commands;
+    std::atomic<uint32_t> m_commands_queued{0};
+    std::atomic<uint32_t> m_commands_dropped{0};
+    std::atomic<uint32_t> m_commands_flushed{0};
+    std::atomic<uint32_t> m_commands_high_water{0};
+    std::atomic<uint32_t> m_commands_deferred{0};
+    std::atomic<uint32_t> m_commands_coalesced{0};
+    std::atomic<uint32_t> m_commands_expired{0};
+    std::atomic<uint32_t> m_command_latency_max_us{0};
+    std::atomic<uint32_t> m_command_latency_last_us{0};
+    int64_t m_tick_oldest_command_us = 0; // Executor only; 0 when the tick dispatched nothing
+    CommandQueue m_deferred_commands; // DISPATCH stage only; commands waiting for an atomic action to end
+    bool m_atomic_staged = false;     // DISPATCH stage only; an atomic action was staged this tick
+    CommandTable m_command_table; // Command code to action or group; rebuilt by DISPATCH after template edits
+
+    std::atomic<bool> is_active{false};
+
+    // --- Active Action Set ---
+    // m_active_actions is owned by the MIXER stage. The DISPATCH stage stages
+    // ActionEdits into m_action_edits, which the mixer applies at the start
+    // of its run, and everyone else reads the published m_active_snapshot.
+    InstancePool<ActionInstance, MAX_ACTIVE_ACTIONS> m_active_actions;
+    // Oscillators of the GAIT_PERIODIC instances, by ActionInstance::oscillator_slot.
+    // One per possible instance, so a gait always gets one.
+    GaitOscillator m_oscillators[MAX_ACTIVE_ACTIONS];
+    SpscRing<ActionEdit, 32> m_action_edits; // Room for a whole sequential group and then some
+    SeqlockBuffer<ActiveActionSnapshot> m_active_snapshot;
+    std::atomic<uint32_t> m_edits_applied{0};
+    std::atomic<uint32_t> m_edits_dropped{0};
+    std::atomic<uint32_t> m_sequences_dropped{0};
+    mutable std::atomic<uint32_t> m_snapshot_retries{0};
+    std::atomic<uint32_t> m_mixer_wait_max_us{0};
+    std::atomic<uint64_t> m_mixer_wait_total_us{0};
+    uint32_t m_seen_edit_generation = 0; // ActionManager::edit_generation() last adopted by the mixer
 
     // Mapping from logical joint to physical servo channel
     uint8_t m_joint_channel_map[GAIT_JOINT_COUNT];
 
     std::atomic<bool> m_interrupt_flag; // Used for global STOP
 
-    // --- New Face Location Queue ---
-    QueueHandle_t m_face_location_queue;
+    // --- Face Locations ---
+    // Producers push from any task; the executor's TRACKING stage pops.
+    MpscRing<FaceLocation, 8> m_face_locations;
+
+    // --- Manual Servo Writes ---
+    // set_single_servo() and home() push from any task; the mixer pops, so
+    // only the executor writes to the servo driver.
+    struct ManualServoWrite {
+        uint8_t channel;
+        float angle;
+        bool manual_control; // Enters manual control; false for home()
+    };
+    MpscRing<ManualServoWrite, 32> m_manual_writes; // Room for two full home() calls
 
     // --- Decision Maker ---
     std::unique_ptr<DecisionMaker> m_decision_maker;
 
-    // --- Angle Filtering ---
-    std::vector<EMAFilter> m_angle_filters;
+    // --- Output Smoothing ---
+    JointFilterBank m_output_filters; // MIXER stage only; per-joint low-pass on the mixer output
+    TrajectoryFollower m_follower;    // MIXER stage only; speed and acceleration limits per joint
 
     void init_joint_channel_map();
-
-    // --- Task Declarations ---
-    void motion_engine_task(); // Renamed to dispatcher task
-    void motion_mixer_task();  // The new mixer task
-    void face_tracking_task(); // New task for face tracking
-
-    // --- Face Tracking Members (some moved to local in task) ---
-    float m_pid_pan_error_last;
-    float m_pid_tilt_error_last;
-    float m_pan_offset;  // Current pan offset for head tracking
-    float m_tilt_offset; // Current tilt offset for head tracking
-    bool m_increment_was_limited_last_cycle;
-    ActionInstance m_head_tracking_action;
+    void queue_manual_write(const ManualServoWrite& write);
+    uint32_t apply_manual_writes(int64_t now_us, float (&angles)[GAIT_JOINT_COUNT]);
+
+    // --- Active Action Set Helpers ---
+    void stage_action_edit(ActionEditType type, const RegisteredAction* action, ActionId id);
+    void dispatch_target(const CommandTable::Target& target, const char* name);
+    void dispatch_command(const motion_command_t& cmd);
+    ActiveActionSnapshot read_active_snapshot() const;
+    void apply_staged_edits(int64_t now_us);
+    void adopt_published_templates();
+    ActionInstance* start_action_instance(const RegisteredAction& action, ActionId id, int64_t now_us);
+    void init_action_instance(ActionInstance& instance, const RegisteredAction& action, ActionId id, int64_t start_us);
+    void start_next_in_sequence(ActionInstance& instance, int64_t start_us);
+    uint8_t free_oscillator_slot() const;
+    void drop_sequence(const char* first_name, const char* reason);
+    void ease_sequence_entry(ActionInstance& instance, int64_t now_us, uint32_t produced, float (&angles)[GAIT_JOINT_COUNT]);
+    bool has_active_role(const ActiveActionSnapshot& active, uint8_t role) const;
+    void publish_active_snapshot();
+
+    // --- Motion Executor ---
+    void motion_executor_task(); // The one motion task: run_tick() on a deadline clock
+    void run_tick(int64_t now_us); // Every stage once, in MotionStage order
+    void run_tracking_stage();
+    void run_dispatch_stage(int64_t deadline_us);
+    void defer_command(const QueuedCommand& queued);
+    void note_dispatched(int64_t queued_us);
+    void record_command_latency();
+    void mixer_tick(int64_t now_us); // MIXER stage: evaluate actions and drive the servos
+    void record_trace(uint32_t compute_us, uint32_t jitter_us); // Commits the record mixer_tick filled
+    uint32_t evaluate_instance(ActionInstance& instance, int64_t now_us, uint32_t tick_us, float (&angles)[GAIT_JOINT_COUNT]);
+    void drop_face_locations();
+    void track_face(const FaceLocation& face);
+    void stop_face_track(int64_t now_us);
+    void publish_head_track(const HeadTrack::Prediction& prediction, int64_t now_us);
+    void head_offset_at(int64_t time_us, float& pan, float& tilt) const;
+
+    // --- Face Tracking Members ---
+    // Face bearings, owned by the TRACKING stage (see HeadTrackPredictor.hpp)
+    HeadTrack::AlphaBetaFilter m_face_pan;
+    HeadTrack::AlphaBetaFilter m_face_tilt;
+    int64_t m_last_face_capture_us = 0;
+    // Predictions the tracker published recently and when, to tell where the
+    // head was when a face was captured. Executor only.
+    struct PublishedHeadTrack {
+        int64_t published_us;
+        HeadTrack::Prediction prediction;
+    };
+    static constexpr int HEAD_TRACK_HISTORY = 4;
+    PublishedHeadTrack m_head_track_history[HEAD_TRACK_HISTORY] = {};
+    int m_head_track_history_next = 0;
+    RegisteredAction m_head_tracking_action; // Template of the head_track pseudo-action, fixed after init
+    ActionId m_head_tracking_id;
+    // Head offsets over time, published by the face tracker. The mixer
+    // evaluates them at every tick on top of the head_track template instead
+    // of the template's own offsets.
+    SeqlockBuffer<HeadTrack::Prediction> m_head_track_prediction;
     std::atomic<bool> m_is_tracking_active;
     int64_t m_last_tracking_turn_end_time;
     std::atomic<bool> m_is_head_frozen;
     std::atomic<bool> m_is_manual_control_active; // New: Flag for manual servo control
-    int64_t m_manual_control_timeout_us; // New: Timeout for manual control
+    int64_t m_manual_control_timeout_us; // MIXER stage only; timeout for manual control
     std::atomic<bool> m_is_executed{false};
-    float m_default_filter_alpha = 0.8f; // Default alpha for EMA filters
-    float m_current_filter_alpha = 0.8f; // Current alpha applied to filters
 
-private:
+    // --- Mixer Clock ---
+    std::atomic<MixerRate> m_mixer_rate{MixerRate::HZ_50};
+    MixerTimingRecorder m_mixer_timing;
+    StageTimingRecorder m_stage_timing;
+    MotionTraceRecorder m_trace;
+    MotionTrace::Record m_trace_record = {}; // Filled by mixer_tick, committed after the tick
+    uint32_t m_trace_sequence = 0;
 
-    void apply_filter_alpha(float alpha);
+private:
 
     // --- Task Wrappers ---
-    static void start_task_wrapper(void* _this) {
-        static_cast<MotionController*>(_this)->motion_engine_task();
-    }
-    static void start_mixer_task_wrapper(void* _this) {
-        static_cast<MotionController*>(_this)->motion_mixer_task();
-    }
-    static void start_face_tracking_task_wrapper(void* _this) {
-        static_cast<MotionController*>(_this)->face_tracking_task();
+    static void start_executor_task_wrapper(void* _this) {
+        static_cast<MotionController*>(_this)->motion_executor_task();
     }
 };
\ No newline at end of file
@@ -0,0 +1,179 @@
+#include "motion_manager/MotionPack.hpp"
+#include <cstring>
+
+namespace MotionPack {
+
+namespace {
+
+constexpr size_t KEYFRAME_RECORD_BASE = offsetof(RegisteredAction, data) + offsetof(KeyframeActionData, frames);
+constexpr size_t GAIT_RECORD_BASE = offsetof(RegisteredAction, data) + offsetof(GaitActionData, harmonic_terms);
+
+bool name_is_valid(const char* name) {
+    size_t len = strnlen(name, MOTION_NAME_MAX_LEN);
+    return len > 0 && len < MOTION_NAME_MAX_LEN;
+}
+
+const char* validate_action(const Entry& entry, const uint8_t* record) {
+    if (entry.size < KEYFRAME_RECORD_BASE) return "action record too small";
+    // Record offsets are 4-byte aligned, so the record can be read as a RegisteredAction.
+    const RegisteredAction& action = *reinterpret_cast<const RegisteredAction*>(record);
+    if (strncmp(action.name, entry.name, MOTION_NAME_MAX_LEN) != 0) return "record name does not match index";
+    if (action.default_steps == 0) return "action has zero default steps";
+    switch (action.type) {
+        case ActionType::GAIT_PERIODIC:
+            if (entry.size < GAIT_RECORD_BASE) return "gait record too small";
+            if (action.data.gait.gait_period_ms == 0) return "gait period is zero";
+            if (action.data.gait.harmonic_count == 0) return "gait action has no harmonics";
+            if (action.data.gait.harmonic_count > MAX_GAIT_HARMONICS) return "too many harmonics";
+            if (action.data.gait.easing_type > EasingType::EASE_IN_OUT_QUAD) return "unknown easing type";
+            break;
+        case ActionType::KEYFRAME_SEQUENCE:
+            if (action.data.keyframe.frame_count == 0) return "keyframe action has no frames";
+            if (action.data.keyframe.frame_count > MAX_KEYFRAMES_PER_ACTION) return "too many keyframes";
+            if (action.data.keyframe.interpolation > KeyframeInterpolation::CATMULL_ROM) return "unknown interpolation";
+            break;
+        default:
+            return "unknown action type";
+    }
+    if (entry.size != action_record_size(action)) return "record size does not match its contents";
+    return nullptr;
+}
+
+const char* validate_group(const Entry& entry, const uint8_t* record) {
+    if (entry.size != sizeof(RegisteredGroup)) return "group record size mismatch";
+    const RegisteredGroup& group = *reinterpret_cast<const RegisteredGroup*>(record);
+    if (strncmp(group.name, entry.name, MOTION_NAME_MAX_LEN) != 0) return "record name does not match index";
+    if (group.mode != ExecutionMode::SEQUENTIAL && group.mode != ExecutionMode::SIMULTANEOUS) return "unknown group mode";
+    if (group.action_count == 0 || group.action_count > MAX_ACTIONS_PER_GROUP) return "bad group member count";
+    for (uint8_t i = 0; i < group.action_count; ++i) {
+        if (!name_is_valid(group.action_names[i])) return "bad group member name";
+    }
+    return nullptr;
+}
+
+const char* validate(const uint8_t* base, size_t size) {
+    if (base == nullptr || size < sizeof(Header)) return "pack too small";
+    if (reinterpret_cast<uintptr_t>(base) % RECORD_ALIGN != 0) return "pack not aligned";
+    const Header& header = *reinterpret_cast<const Header*>(base);
+    if (header.magic != MAGIC) return "bad magic";
+    if (header.version != VERSION) return "unsupported version";
+    if (header.header_size != sizeof(Header)) return "bad header size";
+    if (header.joint_count != GAIT_JOINT_COUNT || header.name_len != MOTION_NAME_MAX_LEN ||
+        header.max_keyframes != MAX_KEYFRAMES_PER_ACTION || header.max_harmonics != MAX_GAIT_HARMONICS) {
+        return "pack built for a different action layout";
+    }
+    if (header.total_size > size) return "pack truncated";
+    if (header.index_offset < header.header_size || header.index_offset % RECORD_ALIGN != 0) return "bad index offset";
+
+    size_t index_end = header.index_offset + static_cast<size_t>(header.entry_count) * sizeof(Entry);
+    if (index_end + TAIL_GUARD_SIZE > header.total_size) return "index out of bounds";
+    size_t records_end = header.total_size - TAIL_GUARD_SIZE;
+
+    if (crc32(base + header.header_size, header.total_size - header.header_size) != header.crc32) return "CRC mismatch";
+
+    const Entry* entries = reinterpret_cast<const Entry*>(base + header.index_offset);
+    for (uint16_t i = 0; i < header.entry_count; ++i) {
+        const Entry& entry = entries[i];
+        if (!name_is_valid(entry.name)) return "bad entry name";
+        if (i > 0 && strncmp(entries[i - 1].name, entry.name, MOTION_NAME_MAX_LEN) >= 0) return "index not sorted or has duplicates";
+        if (entry.offset % RECORD_ALIGN != 0) return "record not aligned";
+        if (entry.offset < index_end || entry.offset > records_end || entry.size > records_end - entry.offset) return "record out of bounds";
+
+        const char* error = nullptr;
+        if (entry.kind == EntryKind::ACTION) {
+            error = validate_action(entry, base + entry.offset);
+        } else if (entry.kind == EntryKind::GROUP) {
+            error = validate_group(entry, base + entry.offset);
+        } else {
+            error = "unknown entry kind";
+        }
+        if (error) return error;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+size_t action_record_size(const RegisteredAction& action) {
+    if (action.type == ActionType::KEYFRAME_SEQUENCE) {
+        size_t size = KEYFRAME_RECORD_BASE + static_cast<size_t>(action.data.keyframe.frame_count) * sizeof(Keyframe);
+        return (size + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+    }
+    size_t size = GAIT_RECORD_BASE + static_cast<size_t>(action.data.gait.harmonic_count) * sizeof(motion_params_t);
+    return (size + RECORD_ALIGN - 1) & ~(RECORD_ALIGN - 1);
+}
+
+void copy_action(RegisteredAction& dst, const RegisteredAction& src) {
+    size_t size = action_record_size(src);
+    if (size > sizeof(RegisteredAction)) {
+        size = sizeof(RegisteredAction);
+    }
+    memset(&dst, 0, sizeof(RegisteredAction));
+    memcpy(&dst, &src, size);
+}
+
+// Plain bitwise CRC-32 (IEEE 802.3, reflected). Only run when a pack is opened.
+uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc) {
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return ~crc;
+}
+
+bool View::open(const void* base, size_t size, const char** error) {
+    close();
+    const uint8_t* bytes = static_cast<const uint8_t*>(base);
+    const char* reason = validate(bytes, size);
+    if (reason) {
+        if (error) *error = reason;
+        return false;
+    }
+    m_base = bytes;
+    m_header = reinterpret_cast<const Header*>(bytes);
+    m_entries = reinterpret_cast<const Entry*>(bytes + m_header->index_offset);
+    return true;
+}
+
+void View::close() {
+    m_base = nullptr;
+    m_header = nullptr;
+    m_entries = nullptr;
+}
+
+int View::find(const char* name) const {
+    int lo = 0;
+    int hi = static_cast<int>(entry_count()) - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strncmp(m_entries[mid].name, name, MOTION_NAME_MAX_LEN);
+        if (cmp == 0) return mid;
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return -1;
+}
+
+const RegisteredAction* View::action_at(uint16_t index) const {
+    if (index >= entry_count() || m_entries[index].kind != EntryKind::ACTION) return nullptr;
+    return reinterpret_cast<const RegisteredAction*>(m_base + m_entries[index].offset);
+}
+
+const RegisteredAction* View::find_action(const char* name) const {
+    int index = find(name);
+    return index < 0 ? nullptr : action_at(static_cast<uint16_t>(index));
+}
+
+const RegisteredGroup* View::find_group(const char* name) const {
+    int index = find(name);
+    if (index < 0 || m_entries[index].kind != EntryKind::GROUP) return nullptr;
+    return reinterpret_cast<const RegisteredGroup*>(m_base + m_entries[index].offset);
+}
+
+} // namespace MotionPack
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "motion_manager/Motion_types.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Binary motion pack: a read-only action library that the firmware uses in
+// place, straight from memory-mapped flash. The same code validates packs on
+// the host (tools/mpack) and on the device.
+//
+//   Header
+//   Entry[entry_count]     index, sorted by name; the position is the pack-local id
+//   records                variable length, 4-byte aligned
+//   tail guard             sizeof(RegisteredAction) zero bytes
+//
+// An action record is a RegisteredAction cut off after its last used byte:
+// gait records end after the last harmonic term, keyframe records after the
+// last frame.
+// Pack actions are therefore handed out as ordinary RegisteredAction pointers,
+// and the tail guard keeps even a full-size read of the last record inside the
+// pack. A group record is a whole RegisteredGroup. All fields are little-endian.
+namespace MotionPack {
+
+constexpr uint32_t MAGIC = 0x4B504D4F; // "OMPK"
+constexpr uint16_t VERSION = 2;
+constexpr size_t RECORD_ALIGN = 4;
+constexpr size_t TAIL_GUARD_SIZE = sizeof(RegisteredAction);
+
+enum class EntryKind : uint8_t {
+    ACTION = 1,
+    GROUP = 2
+};
+
+struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint16_t entry_count;
+    uint8_t joint_count;      // GAIT_JOINT_COUNT the pack was built for
+    uint8_t name_len;         // MOTION_NAME_MAX_LEN the pack was built for
+    uint16_t max_keyframes;   // MAX_KEYFRAMES_PER_ACTION the pack was built for
+    uint8_t max_harmonics;    // MAX_GAIT_HARMONICS the pack was built for
+    uint8_t reserved;
+    uint32_t index_offset;    // From the start of the pack
+    uint32_t total_size;      // Whole pack including the tail guard
+    uint32_t crc32;           // Over bytes [header_size, total_size)
+};
+static_assert(sizeof(Header) == 28, "MotionPack::Header layout changed");
+
+struct Entry {
+    char name[MOTION_NAME_MAX_LEN];
+    uint32_t offset;          // From the start of the pack
+    uint32_t size;
+    EntryKind kind;
+    uint8_t reserved[3];
+};
+static_assert(sizeof(Entry) == MOTION_NAME_MAX_LEN + 12, "MotionPack::Entry layout changed");
+
+// Bytes of a RegisteredAction that carry data for this action.
+size_t action_record_size(const RegisteredAction& action);
+
+// Copies only the record bytes of src and zeroes the rest of dst. Use this
+// instead of plain assignment when src may point into a pack.
+void copy_action(RegisteredAction& dst, const RegisteredAction& src);
+
+uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0);
+
+// Read-only view of a pack in memory. open() validates the whole pack once;
+// afterwards lookups are a binary search over the index and return pointers
+// into the pack memory, which must outlive the view.
+class View {
+public:
+    // On failure *error (if given) names the first problem found.
+    bool open(const void* base, size_t size, const char** error = nullptr);
+    void close();
+    bool is_open() const { return m_header != nullptr; }
+
+    uint16_t entry_count() const { return m_header ? m_header->entry_count : 0; }
+    const Entry& entry(uint16_t index) const { return m_entries[index]; }
+    uint32_t total_size() const { return m_header ? m_header->total_size : 0; }
+
+    int find(const char* name) const; // Index of the entry, or -1
+    const RegisteredAction* action_at(uint16_t index) const; // nullptr if the entry is not an action
+    const RegisteredAction* find_action(const char* name) const;
+    const RegisteredGroup* find_group(const char* name) const;
+
+private:
+    const uint8_t* m_base = nullptr;
+    const Header* m_header = nullptr;
+    const Entry* m_entries = nullptr;
+};
+
+} // namespace MotionPack
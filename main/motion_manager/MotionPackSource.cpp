@@ -0,0 +1,101 @@
+#include "motion_manager/MotionPackSource.hpp"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include <cstdio>
+
+static const char* TAG = "MotionPackSource";
+
+MotionPackSource::~MotionPackSource() {
+    release();
+}
+
+bool MotionPackSource::map_partition(const char* label) {
+    release();
+    const esp_partition_t* partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    if (partition == nullptr) {
+        ESP_LOGI(TAG, "No '%s' partition, skipping motion pack.", label);
+        return false;
+    }
+
+    // Read the header first so only the pack itself gets mapped.
+    MotionPack::Header header;
+    if (esp_partition_read(partition, 0, &header, sizeof(header)) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to read motion pack header from '%s'.", label);
+        return false;
+    }
+    if (header.magic != MotionPack::MAGIC) {
+        ESP_LOGI(TAG, "Partition '%s' holds no motion pack.", label);
+        return false;
+    }
+    if (header.total_size < sizeof(header) || header.total_size > partition->size) {
+        ESP_LOGE(TAG, "Motion pack in '%s' claims %u bytes, partition has %u.", label,
+                 (unsigned)header.total_size, (unsigned)partition->size);
+        return false;
+    }
+
+    const void* mapped = nullptr;
+    esp_err_t err = esp_partition_mmap(partition, 0, header.total_size, ESP_PARTITION_MMAP_DATA, &mapped, &m_mmap_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to map '%s' (%s).", label, esp_err_to_name(err));
+        return false;
+    }
+    m_mapped = true;
+
+    const char* error = nullptr;
+    if (!m_view.open(mapped, header.total_size, &error)) {
+        ESP_LOGE(TAG, "Motion pack in '%s' rejected: %s", label, error);
+        release();
+        return false;
+    }
+    ESP_LOGI(TAG, "Mapped motion pack from '%s': %u entries, %u bytes.", label,
+             (unsigned)m_view.entry_count(), (unsigned)m_view.total_size());
+    return true;
+}
+
+bool MotionPackSource::load_file(const char* path) {
+    release();
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) {
+        ESP_LOGI(TAG, "No motion pack at %s.", path);
+        return false;
+    }
+
+    bool ok = false;
+    long size = 0;
+    if (fseek(file, 0, SEEK_END) == 0 && (size = ftell(file)) > 0 && fseek(file, 0, SEEK_SET) == 0) {
+        m_buffer = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+        if (m_buffer == nullptr) {
+            ESP_LOGE(TAG, "Out of PSRAM for a %ld byte motion pack.", size);
+        } else if (fread(m_buffer, 1, size, file) != static_cast<size_t>(size)) {
+            ESP_LOGE(TAG, "Short read on %s.", path);
+        } else {
+            ok = true;
+        }
+    }
+    fclose(file);
+
+    const char* error = nullptr;
+    if (ok && !m_view.open(m_buffer, size, &error)) {
+        ESP_LOGE(TAG, "Motion pack %s rejected: %s", path, error);
+        ok = false;
+    }
+    if (!ok) {
+        release();
+        return false;
+    }
+    ESP_LOGI(TAG, "Loaded motion pack %s: %u entries, %u bytes.", path,
+             (unsigned)m_view.entry_count(), (unsigned)m_view.total_size());
+    return true;
+}
+
+void MotionPackSource::release() {
+    m_view.close();
+    if (m_mapped) {
+        esp_partition_munmap(m_mmap_handle);
+        m_mapped = false;
+    }
+    if (m_buffer) {
+        heap_caps_free(m_buffer);
+        m_buffer = nullptr;
+    }
+}
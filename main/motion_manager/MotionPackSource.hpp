@@ -0,0 +1,28 @@
+#pragma once
+
+#include "motion_manager/MotionPack.hpp"
+#include "esp_partition.h"
+
+// Brings a motion pack into the address space and keeps it there. A pack in a
+// data partition is memory-mapped and read through the flash cache with no
+// copy; a pack file (e.g. on the SD card) is read once into PSRAM. Either way
+// the records are used in place, without parsing.
+class MotionPackSource {
+public:
+    MotionPackSource() = default;
+    ~MotionPackSource();
+    MotionPackSource(const MotionPackSource&) = delete;
+    MotionPackSource& operator=(const MotionPackSource&) = delete;
+
+    bool map_partition(const char* label = "motions");
+    bool load_file(const char* path);
+    void release();
+
+    const MotionPack::View& view() const { return m_view; }
+
+private:
+    MotionPack::View m_view;
+    esp_partition_mmap_handle_t m_mmap_handle = 0;
+    bool m_mapped = false;
+    void* m_buffer = nullptr;
+};
@@ -0,0 +1,35 @@
+#include "motion_manager/MotionPlatform.hpp"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+namespace MotionPlatform {
+
+int64_t now_us() {
+    return esp_timer_get_time();
+}
+
+void delay_ms(uint32_t ms) {
+    vTaskDelay(pdMS_TO_TICKS(ms));
+}
+
+uint32_t tick_count() {
+    return static_cast<uint32_t>(xTaskGetTickCount());
+}
+
+bool delay_until(uint32_t& last_wake, uint32_t period_ms) {
+    TickType_t wake = static_cast<TickType_t>(last_wake);
+    bool on_time = xTaskDelayUntil(&wake, pdMS_TO_TICKS(period_ms)) == pdTRUE;
+    last_wake = static_cast<uint32_t>(wake);
+    return on_time;
+}
+
+TaskHandle start_task(TaskFunction function, const char* name, uint32_t stack_size, void* arg, uint32_t priority, int core) {
+    TaskHandle_t handle = NULL;
+    if (xTaskCreatePinnedToCore(function, name, stack_size, arg, priority, &handle, core) != pdPASS) {
+        return nullptr;
+    }
+    return handle;
+}
+
+} // namespace MotionPlatform
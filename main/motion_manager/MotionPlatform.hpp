@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+// The few clock and RTOS services the motion stack needs. The firmware
+// implementation (MotionPlatform.cpp) maps them onto esp_timer and FreeRTOS;
+// the host simulator (tools/motionsim) supplies its own with a virtual clock,
+// so MotionController and ActionManager build and run unchanged on Linux.
+namespace MotionPlatform {
+
+typedef void* TaskHandle;
+typedef void (*TaskFunction)(void* arg);
+
+// Monotonic microseconds since boot.
+int64_t now_us();
+
+// Sleeps the calling task.
+void delay_ms(uint32_t ms);
+
+// Periodic wake-ups on an absolute schedule, like xTaskDelayUntil. last_wake
+// starts at tick_count() and is advanced by period_ms on every call. Returns
+// false when the wake time had already passed (an overrun).
+uint32_t tick_count();
+bool delay_until(uint32_t& last_wake, uint32_t period_ms);
+
+// Starts a task pinned to core. Returns nullptr on failure.
+TaskHandle start_task(TaskFunction function, const char* name, uint32_t stack_size, void* arg, uint32_t priority, int core);
+
+} // namespace MotionPlatform
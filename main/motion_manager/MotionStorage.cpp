@@ -1,12 +1,106 @@
 #include "MotionStorage.hpp"
+#include "motion_manager/MotionPlatform.hpp"
+#include "motion_manager/MotionPack.hpp"
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "esp_log.h"
+#include <cstddef>
 #include <cstring>
+#include <memory>
+
+static_assert(MOTION_NAME_MAX_LEN == NVS_KEY_NAME_MAX_SIZE, "Motion names are used as NVS keys");
 
 static const char* TAG = "MotionStorage";
 
-MotionStorage::MotionStorage(const char* nvs_namespace) : m_nvs_namespace(nvs_namespace) {}
+// Namespace used before actions and groups were split. Whole-struct blobs
+// found there are re-saved as records once by init().
+static const char* LEGACY_NAMESPACE = "motion_db";
+
+// --- Record encoding ---
+// A record is a RecordHeader followed by the payload: an action cut off after
+// its last used byte (MotionPack::action_record_size, the same layout as pack
+// records) or a group cut off after its last member name. Bump the version
+// whenever RegisteredAction or RegisteredGroup changes layout; records of
+// another version are ignored and the built-in definition is used instead.
+static constexpr uint8_t RECORD_VERSION = 2;
+
+enum class RecordKind : uint8_t {
+    ACTION = 1,
+    GROUP = 2
+};
+
+typedef struct {
+    uint8_t version;
+    RecordKind kind;
+    uint16_t payload_size;
+    uint32_t crc32;         // Over the payload
+} RecordHeader;
+
+static constexpr size_t MAX_RECORD_SIZE = sizeof(RecordHeader) + sizeof(RegisteredAction);
+static_assert(sizeof(RegisteredAction) <= UINT16_MAX, "RecordHeader::payload_size is 16-bit");
+
+static size_t group_payload_size(const RegisteredGroup& group) {
+    return offsetof(RegisteredGroup, action_names) + static_cast<size_t>(group.action_count) * MOTION_NAME_MAX_LEN;
+}
+
+// NVS writes a blob as 32-byte entries: a data header, the data, and a blob
+// index entry. Used for the save statistics only.
+static size_t nvs_blob_flash_bytes(size_t blob_size) {
+    return (2 + (blob_size + 31) / 32) * 32;
+}
+
+static esp_err_t write_record(nvs_handle_t handle, const char* key, RecordKind kind,
+                              const void* payload, size_t payload_size, uint8_t* scratch) {
+    RecordHeader header = {};
+    header.version = RECORD_VERSION;
+    header.kind = kind;
+    header.payload_size = static_cast<uint16_t>(payload_size);
+    header.crc32 = MotionPack::crc32(static_cast<const uint8_t*>(payload), payload_size);
+    memcpy(scratch, &header, sizeof(header));
+    memcpy(scratch + sizeof(header), payload, payload_size);
+    return nvs_set_blob(handle, key, scratch, sizeof(header) + payload_size);
+}
+
+// Zeroes out and fills it with the record's payload. Returns the payload size,
+// or 0 if the key is missing or the record is damaged or of another version.
+static size_t read_record(nvs_handle_t handle, const char* key, RecordKind kind,
+                          void* out, size_t out_size, uint8_t* scratch) {
+    size_t blob_size = MAX_RECORD_SIZE;
+    esp_err_t err = nvs_get_blob(handle, key, scratch, &blob_size);
+    if (err != ESP_OK) {
+        if (err != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGE(TAG, "Failed to read '%s'. Error: %s", key, esp_err_to_name(err));
+        }
+        return 0;
+    }
+
+    RecordHeader header;
+    if (blob_size < sizeof(header)) {
+        ESP_LOGW(TAG, "Record '%s' is truncated, ignored.", key);
+        return 0;
+    }
+    memcpy(&header, scratch, sizeof(header));
+    const uint8_t* payload = scratch + sizeof(header);
+    if (header.version != RECORD_VERSION || header.kind != kind) {
+        ESP_LOGW(TAG, "Record '%s' has version %u kind %u, expected version %u kind %u; ignored.", key,
+                 header.version, static_cast<unsigned>(header.kind), RECORD_VERSION, static_cast<unsigned>(kind));
+        return 0;
+    }
+    if (header.payload_size != blob_size - sizeof(header) || header.payload_size > out_size) {
+        ESP_LOGW(TAG, "Record '%s' has a bad payload size (%u), ignored.", key, header.payload_size);
+        return 0;
+    }
+    if (MotionPack::crc32(payload, header.payload_size) != header.crc32) {
+        ESP_LOGW(TAG, "Record '%s' failed its CRC check, ignored.", key);
+        return 0;
+    }
+    memset(out, 0, out_size);
+    memcpy(out, payload, header.payload_size);
+    return header.payload_size;
+}
+
+MotionStorage::MotionStorage(const char* action_namespace, const char* group_namespace)
+    : m_action_namespace(action_namespace), m_group_namespace(group_namespace) {}
 
 MotionStorage::~MotionStorage() {}
 
@@ -20,65 +114,69 @@ bool MotionStorage::init() {
     ESP_ERROR_CHECK(ret);
     ESP_LOGI(TAG, "NVS Flash Initialized.");
     m_initialized = true;
+    migrate_legacy_namespace();
     return true;
 }
 
-// --- Action Management --- 
-bool MotionStorage::save_action(const RegisteredAction& action) {
-    if (!m_initialized) return false;
+void MotionStorage::migrate_legacy_namespace() {
+    std::vector<std::string> keys;
+    if (!list_keys(LEGACY_NAMESPACE, keys) || keys.empty()) {
+        return;
+    }
 
     nvs_handle_t handle;
-    esp_err_t err = nvs_open(m_nvs_namespace, NVS_READWRITE, &handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Error (%s) opening NVS handle!", esp_err_to_name(err));
-        return false;
+    if (nvs_open(LEGACY_NAMESPACE, NVS_READWRITE, &handle) != ESP_OK) {
+        return;
     }
-
-    char key[NVS_KEY_NAME_MAX_SIZE];
-    snprintf(key, sizeof(key), "%s", action.name);
-
-    err = nvs_set_blob(handle, key, &action, sizeof(RegisteredAction));
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to save action '%s'. Error: %s", key, esp_err_to_name(err));
-    } else {
-        err = nvs_commit(handle);
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to commit NVS changes. Error: %s", esp_err_to_name(err));
+    int actions = 0;
+    int groups = 0;
+    auto action = std::make_unique<RegisteredAction>();
+    RegisteredGroup group;
+    for (const std::string& key : keys) {
+        size_t size = 0;
+        if (nvs_get_blob(handle, key.c_str(), nullptr, &size) != ESP_OK) {
+            continue;
+        }
+        // The old blobs were whole structs, so the size tells the kinds apart.
+        if (size == sizeof(RegisteredAction) && nvs_get_blob(handle, key.c_str(), action.get(), &size) == ESP_OK) {
+            snprintf(action->name, sizeof(action->name), "%s", key.c_str());
+            if (action->type == ActionType::GAIT_PERIODIC) {
+                // Legacy gaits held a single term right after the period.
+                motion_params_t fundamental;
+                memcpy(&fundamental, reinterpret_cast<const uint8_t*>(&action->data) + sizeof(uint32_t), sizeof(fundamental));
+                action->data.gait.easing_type = EasingType::LINEAR;
+                action->data.gait.harmonic_count = 1;
+                action->data.gait.harmonic_terms[0] = fundamental;
+            } else if (action->type == ActionType::KEYFRAME_SEQUENCE) {
+                action->data.keyframe.interpolation = KeyframeInterpolation::COSINE; // Was padding
+            }
+            if (!save_action(*action)) continue;
+            ++actions;
+        } else if (size == sizeof(RegisteredGroup) && nvs_get_blob(handle, key.c_str(), &group, &size) == ESP_OK) {
+            snprintf(group.name, sizeof(group.name), "%s", key.c_str());
+            if (group.action_count > MAX_ACTIONS_PER_GROUP || !save_group(group)) continue;
+            ++groups;
         } else {
-            ESP_LOGI(TAG, "Action '%s' saved successfully.", key);
+            ESP_LOGW(TAG, "Leaving legacy entry '%s' of unknown size %d.", key.c_str(), (int)size);
+            continue;
+        }
+        // Only a migrated entry goes; the rest are tried again next boot.
+        if (nvs_erase_key(handle, key.c_str()) != ESP_OK) {
+            ESP_LOGW(TAG, "Failed to erase migrated legacy entry '%s'.", key.c_str());
         }
     }
-
-    nvs_close(handle);
-    return err == ESP_OK;
-}
-
-bool MotionStorage::load_action(const char* name, RegisteredAction& action) {
-    if (!m_initialized) return false;
-
-    nvs_handle_t handle;
-    esp_err_t err = nvs_open(m_nvs_namespace, NVS_READONLY, &handle);
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Error (%s) opening NVS handle!", esp_err_to_name(err));
-        return false;
-    }
-
-    size_t required_size = sizeof(RegisteredAction);
-    err = nvs_get_blob(handle, name, &action, &required_size);
+    nvs_commit(handle);
     nvs_close(handle);
-
-    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
-        ESP_LOGE(TAG, "Failed to load action '%s'. Error: %s", name, esp_err_to_name(err));
-    }
-    
-    return err == ESP_OK;
+    const int left = static_cast<int>(keys.size()) - actions - groups;
+    ESP_LOGI(TAG, "Migrated %d actions and %d groups from legacy namespace '%s', %d entries left.", actions, groups,
+             LEGACY_NAMESPACE, left);
 }
 
-bool MotionStorage::delete_action(const char* name) {
+bool MotionStorage::delete_key(const char* nvs_namespace, const char* name) {
     if (!m_initialized) return false;
 
     nvs_handle_t handle;
-    esp_err_t err = nvs_open(m_nvs_namespace, NVS_READWRITE, &handle);
+    esp_err_t err = nvs_open(nvs_namespace, NVS_READWRITE, &handle);
     if (err != ESP_OK) return false;
 
     char key[NVS_KEY_NAME_MAX_SIZE];
@@ -86,13 +184,13 @@ bool MotionStorage::delete_action(const char* name) {
 
     err = nvs_erase_key(handle, key);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to delete action '%s'. Error: %s", key, esp_err_to_name(err));
+        ESP_LOGE(TAG, "Failed to delete '%s' from '%s'. Error: %s", key, nvs_namespace, esp_err_to_name(err));
     } else {
         err = nvs_commit(handle);
         if (err != ESP_OK) {
             ESP_LOGE(TAG, "Failed to commit deletion for '%s'. Error: %s", key, esp_err_to_name(err));
         } else {
-            ESP_LOGI(TAG, "Action '%s' deleted successfully.", key);
+            ESP_LOGI(TAG, "'%s' deleted from '%s' successfully.", key, nvs_namespace);
         }
     }
 
@@ -100,29 +198,26 @@ bool MotionStorage::delete_action(const char* name) {
     return err == ESP_OK;
 }
 
-bool MotionStorage::list_actions(std::vector<std::string>& action_names) {
-    action_names.clear();
+bool MotionStorage::list_keys(const char* nvs_namespace, std::vector<std::string>& names) {
+    names.clear();
     if (!m_initialized) return false;
 
     nvs_iterator_t it = nullptr; // 初始化为 nullptr
-    esp_err_t err = nvs_entry_find(NVS_DEFAULT_PART_NAME, m_nvs_namespace, NVS_TYPE_BLOB, &it);
+    esp_err_t err = nvs_entry_find(NVS_DEFAULT_PART_NAME, nvs_namespace, NVS_TYPE_BLOB, &it);
     if (err == ESP_ERR_NVS_NOT_FOUND || it == nullptr) {
-        ESP_LOGI(TAG, "No actions found in NVS namespace '%s'.", m_nvs_namespace);
+        ESP_LOGI(TAG, "No entries found in NVS namespace '%s'.", nvs_namespace);
         return true;
     } else if (err != ESP_OK) {
         ESP_LOGE(TAG, "Error finding NVS entries: %s", esp_err_to_name(err));
         return false;
     }
 
-    const std::string prefix = "";
     while (it != nullptr) {
         nvs_entry_info_t info;
         nvs_entry_info(it, &info);
-        if (strncmp(info.key, prefix.c_str(), prefix.length()) == 0) {
-            action_names.push_back(info.key + prefix.length());
-        }
+        names.push_back(info.key);
         err = nvs_entry_next(&it); // 传递迭代器指针
-        if (err != ESP_OK) {
+        if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
             ESP_LOGE(TAG, "Error iterating NVS entries: %s", esp_err_to_name(err));
             break;
         }
@@ -131,110 +226,154 @@ bool MotionStorage::list_actions(std::vector<std::string>& action_names) {
     return true;
 }
 
-// --- Group Management ---
-bool MotionStorage::save_group(const RegisteredGroup& group) {
+// --- Action Management ---
+bool MotionStorage::save_action(const RegisteredAction& action) {
+    return save_actions({&action});
+}
+
+bool MotionStorage::save_actions(const std::vector<const RegisteredAction*>& actions) {
     if (!m_initialized) return false;
 
     nvs_handle_t handle;
-    esp_err_t err = nvs_open(m_nvs_namespace, NVS_READWRITE, &handle);
+    esp_err_t err = nvs_open(m_action_namespace, NVS_READWRITE, &handle);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Error (%s) opening NVS handle for group!", esp_err_to_name(err));
+        ESP_LOGE(TAG, "Error (%s) opening NVS handle!", esp_err_to_name(err));
         return false;
     }
 
-    char key[NVS_KEY_NAME_MAX_SIZE];
-    snprintf(key, sizeof(key), "%s", group.name);
-
-    err = nvs_set_blob(handle, key, &group, sizeof(RegisteredGroup));
-    if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to save group '%s'. Error: %s", key, esp_err_to_name(err));
-    } else {
-        err = nvs_commit(handle);
+    auto scratch = std::make_unique<uint8_t[]>(MAX_RECORD_SIZE);
+    int64_t start_us = MotionPlatform::now_us();
+    size_t saved = 0;
+    size_t record_bytes = 0;
+    size_t flash_bytes = 0;
+    for (const RegisteredAction* action : actions) {
+        char key[NVS_KEY_NAME_MAX_SIZE];
+        snprintf(key, sizeof(key), "%s", action->name);
+        size_t payload_size = MotionPack::action_record_size(*action);
+        err = write_record(handle, key, RecordKind::ACTION, action, payload_size, scratch.get());
         if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to commit NVS for group. Error: %s", esp_err_to_name(err));
-        } else {
-            ESP_LOGI(TAG, "Group '%s' saved successfully.", key);
+            ESP_LOGE(TAG, "Failed to save action '%s'. Error: %s", key, esp_err_to_name(err));
+            break;
         }
+        ++saved;
+        record_bytes += sizeof(RecordHeader) + payload_size;
+        flash_bytes += nvs_blob_flash_bytes(sizeof(RecordHeader) + payload_size);
     }
 
+    if (saved > 0) {
+        esp_err_t commit_err = nvs_commit(handle);
+        if (commit_err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to commit NVS changes. Error: %s", esp_err_to_name(commit_err));
+            err = commit_err;
+        }
+    }
     nvs_close(handle);
+
+    ESP_LOGI(TAG, "Saved %d/%d actions: %d record bytes, ~%d bytes of NVS entries, %lld us.",
+             (int)saved, (int)actions.size(), (int)record_bytes, (int)flash_bytes,
+             (long long)(MotionPlatform::now_us() - start_us));
     return err == ESP_OK;
 }
 
-bool MotionStorage::load_group(const char* name, RegisteredGroup& group) {
+bool MotionStorage::load_action(const char* name, RegisteredAction& action) {
     if (!m_initialized) return false;
 
     nvs_handle_t handle;
-    esp_err_t err = nvs_open(m_nvs_namespace, NVS_READONLY, &handle);
-    if (err != ESP_OK) return false;
-
-    char key[NVS_KEY_NAME_MAX_SIZE];
-    snprintf(key, sizeof(key), "%s", name);
+    esp_err_t err = nvs_open(m_action_namespace, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        if (err != ESP_ERR_NVS_NOT_FOUND) {
+            ESP_LOGE(TAG, "Error (%s) opening NVS handle!", esp_err_to_name(err));
+        }
+        return false;
+    }
 
-    size_t required_size = sizeof(RegisteredGroup);
-    err = nvs_get_blob(handle, key, &group, &required_size);
+    auto scratch = std::make_unique<uint8_t[]>(MAX_RECORD_SIZE);
+    size_t payload_size = read_record(handle, name, RecordKind::ACTION, &action, sizeof(action), scratch.get());
     nvs_close(handle);
+    if (payload_size == 0) {
+        return false;
+    }
 
-    if (err != ESP_OK && err != ESP_ERR_NVS_NOT_FOUND) {
-        ESP_LOGE(TAG, "Failed to load group '%s'. Error: %s", key, esp_err_to_name(err));
+    bool valid_type = (action.type == ActionType::GAIT_PERIODIC && action.data.gait.harmonic_count >= 1 &&
+                       action.data.gait.harmonic_count <= MAX_GAIT_HARMONICS) ||
+                      (action.type == ActionType::KEYFRAME_SEQUENCE && action.data.keyframe.frame_count <= MAX_KEYFRAMES_PER_ACTION &&
+                       action.data.keyframe.interpolation <= KeyframeInterpolation::CATMULL_ROM);
+    if (!valid_type || payload_size != MotionPack::action_record_size(action) ||
+        strncmp(action.name, name, MOTION_NAME_MAX_LEN) != 0) {
+        ESP_LOGW(TAG, "Action record '%s' is inconsistent, ignored.", name);
+        return false;
     }
+    return true;
+}
 
-    return err == ESP_OK;
+bool MotionStorage::delete_action(const char* name) {
+    return delete_key(m_action_namespace, name);
 }
 
-bool MotionStorage::delete_group(const char* name) {
+bool MotionStorage::list_actions(std::vector<std::string>& action_names) {
+    return list_keys(m_action_namespace, action_names);
+}
+
+// --- Group Management ---
+bool MotionStorage::save_group(const RegisteredGroup& group) {
     if (!m_initialized) return false;
 
     nvs_handle_t handle;
-    esp_err_t err = nvs_open(m_nvs_namespace, NVS_READWRITE, &handle);
-    if (err != ESP_OK) return false;
+    esp_err_t err = nvs_open(m_group_namespace, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error (%s) opening NVS handle for group!", esp_err_to_name(err));
+        return false;
+    }
 
     char key[NVS_KEY_NAME_MAX_SIZE];
-    snprintf(key, sizeof(key), "%s", name);
+    snprintf(key, sizeof(key), "%s", group.name);
 
-    err = nvs_erase_key(handle, key);
+    uint8_t scratch[sizeof(RecordHeader) + sizeof(RegisteredGroup)];
+    err = write_record(handle, key, RecordKind::GROUP, &group, group_payload_size(group), scratch);
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to delete group '%s'. Error: %s", key, esp_err_to_name(err));
+        ESP_LOGE(TAG, "Failed to save group '%s'. Error: %s", key, esp_err_to_name(err));
     } else {
         err = nvs_commit(handle);
         if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Failed to commit deletion for group '%s'. Error: %s", key, esp_err_to_name(err));
+            ESP_LOGE(TAG, "Failed to commit NVS for group. Error: %s", esp_err_to_name(err));
         } else {
-            ESP_LOGI(TAG, "Group '%s' deleted successfully.", key);
+            ESP_LOGI(TAG, "Group '%s' saved successfully.", key);
         }
     }
-    
+
     nvs_close(handle);
     return err == ESP_OK;
 }
 
-bool MotionStorage::list_groups(std::vector<std::string>& group_names) {
-    group_names.clear();
+bool MotionStorage::load_group(const char* name, RegisteredGroup& group) {
     if (!m_initialized) return false;
 
-    nvs_iterator_t it = nullptr; // 初始化为 nullptr
-    esp_err_t err = nvs_entry_find(NVS_DEFAULT_PART_NAME, m_nvs_namespace, NVS_TYPE_BLOB, &it);
-    if (err == ESP_ERR_NVS_NOT_FOUND || it == nullptr) {
-        ESP_LOGI(TAG, "No groups found in NVS namespace '%s'.", m_nvs_namespace);
-        return true;
-    } else if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Error finding NVS entries: %s", esp_err_to_name(err));
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(m_group_namespace, NVS_READONLY, &handle);
+    if (err != ESP_OK) return false;
+
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    snprintf(key, sizeof(key), "%s", name);
+
+    auto scratch = std::make_unique<uint8_t[]>(MAX_RECORD_SIZE);
+    size_t payload_size = read_record(handle, key, RecordKind::GROUP, &group, sizeof(group), scratch.get());
+    nvs_close(handle);
+    if (payload_size == 0) {
         return false;
     }
 
-    const std::string prefix = "";
-    while (it != nullptr) {
-        nvs_entry_info_t info;
-        nvs_entry_info(it, &info);
-        if (strncmp(info.key, prefix.c_str(), prefix.length()) == 0) {
-            group_names.push_back(info.key + prefix.length());
-        }
-        err = nvs_entry_next(&it); // 传递迭代器指针
-        if (err != ESP_OK) {
-            ESP_LOGE(TAG, "Error iterating NVS entries: %s", esp_err_to_name(err));
-            break;
-        }
+    if (group.action_count > MAX_ACTIONS_PER_GROUP || payload_size != group_payload_size(group) ||
+        strncmp(group.name, key, MOTION_NAME_MAX_LEN) != 0) {
+        ESP_LOGW(TAG, "Group record '%s' is inconsistent, ignored.", key);
+        return false;
     }
-    nvs_release_iterator(it);
     return true;
 }
+
+bool MotionStorage::delete_group(const char* name) {
+    return delete_key(m_group_namespace, name);
+}
+
+bool MotionStorage::list_groups(std::vector<std::string>& group_names) {
+    return list_keys(m_group_namespace, group_names);
+}
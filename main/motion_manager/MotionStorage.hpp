@@ -4,9 +4,13 @@
 #include <vector>
 #include <string>
 
+// Actions and groups are stored in separate NVS namespaces, keyed by name, so
+// listing one kind never returns the other. Each value is a compact record:
+// a small header (schema version, kind, payload size, CRC-32) followed by only
+// the used bytes of the action or group, see MotionStorage.cpp.
 class MotionStorage {
 public:
-    MotionStorage(const char* nvs_namespace = "motion_db");
+    MotionStorage(const char* action_namespace = "motion_act", const char* group_namespace = "motion_grp");
     ~MotionStorage();
 
     // 初始化NVS
@@ -14,6 +18,9 @@ public:
 
     // --- Action Management ---
     bool save_action(const RegisteredAction& action);
+    // Writes all actions under one NVS handle and one commit. Stops at the
+    // first failure; actions written before it stay saved.
+    bool save_actions(const std::vector<const RegisteredAction*>& actions);
     bool load_action(const char* name, RegisteredAction& action);
     bool delete_action(const char* name);
     bool list_actions(std::vector<std::string>& action_names);
@@ -25,6 +32,11 @@ public:
     bool list_groups(std::vector<std::string>& group_names);
 
 private:
-    const char* m_nvs_namespace;
+    bool delete_key(const char* nvs_namespace, const char* name);
+    bool list_keys(const char* nvs_namespace, std::vector<std::string>& names);
+    void migrate_legacy_namespace();
+
+    const char* m_action_namespace;
+    const char* m_group_namespace;
     bool m_initialized = false;
-};
\ No newline at end of file
+};
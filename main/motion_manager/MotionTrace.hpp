@@ -0,0 +1,70 @@
+#pragma once
+
+#include "motion_manager/Motion_types.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Binary motion trace: one fixed-size record per mixer tick, recorded into a
+// PSRAM ring by MotionTraceRecorder and decoded on the host (tools/mtrace).
+//
+//   Header
+//   char names[name_count][name_len]   action name of every ActionId, by id
+//   Record[record_count]               oldest first
+//
+// All fields are little-endian.
+namespace MotionTrace {
+
+constexpr uint32_t MAGIC = 0x52544D4F; // "OMTR"
+constexpr uint16_t VERSION = 1;
+constexpr uint32_t DEFAULT_CAPACITY = 6000; // Records; 2 minutes at 50 Hz, 528 KB
+constexpr int16_t NOT_DRIVEN = INT16_MIN;   // Angle of a joint the tick left alone
+
+enum RecordFlag : uint8_t {
+    RECORD_FLAG_MANUAL = 1 << 0,  // Manual servo control was active
+    RECORD_FLAG_IDLE   = 1 << 1   // No action was running, joints went home
+};
+
+struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint16_t record_size;
+    uint8_t joint_count;      // GAIT_JOINT_COUNT of the firmware
+    uint8_t max_actions;      // MAX_ACTIVE_ACTIONS of the firmware
+    uint16_t name_count;
+    uint16_t name_len;        // MOTION_NAME_MAX_LEN of the firmware
+    uint32_t record_count;
+    uint32_t period_us;       // Mixer period when the trace was written
+};
+static_assert(sizeof(Header) == 24, "MotionTrace::Header layout changed");
+
+// Angles are hundredths of a degree, in joint order (not servo channel order).
+struct Record {
+    uint32_t time_us;         // Low 32 bits of the tick's esp_timer time; wraps every 71 minutes
+    uint32_t sequence;        // Mixer tick counter; gaps are ticks not recorded
+    uint16_t wait_us;         // Time spent taking the staged action edits and edited templates
+    uint16_t compute_us;      // Wake-to-output time of the tick
+    uint16_t jitter_us;       // |wake time - deadline|
+    uint8_t action_count;
+    uint8_t flags;            // RecordFlag bits
+    ActionId action_ids[MAX_ACTIVE_ACTIONS];
+    int16_t commanded[GAIT_JOINT_COUNT]; // Mixer output before the output filters and trajectory follower
+    int16_t filtered[GAIT_JOINT_COUNT];  // Angles sent to the servo driver
+};
+static_assert(sizeof(Record) == 16 + 2 * MAX_ACTIVE_ACTIONS + 4 * GAIT_JOINT_COUNT, "MotionTrace::Record layout changed");
+
+inline int16_t encode_angle(float degrees) {
+    if (!(degrees >= -300.0f && degrees <= 300.0f)) return NOT_DRIVEN; // Also NaN
+    return static_cast<int16_t>(std::lround(degrees * 100.0f));
+}
+
+inline float decode_angle(int16_t value) {
+    return value == NOT_DRIVEN ? NAN : value * 0.01f;
+}
+
+inline uint16_t saturate_us(uint32_t us) {
+    return us > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(us);
+}
+
+} // namespace MotionTrace
@@ -0,0 +1,139 @@
+#include "motion_manager/MotionTraceRecorder.hpp"
+#include "motion_manager/MotionPlatform.hpp"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+
+static const char* TAG = "MotionTrace";
+
+static constexpr uint32_t WRITE_CHUNK_RECORDS = 32; // Records per sink call
+static constexpr uint32_t ACKNOWLEDGE_TIMEOUT_MS = 100; // Five ticks at the slowest mixer rate
+
+MotionTraceRecorder::~MotionTraceRecorder() {
+    if (m_records) {
+        heap_caps_free(m_records);
+    }
+}
+
+bool MotionTraceRecorder::init(uint32_t capacity, bool writer_task) {
+    if (m_records || capacity == 0) {
+        return m_records != nullptr;
+    }
+    size_t bytes = static_cast<size_t>(capacity) * sizeof(MotionTrace::Record);
+    m_records = static_cast<MotionTrace::Record*>(heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM));
+    if (m_records == nullptr) {
+        ESP_LOGE(TAG, "Out of PSRAM for a %u record motion trace, tracing disabled.", (unsigned)capacity);
+        return false;
+    }
+    m_capacity = capacity;
+    m_writer_task = writer_task;
+    m_written.store(0, std::memory_order_relaxed);
+    ESP_LOGI(TAG, "Motion trace ready: %u records of %u bytes in PSRAM.", (unsigned)capacity,
+             (unsigned)sizeof(MotionTrace::Record));
+    return true;
+}
+
+// Posts a request for the next record(). Callers hold m_busy, or only
+// resume, so requests never race each other.
+uint32_t MotionTraceRecorder::post(Action action) {
+    const uint32_t request = ((m_request.load(std::memory_order_relaxed) & ~ACTION_MASK) + ACTION_MASK + 1) | action;
+    m_request.store(request, std::memory_order_release);
+    if (!m_writer_task) {
+        acknowledge(request);
+    }
+    return request;
+}
+
+bool MotionTraceRecorder::wait_for(uint32_t request) {
+    for (uint32_t waited_ms = 0; m_acknowledged.load(std::memory_order_acquire) != request; ++waited_ms) {
+        if (waited_ms >= ACKNOWLEDGE_TIMEOUT_MS) {
+            ESP_LOGW(TAG, "Mixer did not take the motion trace request within %u ms.", (unsigned)ACKNOWLEDGE_TIMEOUT_MS);
+            return false;
+        }
+        MotionPlatform::delay_ms(1);
+    }
+    return true;
+}
+
+// Only the latest request counts: one that was superseded before a tick
+// saw it never needs doing.
+void MotionTraceRecorder::acknowledge(uint32_t request) {
+    switch (static_cast<Action>(request & ACTION_MASK)) {
+        case PAUSE:
+            m_paused = true;
+            break;
+        case CLEAR:
+            m_written.store(0, std::memory_order_relaxed);
+            m_paused = false;
+            break;
+        default:
+            m_paused = false;
+            break;
+    }
+    m_acknowledged.store(request, std::memory_order_release);
+}
+
+bool MotionTraceRecorder::clear() {
+    if (m_records == nullptr) {
+        return true;
+    }
+    if (m_busy.test_and_set(std::memory_order_acquire)) {
+        ESP_LOGW(TAG, "Motion trace dump running, not cleared.");
+        return false;
+    }
+    const bool ok = wait_for(post(CLEAR));
+    m_busy.clear(std::memory_order_release);
+    return ok;
+}
+
+bool MotionTraceRecorder::write(const Sink& sink, const char (*names)[MOTION_NAME_MAX_LEN], uint16_t name_count,
+                                uint32_t period_us) {
+    if (m_records == nullptr) {
+        return false;
+    }
+    if (m_busy.test_and_set(std::memory_order_acquire)) {
+        ESP_LOGW(TAG, "Motion trace dump already running.");
+        return false;
+    }
+    // The mixer acknowledges once it has stopped recording; its last record
+    // is visible from then on.
+    if (!wait_for(post(PAUSE))) {
+        post(RESUME);
+        m_busy.clear(std::memory_order_release);
+        return false;
+    }
+
+    const uint32_t written = m_written.load(std::memory_order_acquire);
+    const uint32_t count = written < m_capacity ? written : m_capacity;
+
+    MotionTrace::Header header = {};
+    header.magic = MotionTrace::MAGIC;
+    header.version = MotionTrace::VERSION;
+    header.header_size = sizeof(header);
+    header.record_size = sizeof(MotionTrace::Record);
+    header.joint_count = GAIT_JOINT_COUNT;
+    header.max_actions = MAX_ACTIVE_ACTIONS;
+    header.name_count = name_count;
+    header.name_len = MOTION_NAME_MAX_LEN;
+    header.record_count = count;
+    header.period_us = period_us;
+
+    bool ok = sink(&header, sizeof(header)) && (name_count == 0 || sink(names, static_cast<size_t>(name_count) * MOTION_NAME_MAX_LEN));
+    // Oldest record first; the ring may wrap in the middle of a chunk.
+    for (uint32_t done = 0; ok && done < count;) {
+        uint32_t slot = (written - count + done) % m_capacity;
+        uint32_t run = count - done;
+        if (run > WRITE_CHUNK_RECORDS) run = WRITE_CHUNK_RECORDS;
+        if (run > m_capacity - slot) run = m_capacity - slot;
+        ok = sink(&m_records[slot], run * sizeof(MotionTrace::Record));
+        done += run;
+    }
+
+    post(RESUME);
+    m_busy.clear(std::memory_order_release);
+    if (ok) {
+        ESP_LOGI(TAG, "Wrote motion trace: %u records.", (unsigned)count);
+    } else {
+        ESP_LOGW(TAG, "Motion trace sink failed, dump incomplete.");
+    }
+    return ok;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "motion_manager/MotionTrace.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Ring of MotionTrace records in PSRAM. The mixer task is the only writer;
+// record() is a copy into the next slot and never blocks. write() streams
+// the ring as a trace file to any sink. Recording pauses while it does, so
+// the dump is consistent and shows what led up to the moment it was taken.
+// Pausing and clearing are requests that the next record() carries out and
+// acknowledges, so the ring only ever changes on the mixer task.
+class MotionTraceRecorder {
+public:
+    // Returns false when the sink could not take the data; the dump stops there.
+    typedef std::function<bool(const void* data, size_t size)> Sink;
+
+    MotionTraceRecorder() = default;
+    ~MotionTraceRecorder();
+    MotionTraceRecorder(const MotionTraceRecorder&) = delete;
+    MotionTraceRecorder& operator=(const MotionTraceRecorder&) = delete;
+
+    // Allocates room for capacity records in PSRAM. Without it record() does
+    // nothing. Without a writer task (the executor driven through step()),
+    // the task that asks for a dump records too, so it serves its own requests.
+    bool init(uint32_t capacity = MotionTrace::DEFAULT_CAPACITY, bool writer_task = true);
+    bool is_ready() const { return m_records != nullptr; }
+
+    // Mixer task only.
+    void record(const MotionTrace::Record& record) {
+        if (m_records == nullptr) return;
+        const uint32_t request = m_request.load(std::memory_order_acquire);
+        if (request != m_acknowledged.load(std::memory_order_relaxed)) acknowledge(request);
+        if (m_paused) return;
+        uint32_t written = m_written.load(std::memory_order_relaxed);
+        m_records[written % m_capacity] = record;
+        m_written.store(written + 1, std::memory_order_release);
+    }
+
+    // names[id] is the action name of id, name_count entries of MOTION_NAME_MAX_LEN.
+    // One dump at a time: false if another write() or clear() is running.
+    bool write(const Sink& sink, const char (*names)[MOTION_NAME_MAX_LEN], uint16_t name_count, uint32_t period_us);
+
+    // Drops all records. False if a dump is running or the mixer did not
+    // take the request in time; it then clears on its next tick.
+    bool clear();
+
+private:
+    // Requests: a sequence number above the action bits, so each is new
+    enum Action : uint32_t { RESUME = 0, PAUSE = 1, CLEAR = 2, ACTION_MASK = 3 };
+
+    uint32_t post(Action action);
+    bool wait_for(uint32_t request);
+    void acknowledge(uint32_t request); // Mixer task only
+
+    MotionTrace::Record* m_records = nullptr;
+    uint32_t m_capacity = 0;
+    bool m_writer_task = true;
+    std::atomic<uint32_t> m_written{0};
+    bool m_paused = false; // Mixer task only
+    std::atomic<uint32_t> m_request{0};
+    std::atomic<uint32_t> m_acknowledged{0};
+    std::atomic_flag m_busy = ATOMIC_FLAG_INIT; // Held by write() and clear()
+};
@@ -1,17 +1,53 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include <vector>
-#include "config.h"
-#include "nvs.h"
+#include "ServoChannel.hpp"
 
-#define MOTION_NAME_MAX_LEN NVS_KEY_NAME_MAX_SIZE
+#define MOTION_NAME_MAX_LEN 16 // Names double as NVS keys, see MotionStorage.cpp
 #define MAX_ACTIONS_PER_GROUP 10
 #define MAX_KEYFRAMES_PER_ACTION 20 // Maximum number of keyframes in a single action
+#define MAX_GAIT_HARMONICS 4        // Fourier terms per gait action, fundamental included
+#define MAX_ACTIVE_ACTIONS 8        // Maximum number of actions the mixer runs at once
+#define MOTION_CMD_PARAMS_MAX 32    // Inline parameter bytes carried by a motion command
 
 const int GAIT_JOINT_COUNT = static_cast<int>(ServoChannel::SERVO_COUNT);
 
-// Parameters for GAIT_PERIODIC actions
+// Dense integer handle for an action name, interned by ActionManager
+typedef uint16_t ActionId;
+#define INVALID_ACTION_ID 0xFFFF
+
+// Role flags attached to an ActionId, so hot paths test bits instead of names
+enum ActionRole : uint8_t {
+    ACTION_ROLE_NONE          = 0,
+    ACTION_ROLE_HEAD_TRACK    = 1 << 0, // Driven by the face tracker, never finishes on its own
+    ACTION_ROLE_BODY_MOVING   = 1 << 1, // Moves the body; head tracking is frozen while it runs
+    ACTION_ROLE_TRACKING_TURN = 1 << 2  // Body turn requested by the face tracker
+};
+
+const uint32_t ALL_JOINTS_MASK = (1u << GAIT_JOINT_COUNT) - 1; // Bit i stands for joint i
+
+// How a mixer layer combines with the layers below it on its joints
+enum class LayerBlend : uint8_t {
+    OVERRIDE,   // Moves the joints towards the layer's pose by its weight
+    ADDITIVE    // Adds the layer's offset from the home pose, scaled by its weight
+};
+
+// Mixer layer of an action, declared per action name like the roles. Layers
+// are blended from low to high priority on top of the home pose; equal
+// priorities blend in start order.
+typedef struct {
+    uint32_t joint_mask;    // Joints the layer may drive
+    int8_t priority;
+    LayerBlend blend;
+    float weight;           // 0..1, full strength at 1
+    uint16_t fade_in_ms;    // Weight ramps up from 0 after the start
+    uint16_t fade_out_ms;   // Weight ramps down to 0 after the action finished
+} ActionLayer;
+
+// One Fourier term of a GAIT_PERIODIC action
 typedef struct {
     float amplitude[GAIT_JOINT_COUNT];   // Amplitude of oscillation
     float offset[GAIT_JOINT_COUNT];      // Center point of oscillation
@@ -24,18 +60,63 @@ enum class ActionType : uint8_t {
     KEYFRAME_SEQUENCE   // Action based on a sequence of keyframes
 };
 
+// Time warp applied to the cycle position before the harmonics are evaluated
+enum class EasingType : uint8_t {
+    LINEAR,             // No warp
+    EASE_IN_QUAD,       // t^2: slow start, fast finish
+    EASE_OUT_QUAD,      // 1 - (1-t)^2: fast start, slow finish
+    EASE_IN_OUT_QUAD    // Slow at both ends of the cycle
+};
+
+// Holds the data for a gait action. Each joint follows
+//   home + harmonic_terms[0].offset + sum_k A_k * sin(2*pi*k*ease(t) + P_k),  k = 1..harmonic_count
+// where A_k and P_k come from harmonic_terms[k-1]. Offsets of the higher terms are unused.
+typedef struct {
+    uint32_t gait_period_ms;    // Default duration of a single gait cycle (ms)
+    EasingType easing_type;
+    uint8_t harmonic_count;     // Used entries of harmonic_terms, at least 1
+    motion_params_t harmonic_terms[MAX_GAIT_HARMONICS]; // Last, so stored records can stop after the used terms
+} GaitActionData;
+
 // Defines a single keyframe in a sequence
 typedef struct {
     uint16_t transition_time_ms;    // Time to transition to this frame from the previous one (in ms)
     float positions[GAIT_JOINT_COUNT]; // Target positions for each servo at this frame (in degrees)
 } Keyframe;
 
+// How a keyframe sequence moves between its frames
+enum class KeyframeInterpolation : uint8_t {
+    COSINE,         // Eased in and out of every frame; stops at each one
+    CATMULL_ROM     // Cubic spline through the frames; velocity is continuous across them
+};
+
 // Holds the data for a keyframe sequence action
 typedef struct {
     uint8_t frame_count;
+    KeyframeInterpolation interpolation; // Sits in what used to be padding, so older records read as COSINE
     Keyframe frames[MAX_KEYFRAMES_PER_ACTION];
 } KeyframeActionData;
 
+// One cubic per joint across a keyframe transition, in the transition's
+// normalized time u in [0, 1]: p(u) = ((a*u + b)*u + c)*u + d
+typedef struct {
+    float a[GAIT_JOINT_COUNT];
+    float b[GAIT_JOINT_COUNT];
+    float c[GAIT_JOINT_COUNT];
+    float d[GAIT_JOINT_COUNT];
+} SplineSegment;
+
+// Segments of a CATMULL_ROM action, built once by ActionManager when the
+// action is loaded. segments[j] is the looping transition into frame j; the
+// three after the last frame start from rest, end at rest, or both.
+#define SPLINE_SEGMENT_ENTRY      (MAX_KEYFRAMES_PER_ACTION)
+#define SPLINE_SEGMENT_EXIT       (MAX_KEYFRAMES_PER_ACTION + 1)
+#define SPLINE_SEGMENT_ENTRY_EXIT (MAX_KEYFRAMES_PER_ACTION + 2)
+typedef struct {
+    uint8_t frame_count;
+    SplineSegment segments[MAX_KEYFRAMES_PER_ACTION + 3];
+} KeyframeSpline;
+
 // Defines a registered action in the system
 typedef struct {
     char name[MOTION_NAME_MAX_LEN]; // Action name (will be the key in NVS)
@@ -45,10 +126,7 @@ typedef struct {
     
     union {
         // Data for GAIT_PERIODIC actions
-        struct {
-            uint32_t gait_period_ms;    // Default duration of a single gait cycle (ms)
-            motion_params_t params;     // Gait parameters
-        } gait;
+        GaitActionData gait;
 
         // Data for KEYFRAME_SEQUENCE actions
         KeyframeActionData keyframe;
@@ -71,11 +149,38 @@ typedef struct {
 } RegisteredGroup;
 
 
-// Defines a command for the motion controller
+// Defines a command for the motion controller. Plain data with inline
+// parameters, so it can be copied byte-wise between tasks without owning heap.
 typedef struct {
-    uint8_t motion_type; // Type of motion (e.g., walk forward, stop)
-    std::vector<uint8_t> params;       // Variable length parameters
+    uint8_t motion_type;                    // Type of motion (e.g., walk forward, stop)
+    uint8_t param_len;                      // Number of valid bytes in params
+    uint8_t params[MOTION_CMD_PARAMS_MAX];  // Command parameters, e.g. an action name
 } motion_command_t;
+static_assert(std::is_trivially_copyable<motion_command_t>::value, "motion_command_t must stay plain data");
+
+// Copies len parameter bytes into cmd. Fails without touching cmd if they don't fit.
+inline bool motion_command_set_params(motion_command_t& cmd, const uint8_t* data, size_t len) {
+    if (len > MOTION_CMD_PARAMS_MAX) {
+        return false;
+    }
+    memcpy(cmd.params, data, len);
+    cmd.param_len = static_cast<uint8_t>(len);
+    return true;
+}
+
+// Backpressure counters for the motion command ring and the commands the
+// dispatcher defers while an atomic action runs
+typedef struct {
+    uint32_t queued;      // Commands accepted
+    uint32_t dropped;     // Commands rejected because the ring was full, or pushed out of a full deferred queue
+    uint32_t flushed;     // Queued and deferred commands discarded by a STOP
+    uint32_t high_water;  // Deepest the ring has been
+    uint32_t deferred;    // Commands held back by an atomic action
+    uint32_t coalesced;   // Deferred commands replaced by a newer one of their class
+    uint32_t expired;     // Deferred commands dropped at their deadline
+    uint32_t latency_max_us;  // Worst time from queue_command() to the servo write that carried it out
+    uint32_t latency_last_us; // The same for the latest tick that dispatched a command
+} MotionCommandStats;
 
 // Defines the location of a detected face
 typedef struct {
@@ -84,6 +189,7 @@ typedef struct {
     uint16_t w;
     uint16_t h;
     bool detected;
+    int64_t timestamp_us; // Clock time the report arrived over UART; 0 = when it was queued
 } FaceLocation;
 
 // Defines a pointer to a gait function
@@ -95,15 +201,107 @@ typedef struct {
     const char* name;         // Gait name
 } Gait;
 
-// Defines an instance of a running action, holding its state
+// Oscillator state of a running GAIT_PERIODIC action, advanced by GaitEngine.
+// The mixer keeps these in side slots, one per gait instance, so the other
+// instances do not carry one.
+// The fundamental e^(i*theta) is a phasor rotated once per mixer tick; the
+// joint phase offsets are folded into per-joint weights of sin(k*theta) and
+// cos(k*theta) when the action starts, so a tick costs no trigonometry.
+typedef struct {
+    float re, im;                   // e^(i*theta) at phase_time_us
+    float step_re, step_im;         // Rotation by one mixer tick
+    int64_t cycle_start_us;         // Start of the current gait cycle
+    int64_t phase_time_us;          // Time the phasor stands for
+    uint32_t step_us;               // Tick length the step was built for; 0 forces a resync
+    uint16_t steps_since_normalize;
+    uint8_t harmonic_count;
+    uint32_t driven_mask;           // Joints with a non-negligible amplitude in any term
+    float sin_weight[MAX_GAIT_HARMONICS][GAIT_JOINT_COUNT]; // A_k * cos(P_k)
+    float cos_weight[MAX_GAIT_HARMONICS][GAIT_JOINT_COUNT]; // A_k * sin(P_k)
+} GaitOscillator;
+
+constexpr uint8_t NO_OSCILLATOR_SLOT = 0xFF;
+
+// A member of a SEQUENTIAL group, resolved when the group is dispatched
 typedef struct {
-    RegisteredAction action;    // The definition of the action
+    const RegisteredAction* action;
+    ActionId id;
+} SequenceStep;
+
+// Defines an instance of a running action, holding only its per-run state.
+// The definition itself is shared and read in place, never copied.
+typedef struct {
+    const RegisteredAction* action; // Template owned by ActionManager (or the controller for head_track)
+    ActionId id;                // Interned handle of action->name
+    uint8_t roles;              // ActionRole flags of id
     uint32_t remaining_steps;   // Number of remaining repetitions
-    uint32_t start_time_ms;     // Start time of the current step/cycle
+    int64_t start_time_us;      // Start time of the current step/cycle (esp_timer time base)
 
     // State for keyframe animations
     uint8_t current_keyframe_index; // Index of the current target keyframe
-    uint32_t transition_start_time_ms; // Start time of the transition to the current keyframe
+    int64_t transition_start_time_us; // Start time of the transition to the current keyframe
     float start_positions[GAIT_JOINT_COUNT]; // Servo positions at the beginning of the transition
+    const KeyframeSpline* spline;   // Set for CATMULL_ROM actions, owned by ActionManager
+    uint8_t spline_segment;         // Segment of spline used for the current transition
+    bool looped;                    // The sequence has wrapped around at least once
+
+    // State for gait actions: the mixer's oscillator slot, or NO_OSCILLATOR_SLOT
+    uint8_t oscillator_slot;
+
+    // Mixer layer, copied from ActionManager at start
+    ActionLayer layer;
+    bool fading_out;            // Finished; kept only until the fade-out ends
+    int64_t fade_out_start_us;
+
+    // SEQUENTIAL group members still to run after this one, in order. The
+    // mixer restarts the instance as the first of them on the tick it finishes.
+    SequenceStep next_steps[MAX_ACTIONS_PER_GROUP - 1];
+    uint8_t next_step_count;
+    float last_pose[GAIT_JOINT_COUNT]; // Own output of the latest tick, kept while next_step_count > 0
+    uint32_t last_pose_mask;           // Joints in last_pose
+    // A gait that follows in a sequence eases in from the pose it took over:
+    // entry_offset is added to its output, fading to 0 over entry_ms.
+    float entry_offset[GAIT_JOINT_COUNT];
+    uint16_t entry_ms;                 // 0 once the entry is over
+    bool entry_pending;                // entry_offset not measured yet
 
-} ActionInstance;
\ No newline at end of file
+} ActionInstance;
+
+// Read-only view of one running action, published by the mixer for other tasks
+typedef struct {
+    char name[MOTION_NAME_MAX_LEN];
+    ActionId id;
+    uint8_t roles; // ActionRole flags
+    bool is_atomic;
+} ActiveActionInfo;
+
+// Immutable snapshot of the mixer's active action set
+typedef struct {
+    uint8_t count;
+    ActiveActionInfo actions[MAX_ACTIVE_ACTIONS];
+} ActiveActionSnapshot;
+
+// Change to the active action set, staged by the dispatcher and applied by the mixer
+enum class ActionEditType : uint8_t {
+    START_OR_EXTEND,    // Start the action, or add its default steps if already running
+    START_IF_INACTIVE,  // Start the action unless it is already running
+    START_SEQUENCE,     // Start the first member of a SEQUENTIAL group unless it is already running
+    APPEND_TO_SEQUENCE, // Queue a member after those of the last START_SEQUENCE
+    CLEAR_ALL           // Drop every running action
+};
+
+typedef struct {
+    ActionEditType type;
+    const RegisteredAction* action; // Template to start from; must outlive the edit
+    ActionId id;                    // Interned handle of action->name
+} ActionEdit;
+
+// Contention counters for the active action set
+typedef struct {
+    uint32_t edits_applied;       // Staged edits applied by the mixer
+    uint32_t edits_dropped;       // Edits lost because the staging ring was full
+    uint32_t sequences_dropped;   // Sequential groups not run: no free slot, or no room to queue behind a running one
+    uint32_t snapshot_retries;    // Snapshot reads that had to retry because the mixer published mid-copy
+    uint32_t mixer_wait_max_us;   // Worst time the mixer spent taking over staged edits and templates in one tick
+    uint64_t mixer_wait_total_us; // Total time the mixer spent taking over staged edits and templates
+} ActionSetStats;
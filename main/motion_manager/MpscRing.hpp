@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Bounded multi-producer / single-consumer ring. Producers claim a slot with
+// a CAS on the head and publish it through a per-slot sequence number, so a
+// slow producer never blocks the others and the consumer never takes a lock.
+// push() fails when the ring is full; callers decide what backpressure means.
+// Capacity must be a power of two.
+template <typename T, size_t Capacity>
+class MpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "MpscRing capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "MpscRing holds plain data only");
+
+public:
+    MpscRing() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            m_cells[i].seq.store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+        }
+    }
+
+    // Any task. Never blocks.
+    bool push(const T& item) {
+        uint32_t pos = m_head.load(std::memory_order_relaxed);
+        Cell* cell;
+        while (true) {
+            cell = &m_cells[pos & (Capacity - 1)];
+            uint32_t seq = cell->seq.load(std::memory_order_acquire);
+            int32_t diff = static_cast<int32_t>(seq - pos);
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // The consumer has not freed this slot yet: full
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+        cell->item = item;
+        cell->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer task only.
+    bool pop(T& item) {
+        uint32_t pos = m_tail.load(std::memory_order_relaxed);
+        Cell& cell = m_cells[pos & (Capacity - 1)];
+        if (cell.seq.load(std::memory_order_acquire) != pos + 1) {
+            return false; // Empty, or the next producer is still writing
+        }
+        item = cell.item;
+        cell.seq.store(pos + Capacity, std::memory_order_release);
+        m_tail.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Claimed slots not yet popped; exact only when producers are quiet.
+    size_t size() const {
+        return m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_relaxed);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Cell {
+        std::atomic<uint32_t> seq;
+        T item;
+    };
+
+    Cell m_cells[Capacity];
+    std::atomic<uint32_t> m_head{0}; // Claimed by producers
+    std::atomic<uint32_t> m_tail{0}; // Written by the consumer only
+};
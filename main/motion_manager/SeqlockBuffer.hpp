@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Double-buffered snapshot with a sequence counter. A single writer publishes
+// whole values without ever waiting; readers copy the latest published value
+// and retry only if a publish overtook them mid-copy.
+//
+// The counter is odd while a publish is in progress, and each publish moves
+// it on by two. The published value is in buffer (seq / 2) & 1, and a
+// publish fills the other buffer, so readers keep copying the published one
+// while the writer works.
+template <typename T>
+class SeqlockBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqlockBuffer holds plain data only");
+
+public:
+    SeqlockBuffer() { memset(m_buffers, 0, sizeof(m_buffers)); }
+
+    // Writer side. Only one task may publish.
+    void publish(const T& value) {
+        uint32_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        // Orders the odd count before the data: a reader that sees any byte
+        // of this publish also sees the count move
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&m_buffers[((seq >> 1) + 1) & 1], &value, sizeof(T));
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // Reader side. Returns the number of retries it took, for contention stats.
+    uint32_t read(T& out) const {
+        uint32_t retries = 0;
+        while (true) {
+            uint32_t seq = m_seq.load(std::memory_order_acquire);
+            memcpy(&out, &m_buffers[(seq >> 1) & 1], sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_seq.load(std::memory_order_relaxed) == seq) {
+                return retries;
+            }
+            ++retries;
+        }
+    }
+
+private:
+    T m_buffers[2];
+    std::atomic<uint32_t> m_seq{0};
+};
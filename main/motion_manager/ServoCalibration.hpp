@@ -1,13 +1,13 @@
 #pragma once
 
-#include "config.h"
+#include "ServoChannel.hpp"
 #include <array>
 
 namespace ServoCalibration {
 
 // Neutral position offsets (trims). The value to ADD to 90 to get the calibrated home.
 // A value of -10 means the calibrated home is 80 degrees.
-const std::array<float, static_cast<size_t>(ServoChannel::SERVO_COUNT)> trims = {{
+constexpr std::array<float, static_cast<size_t>(ServoChannel::SERVO_COUNT)> trims = {{
     10.0f,  // 0: LEFT_EAR_LIFT
     -10.0f,  // 1: LEFT_EAR_SWING
     0.0f,  // 2: RIGHT_EAR_LIFT
@@ -30,7 +30,7 @@ struct AngleLimits {
     float max;
 };
 
-const std::array<AngleLimits, static_cast<size_t>(ServoChannel::SERVO_COUNT)> limits = {{
+constexpr std::array<AngleLimits, static_cast<size_t>(ServoChannel::SERVO_COUNT)> limits = {{
     {60.0f, 130.0f},   // 0: LEFT_EAR_LIFT
     {30.0f, 110.0f},   // 1: LEFT_EAR_SWING
     {50.0f, 120.0f},   // 2: RIGHT_EAR_LIFT
@@ -47,13 +47,72 @@ const std::array<AngleLimits, static_cast<size_t>(ServoChannel::SERVO_COUNT)> li
     {0.0f, 180.0f}    // 13: RIGHT_ANKLE_LIFT
 }};
 
+// Speed and acceleration limits of each joint, in degrees per second and
+// degrees per second squared. The mixer's TrajectoryFollower never moves a
+// joint faster than this, whatever the actions command.
+struct MotionLimits {
+    float max_velocity;
+    float max_acceleration;
+};
+
+constexpr std::array<MotionLimits, static_cast<size_t>(ServoChannel::SERVO_COUNT)> motion_limits = {{
+    {600.0f, 12000.0f},  // 0: LEFT_EAR_LIFT
+    {600.0f, 12000.0f},  // 1: LEFT_EAR_SWING
+    {600.0f, 12000.0f},  // 2: RIGHT_EAR_LIFT
+    {600.0f, 12000.0f},  // 3: RIGHT_EAR_SWING
+    {450.0f, 8000.0f},   // 4: HEAD_TILT
+    {450.0f, 8000.0f},   // 5: HEAD_PAN
+    {500.0f, 15000.0f},  // 6: RIGHT_ARM_SWING
+    {500.0f, 15000.0f},  // 7: LEFT_ARM_LIFT
+    {500.0f, 15000.0f},  // 8: LEFT_ARM_SWING
+    {500.0f, 15000.0f},  // 9: RIGHT_ARM_LIFT
+    {400.0f, 10000.0f},  // 10: LEFT_LEG_ROTATE
+    {400.0f, 10000.0f},  // 11: LEFT_ANKLE_LIFT
+    {400.0f, 10000.0f},  // 12: RIGHT_LEG_ROTATE
+    {400.0f, 10000.0f}   // 13: RIGHT_ANKLE_LIFT
+}};
+
+// Low-pass filter applied to each joint's mixer output before the
+// TrajectoryFollower (see JointFilterBank.hpp). NONE passes the command
+// through; FIRST is a one-pole filter, SECOND a biquad with the given Q.
+enum class FilterOrder : uint8_t {
+    NONE,
+    FIRST,
+    SECOND
+};
+
+struct OutputFilter {
+    FilterOrder order;
+    float cutoff_hz;
+    float q;
+};
+
+// The head joints smooth the face tracker's 20 Hz offset steps; the other
+// joints follow their actions' own curves unfiltered.
+constexpr std::array<OutputFilter, static_cast<size_t>(ServoChannel::SERVO_COUNT)> output_filters = {{
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 0: LEFT_EAR_LIFT
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 1: LEFT_EAR_SWING
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 2: RIGHT_EAR_LIFT
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 3: RIGHT_EAR_SWING
+    {FilterOrder::SECOND, 5.0f, 0.7071f},   // 4: HEAD_TILT
+    {FilterOrder::SECOND, 5.0f, 0.7071f},   // 5: HEAD_PAN
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 6: RIGHT_ARM_SWING
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 7: LEFT_ARM_LIFT
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 8: LEFT_ARM_SWING
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 9: RIGHT_ARM_LIFT
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 10: LEFT_LEG_ROTATE
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 11: LEFT_ANKLE_LIFT
+    {FilterOrder::NONE, 0.0f, 0.0f},        // 12: RIGHT_LEG_ROTATE
+    {FilterOrder::NONE, 0.0f, 0.0f}         // 13: RIGHT_ANKLE_LIFT
+}};
+
 // Min and Max pulse width limits for each servo (in microseconds)
 struct PulseLimits {
     uint16_t min_us;
     uint16_t max_us;
 };
 
-const std::array<PulseLimits, static_cast<size_t>(ServoChannel::SERVO_COUNT)> pulse_limits = {{
+constexpr std::array<PulseLimits, static_cast<size_t>(ServoChannel::SERVO_COUNT)> pulse_limits = {{
     {900, 2100},   // 0: LEFT_EAR_LIFT
     {900, 2100},   // 1: LEFT_EAR_SWING
     {900, 2100},   // 2: RIGHT_EAR_LIFT
@@ -69,8 +128,28 @@ const std::array<PulseLimits, static_cast<size_t>(ServoChannel::SERVO_COUNT)> pu
     {900, 2100},   // 12: RIGHT_LEG_ROTATE
     {900, 2100}    // 13: RIGHT_ANKLE_LIFT
 }};
+
+// Mirror-mounted servos: the driver commands (origin - angle) instead of angle.
+// A value of 0 means the servo is mounted normally.
+constexpr std::array<float, static_cast<size_t>(ServoChannel::SERVO_COUNT)> mirror_origin = {{
+    0.0f,    // 0: LEFT_EAR_LIFT
+    0.0f,    // 1: LEFT_EAR_SWING
+    0.0f,    // 2: RIGHT_EAR_LIFT
+    0.0f,    // 3: RIGHT_EAR_SWING
+    0.0f,    // 4: HEAD_TILT
+    0.0f,    // 5: HEAD_PAN
+    180.0f,  // 6: RIGHT_ARM_SWING
+    130.0f,  // 7: LEFT_ARM_LIFT
+    0.0f,    // 8: LEFT_ARM_SWING
+    0.0f,    // 9: RIGHT_ARM_LIFT
+    0.0f,    // 10: LEFT_LEG_ROTATE
+    0.0f,    // 11: LEFT_ANKLE_LIFT
+    0.0f,    // 12: RIGHT_LEG_ROTATE
+    0.0f     // 13: RIGHT_ANKLE_LIFT
+}};
+
 // Helper to get the calibrated home position for a servo
-inline float get_home_pos(ServoChannel channel) {
+constexpr float get_home_pos(ServoChannel channel) {
     size_t index = static_cast<size_t>(channel);
     if (index < trims.size()) {
         return 90.0f + trims[index];
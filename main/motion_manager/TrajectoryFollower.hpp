@@ -0,0 +1,79 @@
+#pragma once
+
+#include "motion_manager/Motion_types.hpp"
+#include "motion_manager/ServoCalibration.hpp"
+#include <cmath>
+#include <cstdint>
+
+// Velocity- and acceleration-limited follower between the mixer and the
+// servos, one lane per joint. A joint moves with its target's own velocity
+// (estimated from the last two targets) plus a correction that closes the
+// remaining error as fast as the acceleration limit allows while still being
+// able to brake onto the target. A smooth target is therefore followed with
+// almost no lag, where an exponential filter lags in proportion to speed, and
+// a jump is turned into a move that respects the joint's limits. State is a
+// plain float array per quantity and every step is one branch-free loop over
+// the joints.
+class TrajectoryFollower {
+public:
+    TrajectoryFollower() {
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            m_position[i] = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
+            m_velocity[i] = 0.0f;
+            m_last_target[i] = m_position[i];
+            m_max_velocity[i] = ServoCalibration::motion_limits[i].max_velocity;
+            m_max_acceleration[i] = ServoCalibration::motion_limits[i].max_acceleration;
+        }
+    }
+
+    // Puts a joint at rest at position.
+    void reset(int joint, float position) {
+        m_position[joint] = position;
+        m_velocity[joint] = 0.0f;
+        m_last_target[joint] = position;
+    }
+
+    // Limits must be positive.
+    void set_limits(int joint, float max_velocity, float max_acceleration) {
+        m_max_velocity[joint] = max_velocity;
+        m_max_acceleration[joint] = max_acceleration;
+    }
+
+    // Advances the joints in mask by dt seconds toward target. The others
+    // stay where they are, at rest.
+    void step(const float (&target)[GAIT_JOINT_COUNT], uint32_t mask, float dt) {
+        float driven[GAIT_JOINT_COUNT];
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            driven[i] = (mask >> i) & 1u ? 1.0f : 0.0f;
+        }
+        const float inv_dt = 1.0f / dt;
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            const float a = m_max_acceleration[i];
+            const float v_max = m_max_velocity[i];
+            const float goal = m_position[i] + driven[i] * (target[i] - m_position[i]);
+            const float target_velocity = (goal - m_last_target[i]) * inv_dt;
+            // Error left once the target's own motion is matched. The fastest
+            // closing speed w on top of it from which covering this step and
+            // then braking at a still meets the target: w dt + w^2 / (2 a) = |error|.
+            // Near the target this is error / dt, so the joint lands on it.
+            const float error = goal - m_position[i] - target_velocity * dt;
+            float closing = a * (std::sqrt(dt * dt + 2.0f * std::fabs(error) / a) - dt);
+            float desired = std::fmax(-v_max, std::fmin(v_max, target_velocity + std::copysign(closing, error)));
+            float change = std::fmax(-a * dt, std::fmin(a * dt, desired - m_velocity[i]));
+            float velocity = (m_velocity[i] + change) * driven[i];
+            m_velocity[i] = velocity;
+            m_position[i] += velocity * dt;
+            m_last_target[i] = goal;
+        }
+    }
+
+    float position(int joint) const { return m_position[joint]; }
+    float velocity(int joint) const { return m_velocity[joint]; }
+
+private:
+    float m_position[GAIT_JOINT_COUNT];         // Degrees
+    float m_velocity[GAIT_JOINT_COUNT];         // Degrees per second
+    float m_last_target[GAIT_JOINT_COUNT];      // Target of the previous step
+    float m_max_velocity[GAIT_JOINT_COUNT];
+    float m_max_acceleration[GAIT_JOINT_COUNT];
+};
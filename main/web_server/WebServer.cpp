@@ -16,6 +16,8 @@
 
 static const char *TAG = "WebServer";
 
+#define MOTION_TRACE_FILE "/sdcard/motion_trace.bin"
+
 // Forward declarations for static handlers
 static esp_err_t tuning_api_handler(httpd_req_t *req);
 static esp_err_t command_api_handler(httpd_req_t *req);
@@ -26,6 +28,8 @@ static esp_err_t animations_api_handler(httpd_req_t *req);
 static esp_err_t play_animation_handler(httpd_req_t *req);
 static esp_err_t delete_animation_handler(httpd_req_t *req);
 static esp_err_t filter_alpha_api_handler(httpd_req_t *req);
+static esp_err_t motion_trace_handler(httpd_req_t *req);
+static esp_err_t mixer_api_handler(httpd_req_t *req);
 static void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
 
 extern const char index_html_start[] asm("_binary_index_html_start");
@@ -33,8 +37,8 @@ extern const char index_html_end[]   asm("_binary_index_html_end");
 
 class WebServerImpl {
 public:
-    WebServerImpl(AnimationPlayer& animation_player) 
-        : m_animation_player(animation_player) {}
+    WebServerImpl(AnimationPlayer& animation_player, MotionController* motion_controller) 
+        : m_animation_player(animation_player), m_motion_controller(motion_controller) {}
 
     void start() {
         wifi_init();
@@ -42,6 +46,7 @@ public:
 
 private:
     AnimationPlayer& m_animation_player;
+    MotionController* m_motion_controller; // May be null when motion is disabled
     httpd_handle_t m_server = NULL;
 
     void wifi_init() {
@@ -107,6 +112,12 @@ private:
             httpd_uri_t delete_animation_uri = { .uri = "/api/delete", .method = HTTP_GET, .handler = delete_animation_handler, .user_ctx = this };
             httpd_register_uri_handler(m_server, &delete_animation_uri);
 
+            httpd_uri_t motion_trace_uri = { .uri = "/api/trace", .method = HTTP_GET, .handler = motion_trace_handler, .user_ctx = this };
+            httpd_register_uri_handler(m_server, &motion_trace_uri);
+
+            httpd_uri_t mixer_uri = { .uri = "/api/mixer", .method = HTTP_GET, .handler = mixer_api_handler, .user_ctx = this };
+            httpd_register_uri_handler(m_server, &mixer_uri);
+
             // httpd_uri_t filter_alpha_uri = { .uri = "/api/set_filter_alpha", .method = HTTP_GET, .handler = filter_alpha_api_handler, .user_ctx = this };
             // httpd_register_uri_handler(m_server, &filter_alpha_uri);
 
@@ -121,6 +132,8 @@ private:
     friend esp_err_t root_handler(httpd_req_t *req);
     friend esp_err_t play_animation_handler(httpd_req_t *req);
     friend esp_err_t delete_animation_handler(httpd_req_t *req);
+    friend esp_err_t motion_trace_handler(httpd_req_t *req);
+    friend esp_err_t mixer_api_handler(httpd_req_t *req);
     friend void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
 };
 
@@ -427,12 +440,150 @@ void wifi_event_handler(void* arg, esp_event_base_t event_base, int32_t event_id
     }
 }
 
+// GET /api/trace downloads the motion trace (decode with tools/mtrace);
+// /api/trace?save=1 writes it to the SD card instead, ?clear=1 empties it.
+esp_err_t motion_trace_handler(httpd_req_t *req) {
+    WebServerImpl* server = (WebServerImpl*)req->user_ctx;
+    if (server->m_motion_controller == nullptr) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Motion controller not running");
+        return ESP_FAIL;
+    }
+
+    char query[32];
+    char value[8];
+    bool has_query = httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK;
+    if (has_query && httpd_query_key_value(query, "clear", value, sizeof(value)) == ESP_OK) {
+        if (!server->m_motion_controller->clear_motion_trace()) {
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to clear motion trace");
+            return ESP_FAIL;
+        }
+        httpd_resp_send(req, "Motion trace cleared", HTTPD_RESP_USE_STRLEN);
+        return ESP_OK;
+    }
+    if (has_query && httpd_query_key_value(query, "save", value, sizeof(value)) == ESP_OK) {
+        if (!server->m_motion_controller->save_motion_trace(MOTION_TRACE_FILE)) {
+            httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, "Failed to save motion trace");
+            return ESP_FAIL;
+        }
+        httpd_resp_send(req, "Motion trace saved to " MOTION_TRACE_FILE, HTTPD_RESP_USE_STRLEN);
+        return ESP_OK;
+    }
+
+    httpd_resp_set_type(req, "application/octet-stream");
+    httpd_resp_set_hdr(req, "Content-Disposition", "attachment; filename=\"motion_trace.bin\"");
+    bool ok = server->m_motion_controller->write_motion_trace([req](const void* data, size_t size) {
+        return httpd_resp_send_chunk(req, static_cast<const char*>(data), size) == ESP_OK;
+    });
+    // Headers are already out, so a failed dump just ends with a truncated file.
+    httpd_resp_send_chunk(req, NULL, 0);
+    return ok ? ESP_OK : ESP_FAIL;
+}
+
+// Appends "key":[v0,v1,...] to a JSON object under construction
+static void append_json_array(std::string& json, const char* key, const uint32_t* values, int count) {
+    char number[16];
+    json += "\"";
+    json += key;
+    json += "\":[";
+    for (int i = 0; i < count; ++i) {
+        snprintf(number, sizeof(number), i == 0 ? "%u" : ",%u", (unsigned)values[i]);
+        json += number;
+    }
+    json += "]";
+}
+
+// GET /api/mixer reports the mixer rate, clock health and stage timing as
+// JSON, with the servo bus, active action set and command queue counters.
+// ?rate=50|100|200 sets the rate first (refused if a tick cannot fit the
+// period), ?reset=1 restarts the timing statistics.
+esp_err_t mixer_api_handler(httpd_req_t *req) {
+    WebServerImpl* server = (WebServerImpl*)req->user_ctx;
+    if (server->m_motion_controller == nullptr) {
+        httpd_resp_send_err(req, HTTPD_404_NOT_FOUND, "Motion controller not running");
+        return ESP_FAIL;
+    }
+    MotionController& motion = *server->m_motion_controller;
+
+    char query[32];
+    char value[8];
+    bool has_query = httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK;
+    if (has_query && httpd_query_key_value(query, "rate", value, sizeof(value)) == ESP_OK) {
+        const int rate = atoi(value);
+        if (rate != 50 && rate != 100 && rate != 200) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Mixer rate must be 50, 100 or 200");
+            return ESP_FAIL;
+        }
+        if (!motion.set_mixer_rate(static_cast<MixerRate>(rate))) {
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "Mixer rate refused: a tick does not fit its period");
+            return ESP_FAIL;
+        }
+    }
+    if (has_query && httpd_query_key_value(query, "reset", value, sizeof(value)) == ESP_OK) {
+        motion.reset_mixer_timing_stats();
+    }
+
+    const MixerTimingStats timing = motion.get_mixer_timing_stats();
+    const StageTimingStats stages = motion.get_stage_timing_stats();
+    uint32_t tick_budget_us = 0;
+    for (int i = 0; i < MOTION_STAGE_COUNT; ++i) {
+        tick_budget_us += stages.budget_us[i];
+    }
+
+    char field[320]; // Room for every counter at its widest
+    std::string json = "{";
+    snprintf(field, sizeof(field),
+             "\"rate_hz\":%d,\"tick_budget_us\":%u,\"period_us\":%u,\"ticks\":%u,\"overruns\":%u,"
+             "\"max_jitter_us\":%u,\"max_compute_us\":%u,",
+             static_cast<int>(motion.get_mixer_rate()), (unsigned)tick_budget_us, (unsigned)timing.period_us,
+             (unsigned)timing.ticks, (unsigned)timing.overruns, (unsigned)timing.max_jitter_us,
+             (unsigned)timing.max_compute_us);
+    json += field;
+    append_json_array(json, "hist_bounds_us", MIXER_HIST_BOUNDS_US, MIXER_HIST_BUCKETS - 1);
+    json += ",";
+    append_json_array(json, "jitter_hist", timing.jitter_hist, MIXER_HIST_BUCKETS);
+    json += ",";
+    append_json_array(json, "compute_hist", timing.compute_hist, MIXER_HIST_BUCKETS);
+    // Stages in MotionStage order: tracking, behavior, dispatch, mixer
+    json += ",";
+    append_json_array(json, "stage_budget_us", stages.budget_us, MOTION_STAGE_COUNT);
+    json += ",";
+    append_json_array(json, "stage_max_us", stages.max_us, MOTION_STAGE_COUNT);
+    json += ",";
+    append_json_array(json, "stage_over_budget", stages.over_budget, MOTION_STAGE_COUNT);
+
+    const ServoWriteStats servo = motion.get_servo_write_stats();
+    snprintf(field, sizeof(field), ",\"servo\":{\"transactions\":%u,\"channels_written\":%u,\"channels_suppressed\":%u}",
+             (unsigned)servo.transactions, (unsigned)servo.channels_written, (unsigned)servo.channels_suppressed);
+    json += field;
+    const ActionSetStats actions = motion.get_action_set_stats();
+    snprintf(field, sizeof(field),
+             ",\"action_set\":{\"edits_applied\":%u,\"edits_dropped\":%u,\"sequences_dropped\":%u,"
+             "\"snapshot_retries\":%u,\"mixer_wait_max_us\":%u,\"mixer_wait_total_us\":%llu}",
+             (unsigned)actions.edits_applied, (unsigned)actions.edits_dropped, (unsigned)actions.sequences_dropped,
+             (unsigned)actions.snapshot_retries, (unsigned)actions.mixer_wait_max_us,
+             (unsigned long long)actions.mixer_wait_total_us);
+    json += field;
+    const MotionCommandStats commands = motion.get_command_stats();
+    snprintf(field, sizeof(field),
+             ",\"commands\":{\"queued\":%u,\"dropped\":%u,\"flushed\":%u,\"high_water\":%u,\"deferred\":%u,"
+             "\"coalesced\":%u,\"expired\":%u,\"latency_max_us\":%u,\"latency_last_us\":%u}",
+             (unsigned)commands.queued, (unsigned)commands.dropped, (unsigned)commands.flushed,
+             (unsigned)commands.high_water, (unsigned)commands.deferred, (unsigned)commands.coalesced,
+             (unsigned)commands.expired, (unsigned)commands.latency_max_us, (unsigned)commands.latency_last_us);
+    json += field;
+    json += "}";
+
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json.c_str(), json.length());
+    return ESP_OK;
+}
+
 // --- Public WebServer Class --- 
 
-WebServer::WebServer(AnimationPlayer& animation_player)
-    : m_animation_player(animation_player) {}
+WebServer::WebServer(AnimationPlayer& animation_player, MotionController* motion_controller)
+    : m_animation_player(animation_player), m_motion_controller(motion_controller) {}
 
 void WebServer::start() {
-    WebServerImpl* impl = new WebServerImpl(m_animation_player);
+    WebServerImpl* impl = new WebServerImpl(m_animation_player, m_motion_controller);
     impl->start();
 }
\ No newline at end of file
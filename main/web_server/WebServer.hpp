@@ -9,9 +9,11 @@ class AnimationPlayer;
 
 class WebServer {
 public:
-    WebServer(AnimationPlayer& animation_player);
+    // motion_controller is optional; without it the motion endpoints report 404.
+    WebServer(AnimationPlayer& animation_player, MotionController* motion_controller = nullptr);
     void start();
 
 private:
     AnimationPlayer& m_animation_player;
+    MotionController* m_motion_controller;
 };
@@ -0,0 +1,33 @@
+#pragma once
+
+// Pass/fail reporting shared by the host check tools. Each check prints one
+// line; finish() prints the verdict and gives main() its exit status, so a
+// failing check fails the run. Include it with a path relative to the tool:
+//   #include "../HostCheck.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace HostCheck {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline void check(bool ok, const char* what) {
+    printf("%s: %s\n", ok ? "ok  " : "FAIL", what);
+    if (!ok) ++failures();
+}
+
+// EXIT_FAILURE if any check failed.
+inline int finish() {
+    if (failures() > 0) {
+        printf("%d check(s) failed\n", failures());
+        return EXIT_FAILURE;
+    }
+    printf("all checks passed\n");
+    return EXIT_SUCCESS;
+}
+
+} // namespace HostCheck
@@ -0,0 +1,251 @@
+// actionids - host check of interned action ids and roles, and a
+// microbenchmark of the executor tick with 1, 4 and 8 actions running. The
+// ids must be dense and round-trip through their names, the role bits must
+// match the actions the mixer and tracker treat specially, and the
+// controller's role queries must follow what actually runs. Last, a thread
+// tunes a running gait while the executor ticks: the executor must never
+// block on it (Linux only: counted from the thread's voluntary context
+// switches) and must pick up the latest edit.
+//
+// Build on the host from this directory:
+//   g++ -std=gnu++2b -O2 -pthread -I../motionsim -I../motionsim/idf -I../../main -I../../main/motion_manager -I../../main/driver
+//       -o actionids actionids.cpp ../motionsim/HostPlatform.cpp ../motionsim/HostIdf.cpp
+//       $(ls ../../main/motion_manager/*.cpp | grep -v MotionPlatform)
+// (one command line)
+//
+// Usage:
+//   actionids [ticks]   (default 20000); exits 1 if a check fails
+
+#include "HostPlatform.hpp"
+#include "driver/MockServo.hpp"
+#include "motion_manager/ActionManager.hpp"
+#include "motion_manager/DefaultActions.hpp"
+#include "motion_manager/MotionController.hpp"
+#include "../HostCheck.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <sys/resource.h>
+
+namespace {
+
+using HostCheck::check;
+
+const struct {
+    const char* name;
+    uint8_t roles;
+} EXPECTED_ROLES[] = {
+    {"head_track",    ACTION_ROLE_HEAD_TRACK},
+    {"walk_forward",  ACTION_ROLE_BODY_MOVING},
+    {"walk_backward", ACTION_ROLE_BODY_MOVING},
+    {"turn_left",     ACTION_ROLE_BODY_MOVING},
+    {"turn_right",    ACTION_ROLE_BODY_MOVING},
+    {"tracking_L",    ACTION_ROLE_BODY_MOVING | ACTION_ROLE_TRACKING_TURN},
+    {"tracking_R",    ACTION_ROLE_BODY_MOVING | ACTION_ROLE_TRACKING_TURN},
+    {"wave_hand",     ACTION_ROLE_NONE},
+    {"nod_head",      ACTION_ROLE_NONE},
+};
+
+// Non-atomic actions that run side by side, for the tick benchmark
+const char* const CONCURRENT[] = {"walk_forward", "wiggle_ears", "wave_hand",  "nod_head",
+                                  "happy",        "look_around", "very_happy", "sad"};
+static_assert(sizeof(CONCURRENT) / sizeof(CONCURRENT[0]) == MAX_ACTIVE_ACTIONS, "One per mixer slot");
+
+constexpr int64_t TICK_US = 20000;
+
+void play(MotionController& controller, const char* name) {
+    motion_command_t command = {};
+    command.motion_type = MOTION_PLAY_MOTION;
+    motion_command_set_params(command, reinterpret_cast<const uint8_t*>(name), strlen(name));
+    controller.queue_command(command);
+}
+
+void run_ticks(MotionController& controller, int64_t& now_us, int ticks) {
+    for (int n = 0; n < ticks; ++n) {
+        HostPlatform::set_now_us(now_us);
+        controller.step(now_us);
+        now_us += TICK_US;
+    }
+}
+
+void check_ids(ActionManager& manager) {
+    const size_t count = manager.action_id_count();
+    bool dense = count > 0;
+    for (size_t id = 0; id < count; ++id) {
+        const char* name = manager.get_action_name(static_cast<ActionId>(id));
+        dense &= name != nullptr && manager.get_action_id(name) == id;
+    }
+    check(dense, "ids are dense and round-trip through their names");
+
+    bool builtins = true;
+    for (const auto& action : DefaultActions::actions()) {
+        builtins &= manager.get_action_id(action.name) != INVALID_ACTION_ID;
+    }
+    check(builtins, "every built-in action has an id");
+
+    const ActionId walk = manager.get_action_id("walk_forward");
+    check(manager.intern_action_id("walk_forward") == walk && manager.action_id_count() == count,
+          "interning a known name returns its id and adds none");
+    check(manager.get_action_id("no_such_action") == INVALID_ACTION_ID, "an unknown name has no id");
+    check(manager.get_action_name(static_cast<ActionId>(count)) == nullptr &&
+              manager.get_action_name(INVALID_ACTION_ID) == nullptr,
+          "an unknown id has no name");
+    check(manager.get_action_roles(INVALID_ACTION_ID) == ACTION_ROLE_NONE, "an unknown id has no roles");
+
+    bool roles = true;
+    for (const auto& expected : EXPECTED_ROLES) {
+        const ActionId id = manager.get_action_id(expected.name);
+        if (id == INVALID_ACTION_ID || manager.get_action_roles(id) != expected.roles) {
+            printf("      %s: roles 0x%02x, expected 0x%02x\n", expected.name,
+                   id == INVALID_ACTION_ID ? 0xFF : manager.get_action_roles(id), expected.roles);
+            roles = false;
+        }
+    }
+    check(roles, "role bits match the actions the mixer and tracker single out");
+}
+
+void check_controller_roles() {
+    MockServo servo;
+    ActionManager manager;
+    MotionController controller(servo, manager);
+    HostPlatform::set_now_us(0);
+    manager.init();
+    controller.init(false);
+    int64_t now_us = 0;
+
+    check(controller.is_body_moving(*manager.get_action("walk_forward")) &&
+              !controller.is_body_moving(*manager.get_action("wave_hand")),
+          "is_body_moving() of a template follows its role");
+
+    play(controller, "wave_hand");
+    run_ticks(controller, now_us, 5);
+    check(!controller.is_body_moving(), "a gesture does not move the body");
+    play(controller, "walk_forward");
+    run_ticks(controller, now_us, 5);
+    check(controller.is_body_moving(), "a running walk moves the body");
+
+    motion_command_t command = {};
+    command.motion_type = MOTION_FACE_TRACE;
+    controller.queue_command(command);
+    run_ticks(controller, now_us, 5);
+    check(controller.is_face_tracking_active(), "face tracking runs the head_track role");
+
+    command.motion_type = MOTION_STOP;
+    controller.queue_command(command);
+    run_ticks(controller, now_us, 5);
+    check(!controller.is_body_moving() && !controller.is_face_tracking_active(), "STOP clears every role");
+}
+
+float g_sink; // Keeps the results alive
+
+void bench_ticks(int actions, int ticks) {
+    MockServo servo;
+    ActionManager manager;
+    MotionController controller(servo, manager);
+    HostPlatform::set_now_us(0);
+    manager.init();
+    controller.init(false);
+    int64_t now_us = 0;
+    for (int n = 0; n < actions; ++n) {
+        // Long enough that nothing finishes during the run
+        const RegisteredAction* action = manager.get_action(CONCURRENT[n]);
+        const uint32_t period_ms = action->type == ActionType::GAIT_PERIODIC ? action->data.gait.gait_period_ms : 0;
+        manager.update_action_properties(CONCURRENT[n], false, 1000000, period_ms);
+        play(controller, CONCURRENT[n]);
+    }
+    run_ticks(controller, now_us, 2);
+    const uint32_t started = controller.get_action_set_stats().edits_applied;
+
+    auto start = std::chrono::steady_clock::now();
+    run_ticks(controller, now_us, ticks);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    g_sink += servo.angle(0);
+
+    const double us = std::chrono::duration<double, std::micro>(elapsed).count() / ticks;
+    printf("%d action(s)   %6.2f us/tick\n", actions, us);
+    check(started == static_cast<uint32_t>(actions) && !controller.is_idle(), "every benchmarked action runs");
+}
+
+// Times the calling thread gave up the CPU to wait, on a lock or otherwise
+long blocked_count() {
+    rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return usage.ru_nvcsw;
+}
+
+// Ticks the executor while another thread tunes the running gait as fast as
+// it can. The executor must never block on the tuning thread, and the
+// running action must end up on the latest template.
+void bench_tuning(int ticks) {
+    MockServo servo;
+    ActionManager manager;
+    MotionController controller(servo, manager);
+    HostPlatform::set_now_us(0);
+    manager.init();
+    controller.init(false);
+    int64_t now_us = 0;
+    const uint32_t period_ms = manager.get_action("walk_forward")->data.gait.gait_period_ms;
+    manager.update_action_properties("walk_forward", false, 1000000, period_ms);
+    play(controller, "walk_forward");
+    run_ticks(controller, now_us, 2);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> edits{0};
+    std::thread tuner([&] {
+        for (int n = 0; !stop.load(std::memory_order_relaxed); ++n) {
+            manager.tune_gait_parameter("walk_forward", n % GAIT_JOINT_COUNT, "amplitude", 10.0f + n % 7);
+            edits.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+    while (edits.load() == 0) std::this_thread::yield();
+    const long blocked_before = blocked_count();
+    auto start = std::chrono::steady_clock::now();
+    run_ticks(controller, now_us, ticks);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    const long blocked = blocked_count() - blocked_before;
+    stop.store(true);
+    tuner.join();
+    printf("%d ticks against %d template edits: blocked %ld times, %6.2f us/tick\n", ticks, edits.load(), blocked,
+           std::chrono::duration<double, std::micro>(elapsed).count() / ticks);
+    check(blocked == 0, "the executor never waits for a template edit");
+
+    // An atomic walk defers the next command, once the mixer has taken it up
+    manager.update_action_properties("walk_forward", true, 1000000, period_ms);
+    run_ticks(controller, now_us, 1);
+    play(controller, "wave_hand");
+    run_ticks(controller, now_us, 1);
+    check(controller.get_command_stats().deferred == 1, "a running action picks up the latest template edit");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int ticks = argc > 1 ? std::atoi(argv[1]) : 20000;
+    if (ticks <= 0) {
+        fprintf(stderr, "usage: actionids [ticks]\n");
+        return 2;
+    }
+
+    {
+        MockServo servo;
+        ActionManager manager;
+        MotionController controller(servo, manager); // Interns head_track
+        HostPlatform::set_now_us(0);
+        manager.init();
+        controller.init(false);
+        check_ids(manager);
+    }
+    check_controller_roles();
+    for (int actions : {1, 4, 8}) {
+        bench_ticks(actions, ticks);
+    }
+    bench_tuning(ticks);
+
+    const int status = HostCheck::finish();
+    return g_sink == 12345.0f ? EXIT_FAILURE : status; // Never true; stops the sink being optimized out
+}
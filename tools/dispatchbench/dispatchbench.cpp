@@ -0,0 +1,117 @@
+// dispatchbench - host microbenchmark of motion command dispatch: resolving
+// a command code to the templates it starts, and the reverse lookup of
+// MotionController::get_current_command(), through CommandTable against the
+// name map and string lookups they replaced.
+//
+// Build on the host from this directory:
+//   g++ -std=gnu++2b -O2 -I../motionsim/idf -I../../main -I../../main/motion_manager -o dispatchbench
+//       dispatchbench.cpp ../motionsim/HostIdf.cpp ../motionsim/HostPlatform.cpp
+//       ../../main/motion_manager/{ActionManager,CommandTable,DefaultActions,MotionPack,MotionPackSource,MotionStorage}.cpp
+// (one command line)
+//
+// Usage:
+//   dispatchbench [dispatches]   (default 2000000)
+
+#include "motion_manager/ActionManager.hpp"
+#include "motion_manager/CommandTable.hpp"
+#include "motion_manager/MotionCommands.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace {
+
+// The codes MotionController binds that resolve to a built-in action or group
+const std::pair<uint8_t, const char*> BINDINGS[] = {
+    {MOTION_FORWARD, "walk_forward"},   {MOTION_BACKWARD, "walk_backward"}, {MOTION_LEFT, "turn_left"},
+    {MOTION_RIGHT, "turn_right"},       {MOTION_WAVE_HAND, "wave_hand"},    {MOTION_WAVE_HELLO, "wave_hello"},
+    {MOTION_MOVE_EAR, "wiggle_ears"},   {MOTION_NOD_HEAD, "nod_head"},      {MOTION_SHAKE_HEAD, "shake_head"},
+    {MOTION_HAPPY, "happy"},            {MOTION_SAD, "sad"},                {MOTION_DANCE, "dance"},
+    {MOTION_FUNNY, "funny"},            {MOTION_VERY_HAPPY, "very_happy"},  {MOTION_ANGRY, "angry"},
+    {MOTION_CRYING, "sudden_shock"},    {MOTION_SURPRISED, "curious_ponder"},
+    {MOTION_TRACKING_L, "tracking_L"},  {MOTION_TRACKING_R, "tracking_R"},
+    {MOTION_WALK_BACKWARD_KF, "walk_back_kf"}, {MOTION_WALK_FORWARD_KF, "walk_forward_kf"},
+};
+constexpr int BINDING_COUNT = sizeof(BINDINGS) / sizeof(BINDINGS[0]);
+
+uintptr_t g_sink; // Keeps the results alive
+
+template <typename Step>
+void bench(const char* name, int count, Step step) {
+    uintptr_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < count; ++n) {
+        sum += step(BINDINGS[n % BINDING_COUNT].first);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    g_sink += sum;
+    printf("%-36s %8.1f ns\n", name, std::chrono::duration<double, std::nano>(elapsed).count() / count);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int count = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    if (count <= 0) {
+        fprintf(stderr, "usage: dispatchbench [dispatches]\n");
+        return 2;
+    }
+
+    ActionManager manager;
+    manager.init();
+    std::map<uint8_t, std::string> command_map;
+    CommandTable table;
+    for (const auto& binding : BINDINGS) {
+        command_map[binding.first] = binding.second;
+        table.bind(binding.first, binding.second);
+    }
+    table.build(manager, manager.edit_generation());
+
+    // What MotionController::dispatch_named_action() did for every command
+    bench("dispatch, name map (old)", count, [&](uint8_t code) {
+        const std::string& name = command_map.at(code);
+        uintptr_t staged = 0;
+        const RegisteredGroup* group = manager.get_group(name);
+        if (group) {
+            for (uint8_t i = 0; i < group->action_count; ++i) {
+                std::string member_name = group->action_names[i];
+                staged += reinterpret_cast<uintptr_t>(manager.get_action(member_name)) +
+                          manager.get_action_id(member_name);
+            }
+            return staged;
+        }
+        return reinterpret_cast<uintptr_t>(manager.get_action(name)) + manager.get_action_id(name);
+    });
+    bench("dispatch, CommandTable", count, [&](uint8_t code) {
+        const CommandTable::Target* target = table.find(code);
+        uintptr_t staged = 0;
+        for (uint8_t i = 0; i < target->member_count; ++i) {
+            staged += reinterpret_cast<uintptr_t>(target->members[i].action) + target->members[i].id;
+        }
+        return staged;
+    });
+
+    // get_current_command() for an action started by each code in turn
+    ActionId running[256] = {};
+    for (const auto& binding : BINDINGS) {
+        running[binding.first] = manager.get_action_id(binding.second);
+    }
+    bench("current command, name scan (old)", count, [&](uint8_t code) {
+        const char* active = manager.get_action_name(running[code]);
+        for (const auto& pair : command_map) {
+            if (active && pair.second == active) return static_cast<uintptr_t>(pair.first);
+        }
+        return uintptr_t(0);
+    });
+    bench("current command, CommandTable", count, [&](uint8_t code) {
+        uint8_t found = 0;
+        table.code_for(running[code], found);
+        return static_cast<uintptr_t>(found);
+    });
+
+    return g_sink == 12345; // Never true; stops the sink being optimized out
+}
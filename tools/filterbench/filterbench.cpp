@@ -0,0 +1,271 @@
+// filterbench - host microbenchmark of the mixer's per-tick output stages:
+// JointFilterBank and TrajectoryFollower, against the per-joint EMA filter
+// objects they replaced. It also compares their lag at equal peak
+// acceleration: for each old EMA alpha, the bank's cutoff and the follower's
+// acceleration limit are set so neither accelerates harder than the EMA, and
+// the follower must then lag least on a swing and on a step. The swing and
+// the step are budgeted apart, each from the EMA's peak within it.
+//
+// Build on the host from this directory:
+//   g++ -std=c++20 -O2 -I../../main -I../../main/motion_manager -o filterbench filterbench.cpp
+// Add -fno-tree-vectorize to see what the vectorized loops are worth.
+//
+// Usage:
+//   filterbench [ticks]   (default 2000000); exits 1 if a lag check fails
+
+#include "motion_manager/JointFilterBank.hpp"
+#include "motion_manager/TrajectoryFollower.hpp"
+#include "../HostCheck.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+namespace {
+
+// The per-joint filter the mixer used before JointFilterBank
+class ScalarEma {
+public:
+    explicit ScalarEma(float alpha) : m_alpha(alpha), m_value(NAN) {}
+    float apply(float input) {
+        if (std::isnan(m_value)) {
+            m_value = input;
+        } else {
+            m_value = m_alpha * input + (1.0f - m_alpha) * m_value;
+        }
+        return m_value;
+    }
+
+private:
+    float m_alpha;
+    float m_value;
+};
+
+// A gait-like input: every joint swings at its own rate around 90 deg.
+std::vector<float> make_input(int ticks) {
+    std::vector<float> input(static_cast<size_t>(ticks) * GAIT_JOINT_COUNT);
+    for (int t = 0; t < ticks; ++t) {
+        for (int j = 0; j < GAIT_JOINT_COUNT; ++j) {
+            input[static_cast<size_t>(t) * GAIT_JOINT_COUNT + j] =
+                90.0f + 30.0f * std::sin(0.02f * t * (1.0f + 0.1f * j));
+        }
+    }
+    return input;
+}
+
+// --- Lag at equal peak acceleration ---
+
+constexpr float DT = 0.02f;       // 50 Hz mixer
+constexpr int REST_TICKS = 25;    // 0.5 s at 90 deg
+constexpr int SWING_TICKS = 100;  // Then a 1 Hz 30 deg swing from rest
+constexpr int STEP_TICKS = 50;    // Then a jump to 110 deg
+constexpr float STEP_TARGET = 110.0f;
+constexpr float SETTLED_DEG = 0.5f;
+
+using HostCheck::check;
+
+std::vector<float> make_lag_input() {
+    std::vector<float> input;
+    for (int n = 0; n < REST_TICKS; ++n) input.push_back(90.0f);
+    for (int n = 0; n < SWING_TICKS; ++n) {
+        input.push_back(90.0f + 15.0f * (1.0f - std::cos(2.0f * static_cast<float>(M_PI) * n * DT)));
+    }
+    for (int n = 0; n < STEP_TICKS; ++n) input.push_back(STEP_TARGET);
+    return input;
+}
+
+struct LagResult {
+    float swing_acceleration; // Peak over rest and swing, deg/s^2, from second differences of the output
+    float step_acceleration;  // Peak from the jump on
+    float swing_lag;          // Largest distance behind the swing once under way, deg
+    float settle_s;           // Time after the jump until the output stays within SETTLED_DEG
+    float step_delay_s;       // Integrated step error over the jump size: the mean delay
+};
+
+// Runs one joint's stage over the lag input, one sample per tick
+LagResult measure_lag(const std::function<float(float)>& stage) {
+    const std::vector<float> input = make_lag_input();
+    std::vector<float> output;
+    for (float target : input) output.push_back(stage(target));
+
+    LagResult result = {};
+    const int step_start = REST_TICKS + SWING_TICKS;
+    for (int n = 1; n + 1 < static_cast<int>(output.size()); ++n) {
+        const float acceleration = std::fabs(output[n + 1] - 2.0f * output[n] + output[n - 1]) / (DT * DT);
+        float& peak = n + 1 < step_start ? result.swing_acceleration : result.step_acceleration;
+        peak = std::max(peak, acceleration);
+    }
+    for (int n = REST_TICKS + SWING_TICKS / 8; n < step_start; ++n) {
+        result.swing_lag = std::max(result.swing_lag, std::fabs(input[n] - output[n]));
+    }
+    const float jump = STEP_TARGET - input[step_start - 1];
+    int settled = step_start;
+    for (int n = step_start; n < static_cast<int>(output.size()); ++n) {
+        if (std::fabs(output[n] - STEP_TARGET) >= SETTLED_DEG) settled = n + 1;
+        result.step_delay_s += std::fabs(STEP_TARGET - output[n]) * DT / jump;
+    }
+    result.settle_s = (settled - step_start) * DT;
+    return result;
+}
+
+LagResult ema_lag(float alpha) {
+    ScalarEma ema(alpha);
+    ema.apply(90.0f);
+    return measure_lag([&ema](float target) { return ema.apply(target); });
+}
+
+LagResult bank_lag(float cutoff_hz) {
+    JointFilterBank bank;
+    bank.set_sample_rate(1.0f / DT);
+    bank.set_filter(0, {ServoCalibration::FilterOrder::SECOND, cutoff_hz, 0.7071f});
+    bank.reset(0, 90.0f);
+    return measure_lag([&bank](float target) {
+        float angles[GAIT_JOINT_COUNT] = {};
+        angles[0] = target;
+        bank.process(angles);
+        return angles[0];
+    });
+}
+
+LagResult follower_lag(float max_acceleration) {
+    TrajectoryFollower follower;
+    follower.reset(0, 90.0f);
+    follower.set_limits(0, 10000.0f, max_acceleration); // Only acceleration limited
+    return measure_lag([&follower](float target) {
+        float angles[GAIT_JOINT_COUNT] = {};
+        angles[0] = target;
+        follower.step(angles, 1u, DT);
+        return follower.position(0);
+    });
+}
+
+void print_lag(const char* name, const LagResult& result) {
+    printf("  %-30s swing peak %6.0f deg/s^2 lag %5.2f deg  step peak %6.0f deg/s^2 settles in %3.0f ms"
+           "  mean delay %4.1f ms\n",
+           name, result.swing_acceleration, result.swing_lag, result.step_acceleration, result.settle_s * 1000.0f,
+           result.step_delay_s * 1000.0f);
+}
+
+// The highest second-order cutoff whose peak in the window stays within
+// budget; the design caps the cutoff at 0.45 of the sample rate.
+float bank_cutoff_within(float budget, float LagResult::*peak) {
+    float low = 0.1f;
+    float high = 0.45f / DT;
+    for (int n = 0; n < 40; ++n) {
+        const float mid = 0.5f * (low + high);
+        (bank_lag(mid).*peak > budget ? high : low) = mid;
+    }
+    return low;
+}
+
+// For each alpha the mixer used, the EMA's own peak acceleration in a
+// window is the budget there: the bank gets the highest cutoff within it,
+// the follower gets it as its acceleration limit. The jump's peak is far
+// above the swing's, so the swing is judged on its own budget, not the
+// jump's.
+void compare_lag() {
+    for (float alpha : {0.8f, 0.3f}) {
+        const LagResult ema = ema_lag(alpha);
+
+        const float swing_budget = ema.swing_acceleration;
+        const float swing_cutoff = bank_cutoff_within(swing_budget, &LagResult::swing_acceleration);
+        const LagResult swing_bank = bank_lag(swing_cutoff);
+        const LagResult swing_follower = follower_lag(swing_budget);
+        printf("EMA alpha %.1f, swing budget %.0f deg/s^2, bank cutoff %.1f Hz:\n", alpha, swing_budget, swing_cutoff);
+        print_lag("EMA (old)", ema);
+        print_lag("JointFilterBank, second order", swing_bank);
+        print_lag("TrajectoryFollower", swing_follower);
+        check(swing_bank.swing_acceleration <= swing_budget * 1.001f &&
+                  swing_follower.swing_acceleration <= swing_budget * 1.001f,
+              "the bank and the follower stay within the EMA's peak acceleration on the swing");
+        check(swing_follower.swing_lag < ema.swing_lag && swing_follower.swing_lag < swing_bank.swing_lag,
+              "the follower lags least on the swing");
+
+        const float step_budget = ema.step_acceleration;
+        const float step_cutoff = bank_cutoff_within(step_budget, &LagResult::step_acceleration);
+        const LagResult step_bank = bank_lag(step_cutoff);
+        const LagResult step_follower = follower_lag(step_budget);
+        printf("EMA alpha %.1f, step budget %.0f deg/s^2, bank cutoff %.1f Hz:\n", alpha, step_budget, step_cutoff);
+        print_lag("JointFilterBank, second order", step_bank);
+        print_lag("TrajectoryFollower", step_follower);
+        check(step_bank.step_acceleration <= step_budget * 1.001f &&
+                  step_follower.step_acceleration <= step_budget * 1.001f,
+              "the bank and the follower stay within the EMA's peak acceleration on the step");
+        check(step_follower.settle_s <= ema.settle_s && step_follower.settle_s <= step_bank.settle_s &&
+                  step_follower.step_delay_s < ema.step_delay_s && step_follower.step_delay_s < step_bank.step_delay_s,
+              "the follower settles first and lags least on the step");
+    }
+}
+
+float g_sink; // Keeps the results alive
+
+template <typename Step>
+void bench(const char* name, const std::vector<float>& input, int ticks, Step step) {
+    float angles[GAIT_JOINT_COUNT];
+    float sum = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t) {
+        const float* row = &input[static_cast<size_t>(t % 4096) * GAIT_JOINT_COUNT];
+        for (int j = 0; j < GAIT_JOINT_COUNT; ++j) angles[j] = row[j];
+        step(angles);
+        sum += angles[t % GAIT_JOINT_COUNT];
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    g_sink += sum;
+    double ns = std::chrono::duration<double, std::nano>(elapsed).count() / ticks;
+    printf("%-32s %7.1f ns/tick %6.2f ns/joint\n", name, ns, ns / GAIT_JOINT_COUNT);
+}
+
+JointFilterBank make_bank(ServoCalibration::FilterOrder order) {
+    JointFilterBank bank;
+    for (int j = 0; j < GAIT_JOINT_COUNT; ++j) {
+        bank.set_filter(j, {order, 5.0f, 0.7071f});
+        bank.reset(j, 90.0f);
+    }
+    return bank;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int ticks = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    if (ticks <= 0) {
+        fprintf(stderr, "usage: filterbench [ticks]\n");
+        return 2;
+    }
+    compare_lag();
+
+    const std::vector<float> input = make_input(4096);
+
+    std::vector<ScalarEma> emas(GAIT_JOINT_COUNT, ScalarEma(0.8f));
+    bench("EMA per joint (old)", input, ticks, [&](float* a) {
+        for (int j = 0; j < GAIT_JOINT_COUNT; ++j) a[j] = emas[j].apply(a[j]);
+    });
+
+    JointFilterBank bypass = make_bank(ServoCalibration::FilterOrder::NONE);
+    bench("JointFilterBank, bypass", input, ticks, [&](float* a) { bypass.process(a); });
+    JointFilterBank first = make_bank(ServoCalibration::FilterOrder::FIRST);
+    bench("JointFilterBank, first order", input, ticks, [&](float* a) { first.process(a); });
+    JointFilterBank second = make_bank(ServoCalibration::FilterOrder::SECOND);
+    bench("JointFilterBank, second order", input, ticks, [&](float* a) { second.process(a); });
+
+    TrajectoryFollower follower;
+    for (int j = 0; j < GAIT_JOINT_COUNT; ++j) follower.reset(j, 90.0f);
+    bench("TrajectoryFollower", input, ticks, [&](float* a) {
+        follower.step(*reinterpret_cast<float(*)[GAIT_JOINT_COUNT]>(a), (1u << GAIT_JOINT_COUNT) - 1, 0.02f);
+        for (int j = 0; j < GAIT_JOINT_COUNT; ++j) a[j] = follower.position(j);
+    });
+
+    JointFilterBank filters;
+    bench("Mixer output path (both)", input, ticks, [&](float* a) {
+        filters.process(a);
+        follower.step(*reinterpret_cast<float(*)[GAIT_JOINT_COUNT]>(a), (1u << GAIT_JOINT_COUNT) - 1, 0.02f);
+        for (int j = 0; j < GAIT_JOINT_COUNT; ++j) a[j] = follower.position(j);
+    });
+
+    const int status = HostCheck::finish();
+    return g_sink == 12345.0f ? EXIT_FAILURE : status; // Never true; stops the sink being optimized out
+}
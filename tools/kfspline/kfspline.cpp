@@ -0,0 +1,198 @@
+// kfspline - host check and microbenchmark of KeyframeEngine. Splines built
+// from every built-in keyframe action and from random sequences with uneven
+// frame times must pass through their frames, and position and velocity must
+// be continuous across every frame of the loop and into and out of the entry
+// and exit segments. The per-tick spline evaluation is timed against the
+// cosine easing it replaced.
+//
+// Build on the host from this directory:
+//   g++ -std=c++20 -O2 -I../../main -I../../main/motion_manager -o kfspline kfspline.cpp
+//       ../../main/motion_manager/DefaultActions.cpp
+// (one command line)
+//
+// Usage:
+//   kfspline [ticks]   (default 5000000); exits 1 if a check fails
+
+#include "motion_manager/DefaultActions.hpp"
+#include "motion_manager/KeyframeEngine.hpp"
+#include "../HostCheck.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+constexpr float POSITION_TOLERANCE = 1e-3f; // deg
+constexpr float VELOCITY_TOLERANCE = 1e-3f; // deg/ms, or relative above 1 deg/ms
+
+using HostCheck::check;
+
+// Velocity of joint i at normalized time u of a segment lasting duration_ms, in deg/ms
+float velocity(const SplineSegment& seg, int i, float u, float duration_ms) {
+    return ((3.0f * seg.a[i] * u + 2.0f * seg.b[i]) * u + seg.c[i]) / duration_ms;
+}
+
+// Largest position and velocity jumps found, over every joint and frame.
+// Velocity jumps are relative above 1 deg/ms, as 1 ms transitions are fast.
+struct Continuity {
+    float position = 0.0f;
+    float velocity = 0.0f;
+    int sequences = 0;
+
+    void position_gap(float a, float b) { position = std::max(position, std::fabs(a - b)); }
+    void velocity_gap(float a, float b) {
+        const float scale = std::max({1.0f, std::fabs(a), std::fabs(b)});
+        velocity = std::max(velocity, std::fabs(a - b) / scale);
+    }
+};
+
+void check_sequence(const KeyframeActionData& data, Continuity& gaps) {
+    KeyframeSpline spline;
+    KeyframeEngine::build_spline(data, spline);
+    const int n = spline.frame_count;
+    if (n == 0) return;
+    ++gaps.sequences;
+
+    const SplineSegment& entry = spline.segments[SPLINE_SEGMENT_ENTRY];
+    const SplineSegment& exit = spline.segments[SPLINE_SEGMENT_EXIT];
+    const SplineSegment& entry_exit = spline.segments[SPLINE_SEGMENT_ENTRY_EXIT];
+    const int last = n - 1;
+    const int before_last = (n + last - 1) % n;
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        const float home = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
+        for (int j = 0; j < n; ++j) {
+            // Segment j ends on frame j, where segment j+1 starts with the same velocity
+            const int next = (j + 1) % n;
+            const float duration = KeyframeEngine::detail::transition_ms(data, j);
+            const float next_duration = KeyframeEngine::detail::transition_ms(data, next);
+            const SplineSegment& seg = spline.segments[j];
+            const SplineSegment& next_seg = spline.segments[next];
+            gaps.position_gap(KeyframeEngine::evaluate(seg, i, 1.0f), data.frames[j].positions[i]);
+            gaps.position_gap(KeyframeEngine::evaluate(next_seg, i, 0.0f), data.frames[j].positions[i]);
+            gaps.velocity_gap(velocity(seg, i, 1.0f, duration), velocity(next_seg, i, 0.0f, next_duration));
+        }
+
+        // The entry segment leaves home at rest and joins the loop at frame 0
+        const float first_duration = KeyframeEngine::detail::transition_ms(data, 0);
+        const int second = n > 1 ? 1 : 0;
+        const float second_duration = KeyframeEngine::detail::transition_ms(data, second);
+        gaps.position_gap(KeyframeEngine::evaluate(entry, i, 0.0f), home);
+        gaps.position_gap(KeyframeEngine::evaluate(entry, i, 1.0f), data.frames[0].positions[i]);
+        gaps.velocity_gap(velocity(entry, i, 0.0f, first_duration), 0.0f);
+        gaps.velocity_gap(velocity(entry, i, 1.0f, first_duration),
+                          velocity(spline.segments[second], i, 0.0f, second_duration));
+
+        // The exit segment joins from the loop and comes to rest on the last frame
+        const float last_duration = KeyframeEngine::detail::transition_ms(data, last);
+        const float before_duration = KeyframeEngine::detail::transition_ms(data, before_last);
+        gaps.position_gap(KeyframeEngine::evaluate(exit, i, 0.0f), data.frames[before_last].positions[i]);
+        gaps.position_gap(KeyframeEngine::evaluate(exit, i, 1.0f), data.frames[last].positions[i]);
+        gaps.velocity_gap(velocity(spline.segments[before_last], i, 1.0f, before_duration),
+                          velocity(exit, i, 0.0f, last_duration));
+        gaps.velocity_gap(velocity(exit, i, 1.0f, last_duration), 0.0f);
+
+        // A single pass of a one-frame sequence is at rest at both ends
+        gaps.position_gap(KeyframeEngine::evaluate(entry_exit, i, 0.0f), home);
+        gaps.position_gap(KeyframeEngine::evaluate(entry_exit, i, 1.0f), data.frames[0].positions[i]);
+        gaps.velocity_gap(velocity(entry_exit, i, 0.0f, first_duration), 0.0f);
+        gaps.velocity_gap(velocity(entry_exit, i, 1.0f, first_duration), 0.0f);
+    }
+}
+
+KeyframeActionData random_sequence(std::mt19937& rng, int frames) {
+    std::uniform_real_distribution<float> position(20.0f, 160.0f);
+    std::uniform_int_distribution<int> transition(0, 400); // 0 exercises the 1 ms floor
+    KeyframeActionData data = {};
+    data.frame_count = static_cast<uint8_t>(frames);
+    data.interpolation = KeyframeInterpolation::CATMULL_ROM;
+    for (int j = 0; j < frames; ++j) {
+        data.frames[j].transition_time_ms = static_cast<uint16_t>(transition(rng));
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) data.frames[j].positions[i] = position(rng);
+    }
+    return data;
+}
+
+void check_continuity() {
+    Continuity builtin;
+    for (const RegisteredAction& action : DefaultActions::actions()) {
+        if (action.type == ActionType::KEYFRAME_SEQUENCE) check_sequence(action.data.keyframe, builtin);
+    }
+    printf("%d built-in sequences, largest jump %.2e deg, %.2e deg/ms\n", builtin.sequences, builtin.position,
+           builtin.velocity);
+    check(builtin.sequences > 0 && builtin.position < POSITION_TOLERANCE,
+          "built-in splines pass through their frames with continuous position");
+    check(builtin.velocity < VELOCITY_TOLERANCE, "built-in splines have continuous velocity at every frame");
+
+    std::mt19937 rng(2024);
+    Continuity random;
+    for (int frames = 1; frames <= MAX_KEYFRAMES_PER_ACTION; ++frames) {
+        for (int n = 0; n < 8; ++n) check_sequence(random_sequence(rng, frames), random);
+    }
+    printf("%d random sequences, largest jump %.2e deg, %.2e deg/ms\n", random.sequences, random.position,
+           random.velocity);
+    check(random.position < POSITION_TOLERANCE, "random splines pass through their frames with continuous position");
+    check(random.velocity < VELOCITY_TOLERANCE, "random splines have continuous velocity at every frame");
+
+    // The start pose offset fades out without moving either end or its velocity
+    const float h = 1e-3f;
+    const float w0 = KeyframeEngine::entry_offset_weight(0.0f);
+    const float w1 = KeyframeEngine::entry_offset_weight(1.0f);
+    const float slope0 = (KeyframeEngine::entry_offset_weight(h) - w0) / h;
+    const float slope1 = (w1 - KeyframeEngine::entry_offset_weight(1.0f - h)) / h;
+    check(w0 == 1.0f && w1 == 0.0f && std::fabs(slope0) < 1e-2f && std::fabs(slope1) < 1e-2f,
+          "the entry offset weight goes from 1 to 0 with zero slope at both ends");
+}
+
+float g_sink; // Keeps the results alive
+
+template <typename Evaluate>
+void bench(const char* name, long ticks, Evaluate evaluate) {
+    float angles[GAIT_JOINT_COUNT];
+    float sum = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (long n = 0; n < ticks; ++n) {
+        evaluate(static_cast<int>(n % 19), static_cast<float>(n & 255) / 256.0f, angles);
+        sum += angles[n % GAIT_JOINT_COUNT];
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    g_sink += sum;
+    printf("%-28s %6.2f ns/tick\n", name, std::chrono::duration<double, std::nano>(elapsed).count() / ticks);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long ticks = argc > 1 ? std::atol(argv[1]) : 5000000;
+    if (ticks <= 0) {
+        fprintf(stderr, "usage: kfspline [ticks]\n");
+        return 2;
+    }
+
+    check_continuity();
+
+    std::mt19937 rng(7);
+    const KeyframeActionData data = random_sequence(rng, MAX_KEYFRAMES_PER_ACTION);
+    KeyframeSpline spline;
+    KeyframeEngine::build_spline(data, spline);
+    printf("14 joints per tick:\n");
+    // The easing the mixer did for every keyframe action before splines
+    bench("cosine easing (old)", ticks, [&data](int frame, float alpha, float (&angles)[GAIT_JOINT_COUNT]) {
+        const float eased = 0.5f * (1.0f - cosf(alpha * 3.14159265f));
+        const Keyframe& from = data.frames[frame];
+        const Keyframe& to = data.frames[frame + 1];
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            angles[i] = from.positions[i] + (to.positions[i] - from.positions[i]) * eased;
+        }
+    });
+    bench("Catmull-Rom segment", ticks, [&spline](int frame, float u, float (&angles)[GAIT_JOINT_COUNT]) {
+        const SplineSegment& segment = spline.segments[frame];
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) angles[i] = KeyframeEngine::evaluate(segment, i, u);
+    });
+
+    const int status = HostCheck::finish();
+    return g_sink == 12345.0f ? EXIT_FAILURE : status; // Never true; stops the sink being optimized out
+}
@@ -0,0 +1,269 @@
+// layermix - host check and microbenchmark of LayerMixer. Override and
+// additive layers must blend by weight on their own joints only, fades must
+// ramp the layer weight in and out, and a crossfade between two override
+// layers must start on one pose and end on the other without a jump. The
+// blended tick is timed against the first-wins loop it replaced, with the
+// same GaitEngine evaluation in both.
+//
+// Build on the host from this directory:
+//   g++ -std=c++20 -O2 -I../../main -I../../main/motion_manager -o layermix layermix.cpp
+//       ../../main/motion_manager/DefaultActions.cpp
+// (one command line)
+//
+// Usage:
+//   layermix [ticks]   (default 2000000); exits 1 if a check fails
+
+#include "motion_manager/DefaultActions.hpp"
+#include "motion_manager/GaitEngine.hpp"
+#include "motion_manager/LayerMixer.hpp"
+#include "../HostCheck.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr float TOLERANCE = 1e-4f; // deg, or weight
+
+using HostCheck::check;
+
+bool near(float a, float b) {
+    return std::fabs(a - b) < TOLERANCE;
+}
+
+// Home plus a per-joint offset
+void pose(float (&angles)[GAIT_JOINT_COUNT], float offset) {
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) angles[i] = LayerMixer::HOME_POSE[i] + offset;
+}
+
+void check_blend() {
+    float body[GAIT_JOINT_COUNT];
+    float head[GAIT_JOINT_COUNT];
+    pose(body, 20.0f);
+    pose(head, -10.0f);
+    const uint32_t head_mask = 1u << static_cast<int>(ServoChannel::HEAD_PAN) |
+                               1u << static_cast<int>(ServoChannel::HEAD_TILT);
+
+    LayerMixer::Buffer mix;
+    LayerMixer::begin(mix);
+    bool ok = mix.touched == 0;
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) ok &= mix.angle[i] == LayerMixer::HOME_POSE[i];
+    check(ok, "an empty mix is the home pose with no joint touched");
+
+    LayerMixer::blend(mix, body, ALL_JOINTS_MASK, LayerBlend::OVERRIDE, 1.0f);
+    ok = mix.touched == ALL_JOINTS_MASK;
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) ok &= near(mix.angle[i], body[i]);
+    check(ok, "a full-weight override replaces the pose");
+
+    LayerMixer::blend(mix, head, head_mask, LayerBlend::ADDITIVE, 1.0f);
+    ok = mix.touched == ALL_JOINTS_MASK;
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        ok &= near(mix.angle[i], (head_mask >> i) & 1u ? body[i] - 10.0f : body[i]);
+    }
+    check(ok, "an additive head layer adds its offset on top of the body, on its joints only");
+
+    LayerMixer::begin(mix);
+    LayerMixer::blend(mix, body, head_mask, LayerBlend::OVERRIDE, 0.5f);
+    ok = mix.touched == head_mask;
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        ok &= near(mix.angle[i], LayerMixer::HOME_POSE[i] + ((head_mask >> i) & 1u ? 10.0f : 0.0f));
+    }
+    check(ok, "a half-weight override moves its joints halfway and marks only them");
+
+    LayerMixer::begin(mix);
+    LayerMixer::blend(mix, body, ALL_JOINTS_MASK, LayerBlend::OVERRIDE, 0.0f);
+    LayerMixer::blend(mix, body, 0, LayerBlend::OVERRIDE, 1.0f);
+    check(mix.touched == 0 && mix.angle[0] == LayerMixer::HOME_POSE[0], "zero weight or an empty mask does nothing");
+
+    LayerMixer::blend(mix, body, ALL_JOINTS_MASK, LayerBlend::ADDITIVE, 3.0f);
+    check(near(mix.angle[0], body[0]), "weights above 1 are clamped");
+}
+
+ActionInstance layer_instance(const ActionLayer& layer, int64_t start_us) {
+    ActionInstance instance = {};
+    instance.layer = layer;
+    instance.start_time_us = start_us;
+    return instance;
+}
+
+void check_fades() {
+    const ActionLayer layer = {ALL_JOINTS_MASK, 0, LayerBlend::OVERRIDE, 0.8f, 150, 200};
+    ActionInstance instance = layer_instance(layer, 1000000);
+    const auto weight = [&instance](int64_t now_us) { return LayerMixer::instance_weight(instance, now_us); };
+    check(near(weight(1000000), 0.0f) && near(weight(1075000), 0.4f) && near(weight(1150000), 0.8f) &&
+              near(weight(5000000), 0.8f),
+          "the weight ramps from 0 to the layer weight over fade_in_ms");
+    check(near(weight(900000), 0.0f), "the weight is 0 before the start");
+
+    instance.fading_out = true;
+    instance.fade_out_start_us = 5000000;
+    check(near(weight(5000000), 0.8f) && near(weight(5100000), 0.4f) && near(weight(5200000), 0.0f) &&
+              near(weight(6000000), 0.0f),
+          "the weight ramps from the layer weight to 0 over fade_out_ms");
+
+    // Finished during its fade-in: the two ramps multiply
+    instance.fade_out_start_us = 1075000;
+    check(near(weight(1075000), 0.4f) && near(weight(1125000), (125.0f / 150.0f) * 0.75f * 0.8f),
+          "a fade-out during the fade-in scales the ramp in progress");
+
+    ActionInstance instant = layer_instance({ALL_JOINTS_MASK, 0, LayerBlend::OVERRIDE, 1.0f, 0, 0}, 0);
+    check(near(LayerMixer::instance_weight(instant, 0), 1.0f), "a layer without fade-in starts at full weight");
+    instant.fading_out = true;
+    instant.fade_out_start_us = 0;
+    check(near(LayerMixer::instance_weight(instant, 0), 0.0f), "a layer without fade-out drops out at once");
+}
+
+// An old walk fading out under a new one fading in, as when a walk is restarted
+void check_crossfade() {
+    const ActionLayer walk = {ALL_JOINTS_MASK, 0, LayerBlend::OVERRIDE, 1.0f, 150, 150};
+    ActionInstance old_walk = layer_instance(walk, 0);
+    old_walk.fading_out = true;
+    old_walk.fade_out_start_us = 1000000;
+    const ActionInstance new_walk = layer_instance(walk, 1000000);
+
+    float from[GAIT_JOINT_COUNT];
+    float to[GAIT_JOINT_COUNT];
+    pose(from, 25.0f);
+    pose(to, -15.0f);
+
+    float largest_step = 0.0f;
+    float previous = NAN;
+    float start = NAN;
+    float end = NAN;
+    bool monotonic = true;
+    for (int64_t now_us = 1000000; now_us <= 1150000; now_us += 1000) {
+        LayerMixer::Buffer mix;
+        LayerMixer::begin(mix);
+        LayerMixer::blend(mix, from, ALL_JOINTS_MASK, LayerBlend::OVERRIDE,
+                          LayerMixer::instance_weight(old_walk, now_us));
+        LayerMixer::blend(mix, to, ALL_JOINTS_MASK, LayerBlend::OVERRIDE,
+                          LayerMixer::instance_weight(new_walk, now_us));
+        const float angle = mix.angle[0];
+        if (std::isnan(start)) start = angle;
+        if (!std::isnan(previous)) {
+            largest_step = std::max(largest_step, std::fabs(angle - previous));
+            monotonic &= angle <= previous + TOLERANCE;
+        }
+        previous = end = angle;
+    }
+    printf("crossfade over 150 ms: largest step %.3f deg per ms\n", largest_step);
+    check(near(start, from[0]) && near(end, to[0]), "a crossfade starts on the old pose and ends on the new one");
+    check(monotonic && largest_step < 1.0f, "a crossfade moves steadily, without a jump");
+}
+
+// --- Benchmark: 4 gait layers at 50 Hz ---
+
+struct GaitLayer {
+    const GaitActionData* gait;
+    GaitOscillator osc;
+    ActionInstance instance;
+};
+
+constexpr uint32_t TICK_US = 20000;
+
+// Absolute angles of one gait layer at now_us, as the mixer evaluates it
+uint32_t evaluate(GaitLayer& layer, int64_t now_us, float (&angles)[GAIT_JOINT_COUNT]) {
+    float wave[GAIT_JOINT_COUNT];
+    const uint32_t produced = GaitEngine::advance(layer.osc, *layer.gait, now_us, TICK_US, wave);
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        angles[i] = LayerMixer::HOME_POSE[i] + layer.gait->harmonic_terms[0].offset[i] + wave[i];
+    }
+    return produced;
+}
+
+void clamp(const float (&in)[GAIT_JOINT_COUNT], float (&out)[GAIT_JOINT_COUNT]) {
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        const auto& limit = ServoCalibration::limits[i];
+        out[i] = std::max(limit.min, std::min(limit.max, in[i]));
+    }
+}
+
+// The loop the mixer ran before layers: the first action to set a joint owns it
+void first_wins_tick(std::vector<GaitLayer>& layers, int64_t now_us, float (&final_angles)[GAIT_JOINT_COUNT]) {
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) final_angles[i] = -1.0f;
+    for (GaitLayer& layer : layers) {
+        float angles[GAIT_JOINT_COUNT];
+        const uint32_t produced = evaluate(layer, now_us, angles);
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            if (final_angles[i] >= 0.0f || !(produced & (1u << i))) continue;
+            const auto& limit = ServoCalibration::limits[i];
+            final_angles[i] = std::max(limit.min, std::min(limit.max, angles[i]));
+        }
+    }
+}
+
+// The mixer's layered tick: sort by priority, blend with fades, clamp once
+void blended_tick(std::vector<GaitLayer>& layers, int64_t now_us, float (&final_angles)[GAIT_JOINT_COUNT]) {
+    GaitLayer* order[MAX_ACTIVE_ACTIONS];
+    size_t count = 0;
+    for (GaitLayer& layer : layers) {
+        size_t pos = count++;
+        while (pos > 0 && order[pos - 1]->instance.layer.priority > layer.instance.layer.priority) {
+            order[pos] = order[pos - 1];
+            --pos;
+        }
+        order[pos] = &layer;
+    }
+    LayerMixer::Buffer mix;
+    LayerMixer::begin(mix);
+    for (size_t n = 0; n < count; ++n) {
+        float angles[GAIT_JOINT_COUNT];
+        const uint32_t produced = evaluate(*order[n], now_us, angles);
+        const ActionInstance& instance = order[n]->instance;
+        LayerMixer::blend(mix, angles, produced & instance.layer.joint_mask, instance.layer.blend,
+                          LayerMixer::instance_weight(instance, now_us));
+    }
+    clamp(mix.angle, final_angles);
+}
+
+float g_sink; // Keeps the results alive
+
+template <typename Tick>
+void bench(const char* name, long ticks, Tick tick) {
+    std::vector<GaitLayer> layers;
+    for (const RegisteredAction& action : DefaultActions::actions()) {
+        if (action.type != ActionType::GAIT_PERIODIC || layers.size() == 4) continue;
+        GaitLayer layer = {&action.data.gait, {}, layer_instance({ALL_JOINTS_MASK, 0, LayerBlend::OVERRIDE, 1.0f,
+                                                                  150, 150}, 0)};
+        GaitEngine::start_oscillator(layer.osc, action.data.gait, 0);
+        layers.push_back(layer);
+    }
+    layers[1].instance.layer.priority = -1;
+    layers[3].instance.layer.blend = LayerBlend::ADDITIVE;
+
+    float final_angles[GAIT_JOINT_COUNT];
+    float sum = 0.0f;
+    auto start = std::chrono::steady_clock::now();
+    for (long n = 1; n <= ticks; ++n) {
+        tick(layers, n * static_cast<int64_t>(TICK_US), final_angles);
+        sum += final_angles[n % GAIT_JOINT_COUNT];
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    g_sink += sum;
+    printf("%-28s %6.1f ns/tick\n", name, std::chrono::duration<double, std::nano>(elapsed).count() / ticks);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long ticks = argc > 1 ? std::atol(argv[1]) : 2000000;
+    if (ticks <= 0) {
+        fprintf(stderr, "usage: layermix [ticks]\n");
+        return 2;
+    }
+
+    check_blend();
+    check_fades();
+    check_crossfade();
+
+    printf("4 gait layers, 14 joints:\n");
+    bench("first-wins loop (old)", ticks, first_wins_tick);
+    bench("blended layers", ticks, blended_tick);
+
+    const int status = HostCheck::finish();
+    return g_sink == 12345.0f ? EXIT_FAILURE : status; // Never true; stops the sink being optimized out
+}
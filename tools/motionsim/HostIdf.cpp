@@ -0,0 +1,204 @@
+// Host implementations of the ESP-IDF services the motion stack uses, for
+// tools/motionsim: logging, an in-memory NVS and file-backed partitions.
+
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// --- Logging ---
+
+esp_log_level_t host_log_level = ESP_LOG_WARN;
+
+void host_log(esp_log_level_t level, const char* tag, const char* format, ...) {
+    if (level > host_log_level) return;
+    static const char LETTERS[] = "NEWIDV";
+    fprintf(stderr, "%c (%s) ", LETTERS[level], tag);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+const char* esp_err_to_name(esp_err_t code) {
+    switch (code) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_SIZE: return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND: return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NVS_NOT_FOUND: return "ESP_ERR_NVS_NOT_FOUND";
+        default: return "ESP_ERR";
+    }
+}
+
+// --- NVS ---
+
+namespace {
+
+typedef std::map<std::string, std::vector<uint8_t>> Namespace;
+std::map<std::string, Namespace> s_nvs;
+std::vector<std::string> s_handles; // Namespace name by handle
+
+Namespace* handle_namespace(nvs_handle_t handle) {
+    return handle < s_handles.size() ? &s_nvs[s_handles[handle]] : nullptr;
+}
+
+} // namespace
+
+struct nvs_opaque_iterator_t {
+    std::string namespace_name;
+    std::vector<std::string> keys;
+    size_t index;
+};
+
+esp_err_t nvs_flash_init(void) { return ESP_OK; }
+
+esp_err_t nvs_flash_erase(void) {
+    s_nvs.clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char* name, nvs_open_mode_t open_mode, nvs_handle_t* out_handle) {
+    if (open_mode == NVS_READONLY && s_nvs.find(name) == s_nvs.end()) return ESP_ERR_NVS_NOT_FOUND;
+    s_nvs[name];
+    s_handles.push_back(name);
+    *out_handle = static_cast<nvs_handle_t>(s_handles.size() - 1);
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t) {}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char* key, const void* value, size_t length) {
+    Namespace* ns = handle_namespace(handle);
+    if (ns == nullptr || strlen(key) >= NVS_KEY_NAME_MAX_SIZE) return ESP_ERR_INVALID_ARG;
+    const uint8_t* bytes = static_cast<const uint8_t*>(value);
+    (*ns)[key].assign(bytes, bytes + length);
+    return ESP_OK;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char* key, void* out_value, size_t* length) {
+    Namespace* ns = handle_namespace(handle);
+    if (ns == nullptr) return ESP_ERR_INVALID_ARG;
+    auto it = ns->find(key);
+    if (it == ns->end()) return ESP_ERR_NVS_NOT_FOUND;
+    if (out_value != nullptr) {
+        if (*length < it->second.size()) return ESP_ERR_INVALID_SIZE;
+        memcpy(out_value, it->second.data(), it->second.size());
+    }
+    *length = it->second.size();
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char* key) {
+    Namespace* ns = handle_namespace(handle);
+    if (ns == nullptr) return ESP_ERR_INVALID_ARG;
+    return ns->erase(key) ? ESP_OK : ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle) {
+    Namespace* ns = handle_namespace(handle);
+    if (ns == nullptr) return ESP_ERR_INVALID_ARG;
+    ns->clear();
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t) { return ESP_OK; }
+
+esp_err_t nvs_entry_find(const char*, const char* namespace_name, nvs_type_t, nvs_iterator_t* output_iterator) {
+    *output_iterator = nullptr;
+    auto ns = s_nvs.find(namespace_name);
+    if (ns == s_nvs.end() || ns->second.empty()) return ESP_ERR_NVS_NOT_FOUND;
+    auto* it = new nvs_opaque_iterator_t{namespace_name, {}, 0};
+    for (const auto& entry : ns->second) it->keys.push_back(entry.first);
+    *output_iterator = it;
+    return ESP_OK;
+}
+
+esp_err_t nvs_entry_next(nvs_iterator_t* iterator) {
+    if (++(*iterator)->index < (*iterator)->keys.size()) return ESP_OK;
+    delete *iterator;
+    *iterator = nullptr;
+    return ESP_ERR_NVS_NOT_FOUND;
+}
+
+esp_err_t nvs_entry_info(nvs_iterator_t iterator, nvs_entry_info_t* out_info) {
+    memset(out_info, 0, sizeof(*out_info));
+    snprintf(out_info->namespace_name, sizeof(out_info->namespace_name), "%s", iterator->namespace_name.c_str());
+    snprintf(out_info->key, sizeof(out_info->key), "%s", iterator->keys[iterator->index].c_str());
+    out_info->type = NVS_TYPE_BLOB;
+    return ESP_OK;
+}
+
+void nvs_release_iterator(nvs_iterator_t iterator) { delete iterator; }
+
+// --- Partitions ---
+
+namespace {
+
+struct HostPartition {
+    esp_partition_t info;
+    std::vector<uint8_t> data;
+};
+std::map<std::string, std::unique_ptr<HostPartition>> s_partitions;
+
+const HostPartition* host_partition(const esp_partition_t* partition) {
+    for (const auto& entry : s_partitions) {
+        if (&entry.second->info == partition) return entry.second.get();
+    }
+    return nullptr;
+}
+
+} // namespace
+
+bool host_partition_attach(const char* label, const char* path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    auto partition = std::make_unique<HostPartition>();
+    partition->data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    partition->info.type = ESP_PARTITION_TYPE_DATA;
+    partition->info.subtype = ESP_PARTITION_SUBTYPE_ANY;
+    partition->info.address = 0;
+    partition->info.size = static_cast<uint32_t>(partition->data.size());
+    snprintf(partition->info.label, sizeof(partition->info.label), "%s", label);
+    s_partitions[label] = std::move(partition);
+    return true;
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t, esp_partition_subtype_t, const char* label) {
+    auto it = s_partitions.find(label ? label : "");
+    return it == s_partitions.end() ? nullptr : &it->second->info;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size) {
+    const HostPartition* host = host_partition(partition);
+    if (host == nullptr) return ESP_ERR_INVALID_ARG;
+    if (offset > host->data.size() || size > host->data.size() - offset) return ESP_ERR_INVALID_SIZE;
+    memcpy(dst, host->data.data() + offset, size);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t* partition, size_t offset, size_t size, esp_partition_mmap_memory_t,
+                             const void** out_ptr, esp_partition_mmap_handle_t* out_handle) {
+    const HostPartition* host = host_partition(partition);
+    if (host == nullptr) return ESP_ERR_INVALID_ARG;
+    if (offset > host->data.size() || size > host->data.size() - offset) return ESP_ERR_INVALID_SIZE;
+    *out_ptr = host->data.data() + offset;
+    *out_handle = 1;
+    return ESP_OK;
+}
+
+void esp_partition_munmap(esp_partition_mmap_handle_t) {}
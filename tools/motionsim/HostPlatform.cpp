@@ -0,0 +1,35 @@
+#include "HostPlatform.hpp"
+#include "motion_manager/MotionPlatform.hpp"
+
+static int64_t s_now_us = 0;
+
+namespace HostPlatform {
+
+void set_now_us(int64_t now_us) {
+    s_now_us = now_us;
+}
+
+} // namespace HostPlatform
+
+namespace MotionPlatform {
+
+int64_t now_us() {
+    return s_now_us;
+}
+
+void delay_ms(uint32_t) {}
+
+uint32_t tick_count() {
+    return static_cast<uint32_t>(s_now_us / 1000);
+}
+
+bool delay_until(uint32_t& last_wake, uint32_t period_ms) {
+    last_wake += period_ms;
+    return true;
+}
+
+TaskHandle start_task(TaskFunction, const char*, uint32_t, void*, uint32_t, int) {
+    return nullptr;
+}
+
+} // namespace MotionPlatform
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+// Host side of MotionPlatform for tools/motionsim. Time is virtual: it moves
+// only when the simulator sets it, so a run is the same on every machine and
+// at any speed. No tasks are started; the simulator calls the controller's
+// step functions itself, and the blocking calls they make return at once.
+namespace HostPlatform {
+
+void set_now_us(int64_t now_us);
+
+} // namespace HostPlatform
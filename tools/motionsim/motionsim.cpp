@@ -0,0 +1,550 @@
+// motionsim - runs MotionController and ActionManager on the host against a
+// virtual clock and a recording servo, driven by a script of UART-style
+// commands. A run is deterministic, so its joint trajectory can be kept as a
+// golden file and compared after every mixer change; minutes of motion take
+// milliseconds, which also makes it a convenient target for perf.
+//
+// Build on the host from this directory:
+//   g++ -std=gnu++2b -O2 -g -Iidf -I../../main -I../../main/motion_manager -I../../main/driver -o motionsim
+//       motionsim.cpp HostPlatform.cpp HostIdf.cpp $(ls ../../main/motion_manager/*.cpp | grep -v MotionPlatform)
+// (one command line; MotionPlatform.cpp is the firmware's, HostPlatform.cpp replaces it)
+//
+// Usage:
+//   motionsim [options] <script>
+//     --csv <file>       write the joint trajectory, one row per mixer tick
+//     --golden <file>    compare the trajectory with one written by --csv; exit 1 on a mismatch
+//     --tolerance <deg>  allowed difference per joint for --golden (default 0.01)
+//     --trace <file>     write a motion trace of the run, for tools/mtrace
+//     --pack <file>      serve a motion pack as the 'motions' partition
+//     --repeat <n>       run the script n times, for profiling; outputs are from the last run
+//     -v                 log at INFO level
+//
+// Script: one command per line, '#' starts a comment.
+//   <time_ms> <name>               a motion command by name: forward, stop, wave_hand, ... (see COMMANDS)
+//   <time_ms> cmd <code>           a motion command by code, e.g. cmd 0x1C
+//   <time_ms> play <action|group>  MOTION_PLAY_MOTION
+//   <time_ms> face <x> <y> <w> <h> a detected face, reported by the vision module over UART
+//   <time_ms> noface               no face in view, likewise
+//   <time_ms> target <pan> <tilt> <amplitude> <period_ms> [<size>]
+//                                  a synthetic face for closed-loop tracking: its bearing
+//                                  from the body in degrees, swinging in pan by amplitude,
+//                                  and its width and height in pixels (default 240)
+//   <time_ms> target off           the synthetic face leaves
+//   <time_ms> wake                 the wake word, for the DecisionMaker
+//   <time_ms> sound <bearing>      a sound from bearing degrees, positive to the left
+//   <time_ms> rate <50|100|200>    mixer rate in Hz
+//   <time_ms> end                  end of the run (default: one second after the last command)
+// A command takes effect on the first mixer tick at or after its time. A face
+// report is stamped with its time, as UartHandler stamps the receipt, and
+// reaches the controller UART_RX_TIMEOUT_US later. The
+// DecisionMaker runs too: it sees the face reports, wake words, sounds and
+// finished actions, and the commands it queues are counted at the end.
+
+#include "HostPlatform.hpp"
+#include "driver/MockServo.hpp"
+#include "esp_log.h"
+#include "esp_partition.h"
+#include "motion_manager/ActionManager.hpp"
+#include "motion_manager/MotionController.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+const char* const JOINT_NAMES[] = {
+    "left_ear_lift", "left_ear_swing", "right_ear_lift", "right_ear_swing", "head_tilt", "head_pan",
+    "right_arm_swing", "left_arm_lift", "left_arm_swing", "right_arm_lift", "left_leg_rotate",
+    "left_ankle_lift", "right_leg_rotate", "right_ankle_lift"};
+static_assert(sizeof(JOINT_NAMES) / sizeof(JOINT_NAMES[0]) == GAIT_JOINT_COUNT, "Joint names out of date");
+
+struct CommandName {
+    const char* name;
+    uint8_t code;
+};
+
+const CommandName COMMANDS[] = {
+    {"stop", MOTION_STOP},
+    {"forward", MOTION_FORWARD},
+    {"backward", MOTION_BACKWARD},
+    {"left", MOTION_LEFT},
+    {"right", MOTION_RIGHT},
+    {"wave_hand", MOTION_WAVE_HAND},
+    {"move_ear", MOTION_MOVE_EAR},
+    {"nod_head", MOTION_NOD_HEAD},
+    {"shake_head", MOTION_SHAKE_HEAD},
+    {"walk_backward_kf", MOTION_WALK_BACKWARD_KF},
+    {"wave_hello", MOTION_WAVE_HELLO},
+    {"face_trace", MOTION_FACE_TRACE},
+    {"face_end", MOTION_FACE_END},
+    {"happy", MOTION_HAPPY},
+    {"lookaround", MOTION_LOOKAROUND},
+    {"dance", MOTION_DANCE},
+    {"funny", MOTION_FUNNY},
+    {"very_happy", MOTION_VERY_HAPPY},
+    {"angry", MOTION_ANGRY},
+    {"crying", MOTION_CRYING},
+    {"surprised", MOTION_SURPRISED},
+    {"sad", MOTION_SAD},
+    {"tracking_l", MOTION_TRACKING_L},
+    {"tracking_r", MOTION_TRACKING_R},
+    {"walk_forward_kf", MOTION_WALK_FORWARD_KF},
+    {"startle_and_sigh", MOTION_STARTLE_AND_SIGH},
+};
+
+const int64_t DEFAULT_TAIL_US = 1000000;       // Run time after the last command without an 'end'
+
+// The simulated camera that sees a synthetic target: a 640x480 frame from the
+// head, reported over UART CAMERA_LATENCY_US after capture.
+const int64_t CAMERA_PERIOD_US = 50000;
+const int64_t CAMERA_LATENCY_US = 60000;
+// UartHandler hears of a report once the line has been idle for three
+// characters at 115200 baud.
+const int64_t UART_RX_TIMEOUT_US = 260;
+const float CAMERA_DEG_PER_PIXEL = 0.1f;
+const int TARGET_FACE_SIZE = 240; // Default: near enough that the DecisionMaker neither approaches nor backs off
+const int64_t TARGET_SETTLE_US = 1000000; // Acquisition time left out of the tracking stats
+
+enum class EventType { COMMAND, FACE, RATE, TARGET, WAKE, SOUND, END };
+
+// Synthetic face for closed-loop tracking runs.
+struct Target {
+    bool active;
+    float pan;       // Bearing from the body, degrees
+    float tilt;
+    float amplitude; // Pan swing, degrees
+    int64_t period_us;
+    int size;        // Face width and height, pixels
+
+    float pan_at(int64_t since_start_us) const {
+        if (period_us <= 0) return pan;
+        return pan + amplitude * static_cast<float>(std::sin(2.0 * M_PI * since_start_us / period_us));
+    }
+};
+
+struct Event {
+    int64_t time_us;
+    EventType type;
+    motion_command_t command;
+    FaceLocation face;
+    MixerRate rate;
+    Target target;
+    int sound_bearing;
+};
+
+struct Options {
+    const char* script = nullptr;
+    const char* csv = nullptr;
+    const char* golden = nullptr;
+    const char* trace = nullptr;
+    const char* pack = nullptr;
+    double tolerance = 0.01;
+    int repeat = 1;
+};
+
+// One row per mixer tick: the time, then the angle sent to every joint (NaN
+// for a joint never driven).
+struct Trajectory {
+    std::vector<double> time_ms;
+    std::vector<float> angles; // GAIT_JOINT_COUNT per row
+};
+
+// Head pan against the synthetic target, one sample per tick once the
+// tracker has had time to acquire it. Runs restart at every 'target' event.
+struct TrackingRun {
+    std::vector<float> target; // Target pan bearing
+    std::vector<float> head;   // Head pan offset sent to the servo
+};
+
+// Head offset from home, as the camera sees it.
+float head_offset(const MockServo& servo, ServoChannel joint) {
+    float angle = servo.angle(static_cast<uint8_t>(joint));
+    return std::isnan(angle) ? 0.0f : angle - ServoCalibration::get_home_pos(joint);
+}
+
+// What the camera reports for the target with the head where it is now.
+FaceLocation capture_face(const Target& target, int64_t since_start_us, const MockServo& servo) {
+    float x = 320.0f - (target.pan_at(since_start_us) - head_offset(servo, ServoChannel::HEAD_PAN)) / CAMERA_DEG_PER_PIXEL;
+    float y = 240.0f + (target.tilt - head_offset(servo, ServoChannel::HEAD_TILT)) / CAMERA_DEG_PER_PIXEL;
+    FaceLocation face = {};
+    if (x < 0.0f || x >= 640.0f || y < 0.0f || y >= 480.0f) return face;
+    const int half = target.size / 2;
+    face.x = static_cast<uint16_t>(std::max(0, static_cast<int>(x) - half));
+    face.y = static_cast<uint16_t>(std::max(0, static_cast<int>(y) - half));
+    face.w = static_cast<uint16_t>(target.size);
+    face.h = static_cast<uint16_t>(target.size);
+    face.detected = true;
+    return face;
+}
+
+// Prints how closely the head followed the target: the error, and the delay
+// that best lines the head up with the target.
+void report_tracking(const std::vector<TrackingRun>& runs, uint32_t period_us) {
+    double sum_sq = 0, worst = 0;
+    size_t samples = 0;
+    for (const TrackingRun& run : runs) {
+        for (size_t i = 0; i < run.head.size(); ++i) {
+            double error = run.head[i] - run.target[i];
+            sum_sq += error * error;
+            worst = std::max(worst, std::fabs(error));
+            ++samples;
+        }
+    }
+    if (samples == 0) return;
+    size_t best_shift = 0;
+    double best = INFINITY;
+    for (size_t shift = 0; shift * period_us <= 500000; ++shift) {
+        double shifted_sq = 0;
+        size_t n = 0;
+        for (const TrackingRun& run : runs) {
+            for (size_t i = shift; i < run.head.size(); ++i) {
+                double error = run.head[i] - run.target[i - shift];
+                shifted_sq += error * error;
+                ++n;
+            }
+        }
+        if (n > 0 && shifted_sq / n < best) {
+            best = shifted_sq / n;
+            best_shift = shift;
+        }
+    }
+    printf("tracking: pan error rms %.2f deg, max %.2f deg; head lags the target by %u ms\n",
+           std::sqrt(sum_sq / samples), worst, static_cast<unsigned>(best_shift * period_us / 1000));
+}
+
+Event parse_line(const std::string& line, int line_number) {
+    std::istringstream in(line);
+    double time_ms;
+    std::string name;
+    auto fail = [&](const std::string& what) {
+        return std::runtime_error("line " + std::to_string(line_number) + ": " + what);
+    };
+    if (!(in >> time_ms >> name) || time_ms < 0) throw fail("expected '<time_ms> <command>'");
+
+    Event event = {};
+    event.time_us = std::llround(time_ms * 1000.0);
+    event.type = EventType::COMMAND;
+    if (name == "end") {
+        event.type = EventType::END;
+    } else if (name == "play") {
+        std::string action;
+        if (!(in >> action)) throw fail("play needs an action or group name");
+        event.command.motion_type = MOTION_PLAY_MOTION;
+        if (!motion_command_set_params(event.command, reinterpret_cast<const uint8_t*>(action.data()), action.size())) {
+            throw fail("action name too long");
+        }
+    } else if (name == "cmd") {
+        std::string code;
+        if (!(in >> code)) throw fail("cmd needs a code");
+        event.command.motion_type = static_cast<uint8_t>(strtoul(code.c_str(), nullptr, 0));
+    } else if (name == "face") {
+        int x, y, w, h;
+        if (!(in >> x >> y >> w >> h)) throw fail("face needs <x> <y> <w> <h>");
+        event.type = EventType::FACE;
+        event.face = FaceLocation{};
+        event.face.x = static_cast<uint16_t>(x);
+        event.face.y = static_cast<uint16_t>(y);
+        event.face.w = static_cast<uint16_t>(w);
+        event.face.h = static_cast<uint16_t>(h);
+        event.face.detected = true;
+    } else if (name == "noface") {
+        event.type = EventType::FACE;
+        event.face = FaceLocation{};
+    } else if (name == "target") {
+        event.type = EventType::TARGET;
+        std::string first;
+        if (!(in >> first)) throw fail("target needs <pan> <tilt> <amplitude> <period_ms> or 'off'");
+        if (first != "off") {
+            double tilt, amplitude, period_ms;
+            if (!(in >> tilt >> amplitude >> period_ms) || period_ms < 0) {
+                throw fail("target needs <pan> <tilt> <amplitude> <period_ms> or 'off'");
+            }
+            int size = TARGET_FACE_SIZE;
+            if (!(in >> size)) size = TARGET_FACE_SIZE;
+            if (size <= 0 || size > 480) throw fail("target size must be 1 to 480 pixels");
+            event.target = {true, std::stof(first), static_cast<float>(tilt), static_cast<float>(amplitude),
+                            std::llround(period_ms * 1000.0), size};
+        }
+    } else if (name == "wake") {
+        event.type = EventType::WAKE;
+    } else if (name == "sound") {
+        if (!(in >> event.sound_bearing)) throw fail("sound needs a bearing in degrees");
+        event.type = EventType::SOUND;
+    } else if (name == "rate") {
+        int hz;
+        if (!(in >> hz) || (hz != 50 && hz != 100 && hz != 200)) throw fail("rate must be 50, 100 or 200");
+        event.type = EventType::RATE;
+        event.rate = static_cast<MixerRate>(hz);
+    } else {
+        bool found = false;
+        for (const CommandName& command : COMMANDS) {
+            if (name == command.name) {
+                event.command.motion_type = command.code;
+                found = true;
+                break;
+            }
+        }
+        if (!found) throw fail("unknown command '" + name + "'");
+    }
+    return event;
+}
+
+std::vector<Event> read_script(const char* path, int64_t& end_us) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error(std::string("cannot open ") + path);
+    std::vector<Event> events;
+    std::string line;
+    int line_number = 0;
+    end_us = -1;
+    int64_t last_us = 0;
+    while (std::getline(in, line)) {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        Event event = parse_line(line, line_number);
+        if (event.time_us < last_us) throw std::runtime_error("line " + std::to_string(line_number) + ": time goes backwards");
+        last_us = event.time_us;
+        if (event.type == EventType::END) {
+            end_us = event.time_us;
+            break;
+        }
+        events.push_back(event);
+    }
+    if (end_us < 0) end_us = last_us + DEFAULT_TAIL_US;
+    return events;
+}
+
+// Runs the script once from a fresh controller at virtual time 0.
+Trajectory simulate(const std::vector<Event>& events, int64_t end_us, const char* trace_path) {
+    MockServo servo;
+    ActionManager action_manager;
+    MotionController controller(servo, action_manager);
+    HostPlatform::set_now_us(0);
+    action_manager.init();
+    controller.init(false);
+    DecisionMaker& decision_maker = *controller.get_decision_maker();
+
+    Trajectory trajectory;
+    size_t next_event = 0;
+    Target target = {};
+    int64_t target_start_us = 0;
+    int64_t next_capture_us = 0;
+    std::vector<std::pair<int64_t, FaceLocation>> in_flight; // Face reports by UART arrival time
+    auto send_face = [&in_flight](int64_t arrival_us, FaceLocation face) {
+        face.timestamp_us = arrival_us;
+        auto later = [](int64_t time_us, const std::pair<int64_t, FaceLocation>& sent) { return time_us < sent.first; };
+        in_flight.emplace(std::upper_bound(in_flight.begin(), in_flight.end(), arrival_us, later), arrival_us, face);
+    };
+    std::vector<TrackingRun> runs;
+    for (int64_t now_us = 0; now_us <= end_us;) {
+        HostPlatform::set_now_us(now_us);
+        for (; next_event < events.size() && events[next_event].time_us <= now_us; ++next_event) {
+            const Event& event = events[next_event];
+            switch (event.type) {
+                case EventType::COMMAND: controller.queue_command(event.command); break;
+                case EventType::FACE: send_face(event.time_us, event.face); break;
+                case EventType::RATE: controller.set_mixer_rate(event.rate); break;
+                case EventType::TARGET:
+                    target = event.target;
+                    target_start_us = now_us;
+                    next_capture_us = now_us;
+                    if (target.active) runs.emplace_back();
+                    break;
+                case EventType::WAKE: decision_maker.post_wake_word(); break;
+                case EventType::SOUND: decision_maker.post_sound(event.sound_bearing); break;
+                case EventType::END: break;
+            }
+        }
+        if (target.active && now_us >= next_capture_us) {
+            send_face(now_us + CAMERA_LATENCY_US, capture_face(target, now_us - target_start_us, servo));
+            next_capture_us += CAMERA_PERIOD_US;
+        }
+        while (!in_flight.empty() && in_flight.front().first + UART_RX_TIMEOUT_US <= now_us) {
+            controller.queue_face_location(in_flight.front().second);
+            in_flight.erase(in_flight.begin());
+        }
+        controller.step(now_us);
+
+        trajectory.time_ms.push_back(now_us / 1000.0);
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            trajectory.angles.push_back(servo.angle(static_cast<uint8_t>(i)));
+        }
+        if (target.active && now_us - target_start_us >= TARGET_SETTLE_US) {
+            runs.back().target.push_back(target.pan_at(now_us - target_start_us));
+            runs.back().head.push_back(head_offset(servo, ServoChannel::HEAD_PAN));
+        }
+        now_us += mixer_period_us(controller.get_mixer_rate());
+    }
+
+    if (!runs.empty()) report_tracking(runs, mixer_period_us(controller.get_mixer_rate()));
+    const MotionCommandStats commands = controller.get_command_stats();
+    if (commands.deferred > 0 || commands.dropped > 0) {
+        printf("commands: %u queued, %u deferred, %u coalesced, %u expired, %u dropped, %u flushed\n",
+               static_cast<unsigned>(commands.queued), static_cast<unsigned>(commands.deferred),
+               static_cast<unsigned>(commands.coalesced), static_cast<unsigned>(commands.expired),
+               static_cast<unsigned>(commands.dropped), static_cast<unsigned>(commands.flushed));
+    }
+    if (decision_maker.commands_issued() > 0) {
+        printf("behavior: %u commands queued by the DecisionMaker\n", static_cast<unsigned>(decision_maker.commands_issued()));
+    }
+    if (trace_path && !controller.save_motion_trace(trace_path)) {
+        throw std::runtime_error(std::string("cannot write ") + trace_path);
+    }
+    return trajectory;
+}
+
+void write_csv(const Trajectory& trajectory, const char* path) {
+    FILE* out = fopen(path, "w");
+    if (out == nullptr) throw std::runtime_error(std::string("cannot write ") + path);
+    fputs("time_ms", out);
+    for (const char* joint : JOINT_NAMES) fprintf(out, ",%s", joint);
+    fputs("\n", out);
+    for (size_t row = 0; row < trajectory.time_ms.size(); ++row) {
+        fprintf(out, "%.3f", trajectory.time_ms[row]);
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            float angle = trajectory.angles[row * GAIT_JOINT_COUNT + i];
+            if (std::isnan(angle)) {
+                fputs(",", out);
+            } else {
+                fprintf(out, ",%.3f", angle);
+            }
+        }
+        fputs("\n", out);
+    }
+    fclose(out);
+}
+
+Trajectory read_csv(const char* path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error(std::string("cannot open ") + path);
+    Trajectory trajectory;
+    std::string line;
+    std::getline(in, line); // Header
+    while (std::getline(in, line)) {
+        std::vector<std::string> fields;
+        std::stringstream row(line);
+        std::string field;
+        while (std::getline(row, field, ',')) fields.push_back(field);
+        if (!line.empty() && line.back() == ',') fields.push_back("");
+        if (fields.size() != GAIT_JOINT_COUNT + 1) {
+            throw std::runtime_error(std::string(path) + ": row " + std::to_string(trajectory.time_ms.size() + 1) +
+                                     " does not have " + std::to_string(GAIT_JOINT_COUNT + 1) + " columns");
+        }
+        trajectory.time_ms.push_back(std::stod(fields[0]));
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            trajectory.angles.push_back(fields[i + 1].empty() ? NAN : std::stof(fields[i + 1]));
+        }
+    }
+    return trajectory;
+}
+
+// Prints the first mismatch; returns true when the trajectories agree.
+bool compare(const Trajectory& actual, const Trajectory& golden, double tolerance) {
+    if (actual.time_ms.size() != golden.time_ms.size()) {
+        printf("golden: %zu ticks, this run %zu\n", golden.time_ms.size(), actual.time_ms.size());
+        return false;
+    }
+    double worst = 0;
+    for (size_t row = 0; row < actual.time_ms.size(); ++row) {
+        if (std::fabs(actual.time_ms[row] - golden.time_ms[row]) > 0.0005) {
+            printf("golden: tick %zu is at %.3f ms, this run %.3f ms\n", row, golden.time_ms[row], actual.time_ms[row]);
+            return false;
+        }
+        for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+            float a = actual.angles[row * GAIT_JOINT_COUNT + i];
+            float g = golden.angles[row * GAIT_JOINT_COUNT + i];
+            if (std::isnan(a) != std::isnan(g) || (!std::isnan(a) && std::fabs(a - g) > tolerance)) {
+                printf("golden: %s differs at %.3f ms: %.3f, this run %.3f\n", JOINT_NAMES[i], actual.time_ms[row], g, a);
+                return false;
+            }
+            if (!std::isnan(a)) worst = std::max(worst, static_cast<double>(std::fabs(a - g)));
+        }
+    }
+    printf("golden: match, largest difference %.4f deg\n", worst);
+    return true;
+}
+
+int run(const Options& options) {
+    int64_t end_us;
+    std::vector<Event> events = read_script(options.script, end_us);
+    if (options.pack && !host_partition_attach("motions", options.pack)) {
+        throw std::runtime_error(std::string("cannot read ") + options.pack);
+    }
+
+    Trajectory trajectory;
+    auto start = std::chrono::steady_clock::now();
+    for (int n = 0; n < options.repeat; ++n) {
+        const bool last = n == options.repeat - 1;
+        trajectory = simulate(events, end_us, last ? options.trace : nullptr);
+    }
+    double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / options.repeat;
+    double sim_s = end_us / 1e6;
+    printf("%s: %.2f s simulated in %zu ticks, %.2f ms wall per run (%.0fx real time)\n", options.script, sim_s,
+           trajectory.time_ms.size(), wall_ms, wall_ms > 0 ? sim_s * 1000.0 / wall_ms : 0.0);
+
+    if (options.csv) write_csv(trajectory, options.csv);
+    if (options.golden) {
+        // Compare what the golden file holds: values as write_csv prints them.
+        char text[32];
+        for (float& angle : trajectory.angles) {
+            snprintf(text, sizeof(text), "%.3f", angle);
+            angle = std::stof(text);
+        }
+        if (!compare(trajectory, read_csv(options.golden), options.tolerance)) return 1;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* arg = argv[i];
+        const char* v = nullptr;
+        if (strcmp(arg, "-v") == 0) {
+            host_log_level = ESP_LOG_INFO;
+            continue;
+        } else if (arg[0] != '-') {
+            options.script = arg;
+            continue;
+        }
+        if ((v = value()) == nullptr) {
+            options.script = nullptr;
+            break;
+        }
+        if (strcmp(arg, "--csv") == 0) options.csv = v;
+        else if (strcmp(arg, "--golden") == 0) options.golden = v;
+        else if (strcmp(arg, "--tolerance") == 0) options.tolerance = atof(v);
+        else if (strcmp(arg, "--trace") == 0) options.trace = v;
+        else if (strcmp(arg, "--pack") == 0) options.pack = v;
+        else if (strcmp(arg, "--repeat") == 0) options.repeat = std::max(1, atoi(v));
+        else {
+            options.script = nullptr;
+            break;
+        }
+    }
+    if (options.script == nullptr) {
+        fprintf(stderr, "usage: motionsim [--csv out.csv] [--golden ref.csv] [--tolerance deg] [--trace out.bin] "
+                        "[--pack pack.bin] [--repeat n] [-v] <script>\n");
+        return 2;
+    }
+    try {
+        return run(options);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "motionsim: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,467 @@
+// mpack - builds and checks binary motion packs (see main/motion_manager/MotionPack.hpp)
+//
+// Build on the host from this directory:
+//   g++ -std=c++20 -O2 -I../../main -I../../main/motion_manager -o mpack mpack.cpp
+//       ../../main/motion_manager/MotionPack.cpp ../../main/motion_manager/DefaultActions.cpp
+//
+// Usage:
+//   mpack build <library.json> <out.pak>   compile a JSON action library into a pack
+//   mpack check <in.pak>                   validate a pack with the firmware's own checks
+//   mpack export-builtins <out.json>       write the built-in library as JSON, a starting point
+//
+// Flash a pack into the "motions" partition with
+//   parttool.py write_partition --partition-name motions --input out.pak
+// or copy it to the SD card as /sdcard/motions.pak.
+//
+// Library format:
+//   {
+//     "actions": [
+//       {"name": "wave", "type": "gait", "atomic": false, "steps": 1, "period_ms": 1000,
+//        "easing": "linear",
+//        "harmonics": [{"amplitude": [...], "offset": [...], "phase_diff": [...]}, ...]},
+//       {"name": "bow", "type": "keyframe", "atomic": true, "steps": 1, "interpolation": "cosine",
+//        "frames": [{"ms": 500, "pos": [...]}, ...]}
+//     ],
+//     "groups": [
+//       {"name": "greet", "mode": "simultaneous", "actions": ["wave", "bow"]}
+//     ]
+//   }
+// Joint arrays have GAIT_JOINT_COUNT entries in ServoChannel order. harmonics[k-1]
+// is harmonic k; only the first term's offset is used, so later terms may omit it.
+// easing is one of linear, ease_in_quad, ease_out_quad, ease_in_out_quad.
+// interpolation is cosine (default, stops at every frame) or catmull_rom.
+
+#include "motion_manager/MotionPack.hpp"
+#include "motion_manager/DefaultActions.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// --- Minimal JSON reader (objects, arrays, strings, numbers, booleans) ---
+
+struct Json {
+    enum Kind { NUL, BOOL, NUMBER, STRING, ARRAY, OBJECT } kind = NUL;
+    bool boolean = false;
+    double number = 0;
+    std::string string;
+    std::vector<Json> items;
+    std::map<std::string, Json> fields;
+
+    const Json& at(const std::string& key) const {
+        auto it = fields.find(key);
+        if (kind != OBJECT || it == fields.end()) throw std::runtime_error("missing field '" + key + "'");
+        return it->second;
+    }
+    bool has(const std::string& key) const { return kind == OBJECT && fields.count(key) != 0; }
+};
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : m_text(text) {}
+
+    Json parse() {
+        Json value = parse_value();
+        skip_space();
+        if (m_pos != m_text.size()) fail("trailing characters");
+        return value;
+    }
+
+private:
+    [[noreturn]] void fail(const char* what) {
+        throw std::runtime_error(std::string("JSON: ") + what + " at offset " + std::to_string(m_pos));
+    }
+
+    void skip_space() {
+        while (m_pos < m_text.size() && isspace(static_cast<unsigned char>(m_text[m_pos]))) ++m_pos;
+    }
+
+    bool consume(char c) {
+        skip_space();
+        if (m_pos < m_text.size() && m_text[m_pos] == c) {
+            ++m_pos;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) fail("unexpected character");
+    }
+
+    Json parse_value() {
+        skip_space();
+        if (m_pos >= m_text.size()) fail("unexpected end");
+        Json value;
+        char c = m_text[m_pos];
+        if (c == '{') {
+            ++m_pos;
+            value.kind = Json::OBJECT;
+            if (consume('}')) return value;
+            do {
+                skip_space();
+                std::string key = parse_string();
+                expect(':');
+                value.fields[key] = parse_value();
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            ++m_pos;
+            value.kind = Json::ARRAY;
+            if (consume(']')) return value;
+            do {
+                value.items.push_back(parse_value());
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            value.kind = Json::STRING;
+            value.string = parse_string();
+        } else if (m_text.compare(m_pos, 4, "true") == 0) {
+            m_pos += 4;
+            value.kind = Json::BOOL;
+            value.boolean = true;
+        } else if (m_text.compare(m_pos, 5, "false") == 0) {
+            m_pos += 5;
+            value.kind = Json::BOOL;
+        } else if (m_text.compare(m_pos, 4, "null") == 0) {
+            m_pos += 4;
+        } else {
+            const char* start = m_text.c_str() + m_pos;
+            char* end = nullptr;
+            value.kind = Json::NUMBER;
+            value.number = strtod(start, &end);
+            if (end == start) fail("bad value");
+            m_pos += static_cast<size_t>(end - start);
+        }
+        return value;
+    }
+
+    std::string parse_string() {
+        if (m_pos >= m_text.size() || m_text[m_pos] != '"') fail("expected string");
+        ++m_pos;
+        std::string out;
+        while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+            char c = m_text[m_pos++];
+            if (c == '\\') {
+                if (m_pos >= m_text.size()) fail("bad escape");
+                c = m_text[m_pos++];
+                if (c == 'n') c = '\n';
+                else if (c == 't') c = '\t';
+                else if (c != '"' && c != '\\' && c != '/') fail("unsupported escape");
+            }
+            out += c;
+        }
+        if (m_pos >= m_text.size()) fail("unterminated string");
+        ++m_pos;
+        return out;
+    }
+
+    const std::string& m_text;
+    size_t m_pos = 0;
+};
+
+// --- Library -> records ---
+
+void set_name(char (&dst)[MOTION_NAME_MAX_LEN], const std::string& name) {
+    if (name.empty() || name.size() >= MOTION_NAME_MAX_LEN) {
+        throw std::runtime_error("name '" + name + "' must be 1.." + std::to_string(MOTION_NAME_MAX_LEN - 1) + " characters");
+    }
+    memcpy(dst, name.c_str(), name.size() + 1);
+}
+
+const char* const EASING_NAMES[] = {"linear", "ease_in_quad", "ease_out_quad", "ease_in_out_quad"};
+
+EasingType read_easing(const std::string& name) {
+    for (size_t i = 0; i < sizeof(EASING_NAMES) / sizeof(EASING_NAMES[0]); ++i) {
+        if (name == EASING_NAMES[i]) return static_cast<EasingType>(i);
+    }
+    throw std::runtime_error("unknown easing '" + name + "'");
+}
+
+const char* const INTERPOLATION_NAMES[] = {"cosine", "catmull_rom"};
+
+KeyframeInterpolation read_interpolation(const std::string& name) {
+    for (size_t i = 0; i < sizeof(INTERPOLATION_NAMES) / sizeof(INTERPOLATION_NAMES[0]); ++i) {
+        if (name == INTERPOLATION_NAMES[i]) return static_cast<KeyframeInterpolation>(i);
+    }
+    throw std::runtime_error("unknown interpolation '" + name + "'");
+}
+
+void read_joints(const Json& array, float (&dst)[GAIT_JOINT_COUNT], const char* what) {
+    if (array.kind != Json::ARRAY || array.items.size() != GAIT_JOINT_COUNT) {
+        throw std::runtime_error(std::string(what) + " needs " + std::to_string(GAIT_JOINT_COUNT) + " values");
+    }
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        dst[i] = static_cast<float>(array.items[i].number);
+    }
+}
+
+RegisteredAction read_action(const Json& json) {
+    RegisteredAction action;
+    memset(&action, 0, sizeof(action));
+    set_name(action.name, json.at("name").string);
+    action.is_atomic = json.has("atomic") && json.at("atomic").boolean;
+    action.default_steps = json.has("steps") ? static_cast<uint32_t>(json.at("steps").number) : 1;
+
+    const std::string& type = json.at("type").string;
+    if (type == "gait") {
+        action.type = ActionType::GAIT_PERIODIC;
+        action.data.gait.gait_period_ms = static_cast<uint32_t>(json.at("period_ms").number);
+        action.data.gait.easing_type = json.has("easing") ? read_easing(json.at("easing").string) : EasingType::LINEAR;
+        const Json& harmonics = json.at("harmonics");
+        if (harmonics.items.empty() || harmonics.items.size() > MAX_GAIT_HARMONICS) {
+            throw std::runtime_error("gait needs 1.." + std::to_string(MAX_GAIT_HARMONICS) + " harmonics");
+        }
+        action.data.gait.harmonic_count = static_cast<uint8_t>(harmonics.items.size());
+        for (size_t h = 0; h < harmonics.items.size(); ++h) {
+            const Json& term_json = harmonics.items[h];
+            motion_params_t& term = action.data.gait.harmonic_terms[h];
+            read_joints(term_json.at("amplitude"), term.amplitude, "amplitude");
+            read_joints(term_json.at("phase_diff"), term.phase_diff, "phase_diff");
+            if (term_json.has("offset")) read_joints(term_json.at("offset"), term.offset, "offset");
+        }
+    } else if (type == "keyframe") {
+        action.type = ActionType::KEYFRAME_SEQUENCE;
+        const Json& frames = json.at("frames");
+        if (frames.items.size() > MAX_KEYFRAMES_PER_ACTION) throw std::runtime_error("too many keyframes");
+        action.data.keyframe.frame_count = static_cast<uint8_t>(frames.items.size());
+        action.data.keyframe.interpolation = json.has("interpolation") ? read_interpolation(json.at("interpolation").string)
+                                                                       : KeyframeInterpolation::COSINE;
+        for (size_t i = 0; i < frames.items.size(); ++i) {
+            Keyframe& frame = action.data.keyframe.frames[i];
+            frame.transition_time_ms = static_cast<uint16_t>(frames.items[i].at("ms").number);
+            read_joints(frames.items[i].at("pos"), frame.positions, "pos");
+        }
+    } else {
+        throw std::runtime_error("unknown action type '" + type + "'");
+    }
+    return action;
+}
+
+RegisteredGroup read_group(const Json& json) {
+    RegisteredGroup group;
+    memset(&group, 0, sizeof(group));
+    set_name(group.name, json.at("name").string);
+    const std::string& mode = json.at("mode").string;
+    if (mode == "sequential") group.mode = ExecutionMode::SEQUENTIAL;
+    else if (mode == "simultaneous") group.mode = ExecutionMode::SIMULTANEOUS;
+    else throw std::runtime_error("unknown group mode '" + mode + "'");
+    const Json& members = json.at("actions");
+    if (members.items.size() > MAX_ACTIONS_PER_GROUP) throw std::runtime_error("too many group members");
+    group.action_count = static_cast<uint8_t>(members.items.size());
+    for (size_t i = 0; i < members.items.size(); ++i) {
+        set_name(group.action_names[i], members.items[i].string);
+    }
+    return group;
+}
+
+// --- Pack writer ---
+
+struct PendingRecord {
+    std::string name;
+    MotionPack::EntryKind kind;
+    std::vector<uint8_t> bytes;
+};
+
+size_t align_up(size_t value) {
+    return (value + MotionPack::RECORD_ALIGN - 1) & ~(MotionPack::RECORD_ALIGN - 1);
+}
+
+std::vector<uint8_t> write_pack(std::vector<PendingRecord> records) {
+    std::sort(records.begin(), records.end(),
+              [](const PendingRecord& a, const PendingRecord& b) { return a.name < b.name; });
+    for (size_t i = 1; i < records.size(); ++i) {
+        if (records[i - 1].name == records[i].name) throw std::runtime_error("duplicate name '" + records[i].name + "'");
+    }
+
+    MotionPack::Header header = {};
+    header.magic = MotionPack::MAGIC;
+    header.version = MotionPack::VERSION;
+    header.header_size = sizeof(MotionPack::Header);
+    header.entry_count = static_cast<uint16_t>(records.size());
+    header.joint_count = GAIT_JOINT_COUNT;
+    header.name_len = MOTION_NAME_MAX_LEN;
+    header.max_keyframes = MAX_KEYFRAMES_PER_ACTION;
+    header.max_harmonics = MAX_GAIT_HARMONICS;
+    header.index_offset = static_cast<uint32_t>(align_up(sizeof(MotionPack::Header)));
+
+    std::vector<MotionPack::Entry> entries(records.size());
+    size_t offset = header.index_offset + records.size() * sizeof(MotionPack::Entry);
+    for (size_t i = 0; i < records.size(); ++i) {
+        offset = align_up(offset);
+        memset(&entries[i], 0, sizeof(MotionPack::Entry));
+        memcpy(entries[i].name, records[i].name.c_str(), records[i].name.size() + 1);
+        entries[i].offset = static_cast<uint32_t>(offset);
+        entries[i].size = static_cast<uint32_t>(records[i].bytes.size());
+        entries[i].kind = records[i].kind;
+        offset += records[i].bytes.size();
+    }
+    header.total_size = static_cast<uint32_t>(align_up(offset) + MotionPack::TAIL_GUARD_SIZE);
+
+    std::vector<uint8_t> pack(header.total_size, 0);
+    memcpy(pack.data() + header.index_offset, entries.data(), entries.size() * sizeof(MotionPack::Entry));
+    for (size_t i = 0; i < records.size(); ++i) {
+        memcpy(pack.data() + entries[i].offset, records[i].bytes.data(), records[i].bytes.size());
+    }
+    header.crc32 = MotionPack::crc32(pack.data() + header.header_size, header.total_size - header.header_size);
+    memcpy(pack.data(), &header, sizeof(header));
+    return pack;
+}
+
+// --- Library export ---
+
+void write_joints(std::ostream& out, const float (&values)[GAIT_JOINT_COUNT]) {
+    char buf[32];
+    out << "[";
+    for (int i = 0; i < GAIT_JOINT_COUNT; ++i) {
+        snprintf(buf, sizeof(buf), "%.9g", values[i]);
+        out << (i ? ", " : "") << buf;
+    }
+    out << "]";
+}
+
+void write_action(std::ostream& out, const RegisteredAction& action) {
+    out << "    {\"name\": \"" << action.name << "\", \"atomic\": " << (action.is_atomic ? "true" : "false")
+        << ", \"steps\": " << action.default_steps;
+    if (action.type == ActionType::GAIT_PERIODIC) {
+        const GaitActionData& gait = action.data.gait;
+        out << ", \"type\": \"gait\", \"period_ms\": " << gait.gait_period_ms
+            << ", \"easing\": \"" << EASING_NAMES[static_cast<int>(gait.easing_type)] << "\", \"harmonics\": [";
+        for (uint8_t h = 0; h < gait.harmonic_count; ++h) {
+            out << (h ? "," : "") << "\n      {\"amplitude\": ";
+            write_joints(out, gait.harmonic_terms[h].amplitude);
+            out << ",\n       \"offset\": ";
+            write_joints(out, gait.harmonic_terms[h].offset);
+            out << ",\n       \"phase_diff\": ";
+            write_joints(out, gait.harmonic_terms[h].phase_diff);
+            out << "}";
+        }
+        out << "]}";
+    } else {
+        out << ", \"type\": \"keyframe\", \"interpolation\": \""
+            << INTERPOLATION_NAMES[static_cast<int>(action.data.keyframe.interpolation)] << "\", \"frames\": [";
+        for (uint8_t i = 0; i < action.data.keyframe.frame_count; ++i) {
+            const Keyframe& frame = action.data.keyframe.frames[i];
+            out << (i ? "," : "") << "\n      {\"ms\": " << frame.transition_time_ms << ", \"pos\": ";
+            write_joints(out, frame.positions);
+            out << "}";
+        }
+        out << "]}";
+    }
+}
+
+std::string read_file(const char* path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error(std::string("cannot open ") + path);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+void write_file(const char* path, const void* data, size_t size) {
+    std::ofstream out(path, std::ios::binary);
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    if (!out) throw std::runtime_error(std::string("cannot write ") + path);
+}
+
+int cmd_build(const char* in_path, const char* out_path) {
+    Json library = JsonParser(read_file(in_path)).parse();
+    std::vector<PendingRecord> records;
+    if (library.has("actions")) {
+        for (const Json& json : library.at("actions").items) {
+            RegisteredAction action = read_action(json);
+            size_t size = MotionPack::action_record_size(action);
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&action);
+            records.push_back({action.name, MotionPack::EntryKind::ACTION, std::vector<uint8_t>(bytes, bytes + size)});
+        }
+    }
+    if (library.has("groups")) {
+        for (const Json& json : library.at("groups").items) {
+            RegisteredGroup group = read_group(json);
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&group);
+            records.push_back({group.name, MotionPack::EntryKind::GROUP, std::vector<uint8_t>(bytes, bytes + sizeof(group))});
+        }
+    }
+
+    std::vector<uint8_t> pack = write_pack(std::move(records));
+    MotionPack::View view;
+    const char* error = nullptr;
+    if (!view.open(pack.data(), pack.size(), &error)) {
+        throw std::runtime_error(std::string("built pack does not validate: ") + error);
+    }
+    write_file(out_path, pack.data(), pack.size());
+    printf("%s: %u entries, %zu bytes\n", out_path, view.entry_count(), pack.size());
+    return 0;
+}
+
+int cmd_check(const char* path) {
+    std::string data = read_file(path);
+    // std::string storage is not guaranteed 4-byte aligned; the firmware's mmap is.
+    std::unique_ptr<uint32_t[]> aligned(new uint32_t[(data.size() + 3) / 4]);
+    memcpy(aligned.get(), data.data(), data.size());
+
+    MotionPack::View view;
+    const char* error = nullptr;
+    if (!view.open(aligned.get(), data.size(), &error)) {
+        fprintf(stderr, "%s: invalid pack: %s\n", path, error);
+        return 1;
+    }
+    for (uint16_t i = 0; i < view.entry_count(); ++i) {
+        const MotionPack::Entry& entry = view.entry(i);
+        printf("%3u  %-16.16s %-6s %5u bytes\n", i, entry.name,
+               entry.kind == MotionPack::EntryKind::ACTION ? "action" : "group", entry.size);
+    }
+    printf("%s: OK, %u entries, %u bytes\n", path, view.entry_count(), view.total_size());
+    return 0;
+}
+
+int cmd_export_builtins(const char* out_path) {
+    std::ostringstream out;
+    out << "{\n  \"actions\": [\n";
+    bool first = true;
+    for (const RegisteredAction& action : DefaultActions::actions()) {
+        out << (first ? "" : ",\n");
+        write_action(out, action);
+        first = false;
+    }
+    out << "\n  ],\n  \"groups\": [";
+    first = true;
+    for (const RegisteredGroup& group : DefaultActions::groups()) {
+        out << (first ? "" : ",") << "\n    {\"name\": \"" << group.name << "\", \"mode\": \""
+            << (group.mode == ExecutionMode::SEQUENTIAL ? "sequential" : "simultaneous") << "\", \"actions\": [";
+        for (uint8_t i = 0; i < group.action_count; ++i) {
+            out << (i ? ", " : "") << "\"" << group.action_names[i] << "\"";
+        }
+        out << "]}";
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+    std::string text = out.str();
+    write_file(out_path, text.data(), text.size());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        if (argc == 4 && strcmp(argv[1], "build") == 0) return cmd_build(argv[2], argv[3]);
+        if (argc == 3 && strcmp(argv[1], "check") == 0) return cmd_check(argv[2]);
+        if (argc == 3 && strcmp(argv[1], "export-builtins") == 0) return cmd_export_builtins(argv[2]);
+    } catch (const std::exception& e) {
+        fprintf(stderr, "mpack: %s\n", e.what());
+        return 1;
+    }
+    fprintf(stderr, "usage: mpack build <library.json> <out.pak> | check <in.pak> | export-builtins <out.json>\n");
+    return 2;
+}
@@ -0,0 +1,335 @@
+// mtrace - decodes binary motion traces (see main/motion_manager/MotionTrace.hpp)
+//
+// Build on the host from this directory:
+//   g++ -std=c++20 -O2 -I../../main -I../../main/motion_manager -o mtrace mtrace.cpp
+//
+// Usage:
+//   mtrace csv <trace.bin> <out.csv>   one row per mixer tick
+//   mtrace stats <trace.bin>           timing, per-joint motion and action summary
+//   mtrace chain <trace.bin> <action>...
+//                                      checks every run of the actions, chained in
+//                                      that order, for dead frames; exits 1 on one
+//
+// Get a trace from the robot with
+//   curl -o trace.bin http://<robot>/api/trace
+// or save it to the SD card as /sdcard/motion_trace.bin with /api/trace?save=1.
+
+#include "motion_manager/MotionTrace.hpp"
+#include "../HostCheck.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* const JOINT_NAMES[] = {
+    "left_ear_lift", "left_ear_swing", "right_ear_lift", "right_ear_swing", "head_tilt", "head_pan",
+    "right_arm_swing", "left_arm_lift", "left_arm_swing", "right_arm_lift", "left_leg_rotate",
+    "left_ankle_lift", "right_leg_rotate", "right_ankle_lift"};
+static_assert(sizeof(JOINT_NAMES) / sizeof(JOINT_NAMES[0]) == GAIT_JOINT_COUNT, "Joint names out of date");
+
+struct Trace {
+    MotionTrace::Header header = {};
+    std::vector<std::string> names;           // By ActionId
+    std::vector<MotionTrace::Record> records; // Oldest first
+    std::vector<int64_t> time_us;             // Unwrapped record times
+};
+
+Trace read_trace(const char* path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error(std::string("cannot open ") + path);
+    std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    Trace trace;
+    if (data.size() < sizeof(trace.header)) throw std::runtime_error("file too small");
+    memcpy(&trace.header, data.data(), sizeof(trace.header));
+    const MotionTrace::Header& h = trace.header;
+    if (h.magic != MotionTrace::MAGIC) throw std::runtime_error("not a motion trace");
+    if (h.version != MotionTrace::VERSION) throw std::runtime_error("unsupported trace version " + std::to_string(h.version));
+    if (h.header_size != sizeof(MotionTrace::Header) || h.record_size != sizeof(MotionTrace::Record) ||
+        h.joint_count != GAIT_JOINT_COUNT || h.max_actions != MAX_ACTIVE_ACTIONS || h.name_len != MOTION_NAME_MAX_LEN) {
+        throw std::runtime_error("trace layout does not match this build of mtrace");
+    }
+
+    size_t names_size = static_cast<size_t>(h.name_count) * h.name_len;
+    size_t expected = h.header_size + names_size + static_cast<size_t>(h.record_count) * h.record_size;
+    if (data.size() < expected) {
+        fprintf(stderr, "mtrace: trace is truncated, reading the complete records only\n");
+    }
+    if (data.size() < h.header_size + names_size) throw std::runtime_error("name table truncated");
+
+    const char* names = data.data() + h.header_size;
+    for (uint16_t i = 0; i < h.name_count; ++i) {
+        trace.names.emplace_back(names + static_cast<size_t>(i) * h.name_len, strnlen(names + static_cast<size_t>(i) * h.name_len, h.name_len));
+    }
+    size_t available = (data.size() - h.header_size - names_size) / h.record_size;
+    trace.records.resize(std::min<size_t>(available, h.record_count));
+    memcpy(trace.records.data(), names + names_size, trace.records.size() * sizeof(MotionTrace::Record));
+
+    // Record times are the low 32 bits of the microsecond clock.
+    int64_t high = 0;
+    for (size_t i = 0; i < trace.records.size(); ++i) {
+        if (i > 0 && trace.records[i].time_us < trace.records[i - 1].time_us) high += int64_t(1) << 32;
+        trace.time_us.push_back(high + trace.records[i].time_us);
+    }
+    return trace;
+}
+
+std::string action_name(const Trace& trace, ActionId id) {
+    return id < trace.names.size() ? trace.names[id] : "#" + std::to_string(id);
+}
+
+void write_angle(FILE* out, int16_t value) {
+    if (value == MotionTrace::NOT_DRIVEN) {
+        fputs(",", out);
+    } else {
+        fprintf(out, ",%.2f", MotionTrace::decode_angle(value));
+    }
+}
+
+int cmd_csv(const char* in_path, const char* out_path) {
+    Trace trace = read_trace(in_path);
+    FILE* out = fopen(out_path, "w");
+    if (out == nullptr) throw std::runtime_error(std::string("cannot write ") + out_path);
+
+    fputs("sequence,time_ms,wait_us,compute_us,jitter_us,manual,idle,actions", out);
+    for (const char* joint : JOINT_NAMES) fprintf(out, ",cmd_%s", joint);
+    for (const char* joint : JOINT_NAMES) fprintf(out, ",out_%s", joint);
+    fputs("\n", out);
+
+    const int64_t t0 = trace.time_us.empty() ? 0 : trace.time_us.front();
+    for (size_t i = 0; i < trace.records.size(); ++i) {
+        const MotionTrace::Record& r = trace.records[i];
+        fprintf(out, "%u,%.3f,%u,%u,%u,%d,%d,", (unsigned)r.sequence, (trace.time_us[i] - t0) / 1000.0, (unsigned)r.wait_us,
+                (unsigned)r.compute_us, (unsigned)r.jitter_us, (r.flags & MotionTrace::RECORD_FLAG_MANUAL) ? 1 : 0,
+                (r.flags & MotionTrace::RECORD_FLAG_IDLE) ? 1 : 0);
+        for (uint8_t a = 0; a < r.action_count && a < MAX_ACTIVE_ACTIONS; ++a) {
+            fprintf(out, "%s%s", a ? "|" : "", action_name(trace, r.action_ids[a]).c_str());
+        }
+        for (int j = 0; j < GAIT_JOINT_COUNT; ++j) write_angle(out, r.commanded[j]);
+        for (int j = 0; j < GAIT_JOINT_COUNT; ++j) write_angle(out, r.filtered[j]);
+        fputs("\n", out);
+    }
+    fclose(out);
+    printf("%s: %zu ticks written to %s\n", in_path, trace.records.size(), out_path);
+    return 0;
+}
+
+struct Distribution {
+    std::vector<uint32_t> values;
+
+    void print(const char* what) {
+        if (values.empty()) return;
+        std::sort(values.begin(), values.end());
+        double sum = 0;
+        for (uint32_t v : values) sum += v;
+        auto pct = [&](double p) { return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))]; };
+        printf("  %-12s mean %7.1f  p50 %6u  p99 %6u  max %6u us\n", what, sum / values.size(), (unsigned)pct(0.5),
+               (unsigned)pct(0.99), (unsigned)values.back());
+    }
+};
+
+int cmd_stats(const char* in_path) {
+    Trace trace = read_trace(in_path);
+    const auto& records = trace.records;
+    printf("%s: %zu ticks", in_path, records.size());
+    if (records.empty()) {
+        printf("\n");
+        return 0;
+    }
+    double span_s = (trace.time_us.back() - trace.time_us.front()) / 1e6;
+    uint32_t missed = 0;
+    uint32_t manual = 0;
+    uint32_t idle = 0;
+    for (size_t i = 0; i < records.size(); ++i) {
+        if (i > 0) missed += records[i].sequence - records[i - 1].sequence - 1;
+        if (records[i].flags & MotionTrace::RECORD_FLAG_MANUAL) ++manual;
+        if (records[i].flags & MotionTrace::RECORD_FLAG_IDLE) ++idle;
+    }
+    printf(" over %.2f s, mixer period %u us\n", span_s, (unsigned)trace.header.period_us);
+    printf("  %u ticks not recorded, %u under manual control, %u idle\n", (unsigned)missed, (unsigned)manual, (unsigned)idle);
+
+    Distribution compute, jitter, wait;
+    for (const auto& r : records) {
+        compute.values.push_back(r.compute_us);
+        jitter.values.push_back(r.jitter_us);
+        wait.values.push_back(r.wait_us);
+    }
+    printf("timing:\n");
+    compute.print("compute");
+    jitter.print("jitter");
+    wait.print("edit wait");
+
+    // Per joint: range, the largest change between consecutive recorded
+    // ticks (a stumble usually shows up here first) and the largest lag of
+    // the filtered output behind the mixer's command.
+    printf("joints:%25s %17s %22s %12s\n", "range (deg)", "max step (deg)", "at (ms)", "max lag");
+    const int64_t t0 = trace.time_us.front();
+    for (int j = 0; j < GAIT_JOINT_COUNT; ++j) {
+        float lo = INFINITY, hi = -INFINITY, max_step = 0, max_lag = 0;
+        int64_t step_at = 0;
+        for (size_t i = 0; i < records.size(); ++i) {
+            float out = MotionTrace::decode_angle(records[i].filtered[j]);
+            float cmd = MotionTrace::decode_angle(records[i].commanded[j]);
+            if (std::isnan(out)) continue;
+            lo = std::min(lo, out);
+            hi = std::max(hi, out);
+            if (!std::isnan(cmd)) max_lag = std::max(max_lag, std::fabs(cmd - out));
+            if (i > 0 && records[i].sequence == records[i - 1].sequence + 1) {
+                float prev = MotionTrace::decode_angle(records[i - 1].filtered[j]);
+                if (!std::isnan(prev) && std::fabs(out - prev) > max_step) {
+                    max_step = std::fabs(out - prev);
+                    step_at = trace.time_us[i] - t0;
+                }
+            }
+        }
+        if (lo > hi) {
+            printf("  %-18s never driven\n", JOINT_NAMES[j]);
+        } else {
+            printf("  %-18s %7.2f .. %7.2f %12.2f %16.1f %12.2f\n", JOINT_NAMES[j], lo, hi, max_step, step_at / 1000.0, max_lag);
+        }
+    }
+
+    std::map<std::string, uint32_t> action_ticks;
+    for (const auto& r : records) {
+        for (uint8_t a = 0; a < r.action_count && a < MAX_ACTIVE_ACTIONS; ++a) {
+            ++action_ticks[action_name(trace, r.action_ids[a])];
+        }
+    }
+    printf("actions (ticks active):\n");
+    for (const auto& pair : action_ticks) {
+        printf("  %-18s %8u\n", pair.first.c_str(), (unsigned)pair.second);
+    }
+
+    // A hand-off is a tick on which an action took over from one that ended
+    // on the tick before, as sequential group members do. An idle gap is a
+    // run of idle ticks between two busy ones: with one command per gap it
+    // is the command round trip, inside a sequence it is a dead frame.
+    uint32_t handoffs = 0, gaps = 0, gap_ticks = 0, longest_gap = 0;
+    size_t last_busy = records.size();
+    auto has_action = [](const MotionTrace::Record& r, ActionId id) {
+        for (uint8_t a = 0; a < r.action_count && a < MAX_ACTIVE_ACTIONS; ++a) {
+            if (r.action_ids[a] == id) return true;
+        }
+        return false;
+    };
+    for (size_t i = 0; i < records.size(); ++i) {
+        const MotionTrace::Record& r = records[i];
+        if (r.flags & MotionTrace::RECORD_FLAG_IDLE) continue;
+        if (last_busy < records.size() && last_busy + 1 < i) {
+            ++gaps;
+            gap_ticks += static_cast<uint32_t>(i - last_busy - 1);
+            longest_gap = std::max(longest_gap, static_cast<uint32_t>(i - last_busy - 1));
+        }
+        if (last_busy + 1 == i) {
+            const MotionTrace::Record& prev = records[i - 1];
+            bool started = false, ended = false;
+            for (uint8_t a = 0; a < r.action_count && a < MAX_ACTIVE_ACTIONS; ++a) {
+                started |= !has_action(prev, r.action_ids[a]);
+            }
+            for (uint8_t a = 0; a < prev.action_count && a < MAX_ACTIVE_ACTIONS; ++a) {
+                ended |= !has_action(r, prev.action_ids[a]);
+            }
+            if (started && ended) ++handoffs;
+        }
+        last_busy = i;
+    }
+    printf("  %u hand-offs, %u idle gaps between actions (%u ticks, longest %u)\n", (unsigned)handoffs,
+           (unsigned)gaps, (unsigned)gap_ticks, (unsigned)longest_gap);
+    return 0;
+}
+
+// A chain is a sequential group's members in order; a run of it starts
+// with the first member and ends after the last. Inside a run every tick
+// must be busy, command at least one joint and run the current member or
+// the next one: any other tick is a dead frame at a hand-off. The last
+// member may hand straight on to a new run, as a queued group does.
+int cmd_chain(const char* in_path, const std::vector<std::string>& members) {
+    Trace trace = read_trace(in_path);
+    const auto& records = trace.records;
+    std::vector<ActionId> ids;
+    for (const std::string& member : members) {
+        auto it = std::find(trace.names.begin(), trace.names.end(), member);
+        if (it == trace.names.end()) throw std::runtime_error("no action '" + member + "' in the trace");
+        ids.push_back(static_cast<ActionId>(it - trace.names.begin()));
+    }
+    auto runs_member = [&](const MotionTrace::Record& r, size_t member) {
+        for (uint8_t a = 0; a < r.action_count && a < MAX_ACTIVE_ACTIONS; ++a) {
+            if (r.action_ids[a] == ids[member]) return true;
+        }
+        return false;
+    };
+
+    const int64_t t0 = records.empty() ? 0 : trace.time_us.front();
+    uint32_t runs = 0, run_ticks = 0, dead = 0;
+    int current = -1;        // Member running in the current run, -1 outside one
+    bool was_dead = false;   // Only the first dead frame of a gap is printed
+    for (size_t i = 0; i < records.size(); ++i) {
+        const MotionTrace::Record& r = records[i];
+        const bool dead_before = was_dead;
+        was_dead = false;
+        if (current < 0) {
+            if (runs_member(r, 0)) current = 0;
+            if (current < 0) continue;
+        } else {
+            const size_t next = (static_cast<size_t>(current) + 1) % ids.size();
+            if (runs_member(r, next)) {
+                if (next == 0) ++runs;
+                current = static_cast<int>(next);
+            } else if (!runs_member(r, static_cast<size_t>(current))) {
+                if (static_cast<size_t>(current) + 1 == ids.size()) {
+                    ++runs;
+                    current = -1;
+                    continue;
+                }
+                ++dead;
+                was_dead = true;
+                if (!dead_before) {
+                    printf("  dead frames from %.1f ms, after %s\n", (trace.time_us[i] - t0) / 1000.0,
+                           members[current].c_str());
+                }
+                continue;
+            }
+        }
+        ++run_ticks;
+        bool driven = false;
+        for (int j = 0; j < GAIT_JOINT_COUNT; ++j) driven |= r.commanded[j] != MotionTrace::NOT_DRIVEN;
+        if ((r.flags & MotionTrace::RECORD_FLAG_IDLE) || !driven) {
+            ++dead;
+            was_dead = true;
+            if (!dead_before) {
+                printf("  idle or undriven ticks from %.1f ms, in %s\n", (trace.time_us[i] - t0) / 1000.0, members[current].c_str());
+            }
+        }
+    }
+    printf("%s: %u complete runs of the chain over %u ticks, %u dead frames\n", in_path, (unsigned)runs,
+           (unsigned)run_ticks, (unsigned)dead);
+    HostCheck::check(runs > 0, "the trace holds a complete run of the chain");
+    HostCheck::check(dead == 0, "no idle or undriven tick inside a run");
+    return HostCheck::finish();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    try {
+        if (argc == 4 && strcmp(argv[1], "csv") == 0) return cmd_csv(argv[2], argv[3]);
+        if (argc == 3 && strcmp(argv[1], "stats") == 0) return cmd_stats(argv[2]);
+        if (argc >= 4 && strcmp(argv[1], "chain") == 0) {
+            return cmd_chain(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+        }
+    } catch (const std::exception& e) {
+        fprintf(stderr, "mtrace: %s\n", e.what());
+        return 1;
+    }
+    fprintf(stderr, "usage: mtrace csv <trace.bin> <out.csv> | stats <trace.bin> | chain <trace.bin> <action>...\n");
+    return 2;
+}
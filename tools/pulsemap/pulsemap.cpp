@@ -0,0 +1,132 @@
+// pulsemap - host check and microbenchmark of the PCA9685 angle-to-count
+// path. Every channel's compiled PulseMap is compared with the float mapping
+// it replaced, at every 0.01 deg step inside the channel's limits, and both
+// are timed.
+//
+// Build on the host from this directory:
+//   g++ -std=c++20 -O2 -I../../main -I../../main/driver -o pulsemap pulsemap.cpp
+//
+// Usage:
+//   pulsemap [calls]   (default 20000000); exits 1 if a check fails
+
+#include "driver/PCA9685.hpp"
+#include "driver/PulseMap.hpp"
+#include "motion_manager/ServoCalibration.hpp"
+#include "../HostCheck.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+constexpr int SERVO_COUNT = static_cast<int>(ServoChannel::SERVO_COUNT);
+
+// The mapping PCA9685::set_angle() did before PulseMap: the channel 6/7
+// inversions, then a float percentage of the angle range truncated twice.
+uint16_t legacy_count(int channel, float angle) {
+    if (channel == 6) {
+        angle = 180 - angle;
+    } else if (channel == 7) {
+        angle = 130 - angle;
+    }
+    const float min_angle = ServoCalibration::limits[channel].min;
+    const float max_angle = ServoCalibration::limits[channel].max;
+    const uint16_t min_pulse_us = ServoCalibration::pulse_limits[channel].min_us;
+    const uint16_t max_pulse_us = ServoCalibration::pulse_limits[channel].max_us;
+
+    const float us_per_step = 1000000.0f / (PWM_FREQ_HZ * 4096.0f);
+    float range_angle = max_angle - min_angle;
+    if (range_angle == 0) {
+        range_angle = 180.0f;
+    }
+    float percentage = (angle - min_angle) / range_angle;
+    uint32_t pulse_us = min_pulse_us + (uint32_t)((max_pulse_us - min_pulse_us) * percentage);
+    return (uint16_t)(pulse_us / us_per_step);
+}
+
+// The angle the legacy mapping scaled, after its inversion
+float legacy_input(int channel, float angle) {
+    return channel == 6 ? 180 - angle : channel == 7 ? 130 - angle : angle;
+}
+
+PulseMap compile(int channel) {
+    const auto& limit = ServoCalibration::limits[channel];
+    const auto& pulse = ServoCalibration::pulse_limits[channel];
+    return PulseMap::compile(limit.min, limit.max, pulse.min_us, pulse.max_us, ServoCalibration::mirror_origin[channel],
+                             PWM_FREQ_HZ);
+}
+
+using HostCheck::check;
+
+// Within the range the legacy mapping was defined on, the two may differ
+// by one count, from its truncations and the map's 1/16 deg angle steps.
+// Outside it the legacy code extrapolated or wrapped, and the map clamps.
+void check_equivalence() {
+    long points = 0;
+    int worst = 0;
+    bool clamped = true;
+    for (int channel = 0; channel < SERVO_COUNT; ++channel) {
+        const PulseMap map = compile(channel);
+        const auto& limit = ServoCalibration::limits[channel];
+        const long steps = std::lround((limit.max - limit.min) * 100.0f);
+        for (long step = 0; step <= steps; ++step) {
+            const float angle = limit.min + step * 0.01f;
+            const uint16_t count = map.apply(angle);
+            const float input = legacy_input(channel, angle);
+            ++points;
+            if (input >= limit.min && input <= limit.max) {
+                worst = std::max(worst, std::abs(static_cast<int>(count) - legacy_count(channel, angle)));
+            } else {
+                clamped &= count == map.min_count || count == map.max_count;
+            }
+        }
+        // Far outside the limits, and at the int32 guard, the map still clamps
+        for (float angle : {-1000.0f, limit.min - 90.0f, limit.max + 90.0f, 1000.0f}) {
+            const uint16_t count = map.apply(angle);
+            clamped &= count >= map.min_count && count <= map.max_count;
+        }
+    }
+    printf("%ld points, largest difference %d count(s)\n", points, worst);
+    check(worst <= 1, "compiled maps match the float mapping to within one count");
+    check(clamped, "out-of-range angles clamp to the calibrated pulse range");
+}
+
+float g_sink; // Keeps the results alive
+
+template <typename Map>
+double bench(const char* name, long calls, Map map) {
+    uint32_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long n = 0; n < calls; ++n) {
+        const int channel = static_cast<int>(n % SERVO_COUNT);
+        sum += map(channel, 60.0f + static_cast<float>(n & 1023) * 0.05f);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    g_sink += static_cast<float>(sum);
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count() / calls;
+    printf("%-28s %6.2f ns/channel\n", name, ns);
+    return ns;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long calls = argc > 1 ? std::atol(argv[1]) : 20000000;
+    if (calls <= 0) {
+        fprintf(stderr, "usage: pulsemap [calls]\n");
+        return 2;
+    }
+
+    check_equivalence();
+
+    PulseMap maps[SERVO_COUNT];
+    for (int channel = 0; channel < SERVO_COUNT; ++channel) maps[channel] = compile(channel);
+    bench("float mapping (old)", calls, legacy_count);
+    bench("PulseMap", calls, [&maps](int channel, float angle) { return maps[channel].apply(angle); });
+
+    const int status = HostCheck::finish();
+    return g_sink == 12345.0f ? EXIT_FAILURE : status; // Never true; stops the sink being optimized out
+}
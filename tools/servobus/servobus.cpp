@@ -0,0 +1,162 @@
+// servobus - host check of the PCA9685 driver's bus traffic. Drives the
+// driver through MockI2CBus and checks what reaches the wire: a full servo
+// frame goes out as one auto-increment burst of the expected size and time,
+// unchanged channels are suppressed and counted, and each run of changed
+// channels is coalesced into one burst. A full frame must also leave a
+// 100 Hz mixer tick within its budget.
+//
+// Build on the host from this directory:
+//   g++ -std=gnu++2b -O2 -I../motionsim/idf -I../../main -I../../main/driver -o servobus
+//       servobus.cpp ../../main/driver/PCA9685.cpp ../motionsim/HostIdf.cpp ../motionsim/HostPlatform.cpp
+// (one command line)
+//
+// Usage:
+//   servobus      prints each check; exits 1 if any fails
+
+#include "driver/MockI2CBus.hpp"
+#include "driver/PCA9685.hpp"
+#include "motion_manager/MixerTiming.hpp"
+#include "motion_manager/ServoCalibration.hpp"
+#include "../HostCheck.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+constexpr int SERVO_COUNT = static_cast<int>(ServoChannel::SERVO_COUNT);
+
+using HostCheck::check;
+
+// Every servo at its calibrated home
+void home_pose(float (&angles)[SERVO_COUNT]) {
+    for (int i = 0; i < SERVO_COUNT; ++i) {
+        angles[i] = ServoCalibration::get_home_pos(static_cast<ServoChannel>(i));
+    }
+}
+
+void check_full_frame() {
+    MockI2CBus bus(PCA9685_I2C_CLK_HZ);
+    PCA9685 servo(bus);
+    servo.init();
+
+    float angles[SERVO_COUNT];
+    home_pose(angles);
+    servo.set_angles(angles);
+
+    const size_t payload = SERVO_COUNT * PCA9685Registers::BYTES_PER_CHANNEL;
+    check(bus.transaction_count() == 1, "a 14-channel frame is one transaction");
+    if (bus.transaction_count() != 1) return;
+    const MockI2CBus::Transaction& burst = bus.transactions()[0];
+    check(burst.reg == PCA9685Registers::LED0_ON_L, "the burst starts at LED0_ON_L");
+    check(burst.data.size() == payload, "the burst carries 4 bytes per channel");
+    check(bus.wire_bytes() == 2 + payload, "address and register bytes are sent once");
+    check(bus.bus_time_us() == servo.frame_time_us(SERVO_COUNT), "the driver's frame time matches the bus");
+
+    bool counts_ok = true;
+    for (int i = 0; i < SERVO_COUNT; ++i) {
+        const uint8_t* channel = &burst.data[i * PCA9685Registers::BYTES_PER_CHANNEL];
+        const uint16_t off = static_cast<uint16_t>(channel[2] | (channel[3] << 8));
+        counts_ok &= channel[0] == 0 && channel[1] == 0 && off > 0 && off <= PCA9685Registers::COUNT_MAX;
+    }
+    check(counts_ok, "every channel starts at 0 and ends at a valid count");
+
+    const ServoWriteStats stats = servo.get_write_stats();
+    check(stats.transactions == 1 && stats.channels_written == SERVO_COUNT && stats.channels_suppressed == 0,
+          "the write counters show one burst of 14 channels");
+
+    // MotionController::init() adds the frame to the MIXER stage budget
+    StageTimingRecorder stages;
+    const uint32_t tick_budget_us = stages.tick_budget_us() + servo.frame_time_us(SERVO_COUNT);
+    printf("      tick budget %u us, full frame %u us\n", static_cast<unsigned>(tick_budget_us),
+           static_cast<unsigned>(servo.frame_time_us(SERVO_COUNT)));
+    check(tick_budget_us <= mixer_period_us(MixerRate::HZ_100), "a full frame fits a 100 Hz mixer tick");
+}
+
+// Off-count of a channel's LEDn_OFF registers in a burst starting at first
+uint16_t burst_count(const MockI2CBus::Transaction& burst, uint8_t first, uint8_t channel) {
+    const size_t at = (channel - first) * PCA9685Registers::BYTES_PER_CHANNEL;
+    return static_cast<uint16_t>(burst.data[at + 2] | (burst.data[at + 3] << 8));
+}
+
+void check_dirty_runs() {
+    MockI2CBus bus(PCA9685_I2C_CLK_HZ);
+    PCA9685 servo(bus);
+    servo.init();
+
+    float angles[SERVO_COUNT];
+    home_pose(angles);
+    servo.set_angles(angles);
+    const ServoWriteStats first = servo.get_write_stats();
+
+    bus.reset();
+    servo.set_angles(angles);
+    ServoWriteStats stats = servo.get_write_stats();
+    check(bus.transaction_count() == 0, "an unchanged frame sends nothing");
+    check(stats.channels_suppressed - first.channels_suppressed == SERVO_COUNT,
+          "every unchanged channel is counted as suppressed");
+
+    // Two runs of changed channels, 2-4 and 9, split by unchanged ones
+    for (int channel : {2, 3, 4, 9}) angles[channel] += 10.0f;
+    bus.reset();
+    servo.set_angles(angles);
+    const ServoWriteStats before = stats;
+    stats = servo.get_write_stats();
+    check(bus.transaction_count() == 2, "two runs of changed channels are two bursts");
+    if (bus.transaction_count() == 2) {
+        const MockI2CBus::Transaction& run = bus.transactions()[0];
+        const MockI2CBus::Transaction& single = bus.transactions()[1];
+        check(run.reg == PCA9685Registers::led_on_l(2) && run.data.size() == 3 * PCA9685Registers::BYTES_PER_CHANNEL,
+              "channels 2-4 go out as one burst from LED2_ON_L");
+        check(single.reg == PCA9685Registers::led_on_l(9) && single.data.size() == PCA9685Registers::BYTES_PER_CHANNEL,
+              "channel 9 goes out alone from LED9_ON_L");
+        check(bus.wire_bytes() == 2 * 2 + 4 * PCA9685Registers::BYTES_PER_CHANNEL,
+              "the two bursts carry only the changed channels");
+    }
+    check(stats.transactions - before.transactions == 2 && stats.channels_written - before.channels_written == 4 &&
+          stats.channels_suppressed - before.channels_suppressed == SERVO_COUNT - 4,
+          "the counters show 4 channels written and 10 suppressed");
+
+    // NaN holds a channel: neither sent nor counted as suppressed
+    float held[SERVO_COUNT];
+    for (float& angle : held) angle = NAN;
+    held[7] = angles[7] + 5.0f;
+    bus.reset();
+    servo.set_angles(held);
+    const ServoWriteStats before_held = stats;
+    stats = servo.get_write_stats();
+    check(bus.transaction_count() == 1 && bus.transactions()[0].reg == PCA9685Registers::led_on_l(7),
+          "held channels split no run and are not sent");
+    check(stats.channels_suppressed == before_held.channels_suppressed, "held channels are not counted as suppressed");
+    angles[7] = held[7];
+
+    // A failed burst leaves the shadow as it was, so the next frame resends it
+    angles[0] += 10.0f;
+    bus.reset();
+    bus.fail_next_write();
+    servo.set_angles(angles);
+    check(bus.transaction_count() == 0, "a failed burst reaches no device");
+    servo.set_angles(angles);
+    check(bus.transaction_count() == 1 && bus.transactions()[0].reg == PCA9685Registers::led_on_l(0),
+          "the next frame retries the failed channel");
+
+    // set_angle() goes through the same shadow
+    const uint16_t sent = bus.transaction_count() == 1 ? burst_count(bus.transactions()[0], 0, 0) : 0;
+    bus.reset();
+    const ServoWriteStats before_single = servo.get_write_stats();
+    servo.set_angle(0, angles[0]);
+    stats = servo.get_write_stats();
+    check(bus.transaction_count() == 0 && stats.channels_suppressed == before_single.channels_suppressed + 1,
+          "set_angle() of the committed count is suppressed");
+    servo.set_angle(0, angles[0] + 10.0f);
+    check(bus.transaction_count() == 1 && burst_count(bus.transactions()[0], 0, 0) != sent,
+          "set_angle() of a new count is sent");
+}
+
+} // namespace
+
+int main() {
+    check_full_frame();
+    check_dirty_runs();
+    return HostCheck::finish();
+}